@@ -1,8 +1,41 @@
 set(headers ${headers}
+	src/Archive.h
+	src/ArchiveIndex.h
+	src/AudioCache.h
+	src/AudioCacheFile.h
+	src/B5G6R5.h
+	src/BC1.h
+	src/BakedVideo.h
+	src/Blend.h
+	src/Cache.h
+	src/CacheEntry.h
+	src/Clock.h
+	src/ConvertStage.h
+	src/DecodeWatchdog.h
+	src/FrameFormat.h
+	src/FrameHash.h
+	src/FrameTimeline.h
+	src/FrameUpload.h
+	src/History.h
 	src/Hooks.h
 	src/ImGui/Renderer.h
 	src/ImGui/Util.h
+	src/ImageSequence.h
+	src/KeyframeIndex.h
+	src/LoadOrder.h
 	src/Manager.h
+	src/Memory.h
 	src/PCH.h
+	src/Prefetcher.h
+	src/QOI.h
+	src/QualityController.h
+	src/R10G10B10A2.h
+	src/StripePool.h
+	src/Suspension.h
+	src/Telemetry.h
+	src/TelemetryBlock.h
+	src/VideoList.h
 	src/VideoPlayer.h
+	src/Visibility.h
+	src/WarmStart.h
 )
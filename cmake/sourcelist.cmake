@@ -1,9 +1,41 @@
 set(sources ${sources}
+	src/Archive.cpp
+	src/ArchiveIndex.cpp
+	src/AudioCache.cpp
+	src/AudioCacheFile.cpp
+	src/B5G6R5.cpp
+	src/BC1.cpp
+	src/BakedVideo.cpp
+	src/Blend.cpp
+	src/Cache.cpp
+	src/CacheEntry.cpp
+	src/ConvertStage.cpp
+	src/DecodeWatchdog.cpp
+	src/FrameFormat.cpp
+	src/FrameHash.cpp
+	src/FrameTimeline.cpp
+	src/FrameUpload.cpp
+	src/History.cpp
 	src/Hooks.cpp
 	src/ImGui/Renderer.cpp
 	src/ImGui/Util.cpp
+	src/ImageSequence.cpp
+	src/KeyframeIndex.cpp
+	src/LoadOrder.cpp
 	src/Manager.cpp
+	src/Memory.cpp
+	src/MemoryReport.cpp
 	src/PCH.cpp
+	src/Prefetcher.cpp
+	src/QOI.cpp
+	src/QualityController.cpp
+	src/R10G10B10A2.cpp
+	src/StripePool.cpp
+	src/Suspension.cpp
+	src/Telemetry.cpp
+	src/VideoList.cpp
 	src/VideoPlayer.cpp
+	src/Visibility.cpp
+	src/WarmStart.cpp
 	src/main.cpp
 )
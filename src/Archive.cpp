@@ -0,0 +1,363 @@
+#include "Archive.h"
+
+#include "LoadOrder.h"
+
+namespace Archive
+{
+	namespace detail
+	{
+		using Lock = std::shared_mutex;
+		using ReadLocker = std::shared_lock<Lock>;
+		using WriteLocker = std::unique_lock<Lock>;
+
+		struct Registry
+		{
+			Lock                                   lock;
+			std::unordered_map<std::string, Entry> entries;  // by lowercase path
+		};
+
+		Registry& get_registry()
+		{
+			static Registry registry;
+			return registry;
+		}
+
+		// implicit masters, then Creation Club plugins, then the active ones in Plugins.txt; only plugins that are installed
+		std::vector<std::string> get_plugins(const std::filesystem::path& a_dataDirectory)
+		{
+			std::vector<std::string> listed(LoadOrder::implicitPlugins.begin(), LoadOrder::implicitPlugins.end());
+
+			const auto append = [&](const std::filesystem::path& a_path, bool a_activeOnly) {
+				std::ifstream file(a_path);
+				if (!file) {
+					return false;
+				}
+				std::ranges::move(LoadOrder::ReadPlugins(file, a_activeOnly), std::back_inserter(listed));
+				return true;
+			};
+			append(a_dataDirectory.parent_path() / "Skyrim.ccc"sv, false);
+
+			// the game keeps it in %LOCALAPPDATA% under the same folder name as in My Games, where the log directory is
+			wchar_t* localAppData = nullptr;
+			if (const auto logDirectory = logger::log_directory(); logDirectory && SUCCEEDED(SHGetKnownFolderPath(FOLDERID_LocalAppData, KF_FLAG_DEFAULT, nullptr, &localAppData))) {
+				const auto path = std::filesystem::path(localAppData) / logDirectory->parent_path().filename() / "Plugins.txt"sv;
+				if (!append(path, true)) {
+					logger::warn("Unable to read {}, only archives of the base game's plugins are scanned", path.string());
+				}
+			}
+			CoTaskMemFree(localAppData);
+
+			std::vector<std::string> plugins;
+			std::error_code          ec;
+			for (auto& plugin : listed) {
+				if (std::filesystem::is_regular_file(a_dataDirectory / plugin, ec)) {
+					plugins.push_back(std::move(plugin));
+				}
+			}
+			return plugins;
+		}
+
+		std::shared_ptr<View> open_view(const std::string& a_path)
+		{
+			const auto entry = Find(a_path);
+			if (!entry) {
+				return nullptr;
+			}
+
+			auto view = std::make_shared<View>();
+			if (!view->Open(*entry)) {
+				logger::warn("Unable to map {} from {} (error {})", a_path, entry->archive.string(), GetLastError());
+				return nullptr;
+			}
+			return view;
+		}
+
+		// the decoder's reads become copies out of the view, the OS pages the archive in underneath
+		class StreamReader : public cv::IStreamReader
+		{
+		public:
+			explicit StreamReader(std::shared_ptr<const View> a_view) :
+				view(std::move(a_view))
+			{}
+
+			long long read(char* a_buffer, long long a_size) override
+			{
+				const auto data = view->GetData();
+				const auto count = std::min(a_size, static_cast<long long>(data.size()) - position);
+				if (count <= 0) {
+					return 0;
+				}
+				std::memcpy(a_buffer, data.data() + position, static_cast<std::size_t>(count));
+				position += count;
+				return count;
+			}
+
+			long long seek(long long a_offset, int a_origin) override
+			{
+				const auto size = static_cast<long long>(view->GetData().size());
+				const auto target = (a_origin == SEEK_CUR ? position : a_origin == SEEK_END ? size : 0) + a_offset;
+				if (target < 0 || target > size) {
+					return -1;
+				}
+				position = target;
+				return position;
+			}
+
+		private:
+			// members
+			std::shared_ptr<const View> view;
+			long long                   position{ 0 };
+		};
+
+		// the same for Media Foundation; reads finish before BeginRead returns, there's no I/O to wait on besides page faults
+		class ByteStream : public Microsoft::WRL::RuntimeClass<Microsoft::WRL::RuntimeClassFlags<Microsoft::WRL::ClassicCom>, IMFByteStream>
+		{
+		public:
+			explicit ByteStream(std::shared_ptr<const View> a_view) :
+				view(std::move(a_view))
+			{}
+
+			STDMETHODIMP GetCapabilities(DWORD* a_capabilities) override
+			{
+				*a_capabilities = MFBYTESTREAM_IS_READABLE | MFBYTESTREAM_IS_SEEKABLE;
+				return S_OK;
+			}
+
+			STDMETHODIMP GetLength(QWORD* a_length) override
+			{
+				*a_length = view->GetData().size();
+				return S_OK;
+			}
+
+			STDMETHODIMP GetCurrentPosition(QWORD* a_position) override
+			{
+				Locker locker(lock);
+				*a_position = position;
+				return S_OK;
+			}
+
+			STDMETHODIMP SetCurrentPosition(QWORD a_position) override
+			{
+				if (a_position > view->GetData().size()) {
+					return E_INVALIDARG;
+				}
+				Locker locker(lock);
+				position = a_position;
+				return S_OK;
+			}
+
+			STDMETHODIMP IsEndOfStream(BOOL* a_endOfStream) override
+			{
+				Locker locker(lock);
+				*a_endOfStream = position >= view->GetData().size();
+				return S_OK;
+			}
+
+			STDMETHODIMP Read(BYTE* a_buffer, ULONG a_size, ULONG* a_read) override
+			{
+				const auto data = view->GetData();
+
+				Locker     locker(lock);
+				const auto count = position < data.size() ? static_cast<ULONG>(std::min<QWORD>(a_size, data.size() - position)) : 0;
+				if (count > 0) {
+					std::memcpy(a_buffer, data.data() + position, count);
+					position += count;
+				}
+				*a_read = count;
+				return S_OK;
+			}
+
+			STDMETHODIMP BeginRead(BYTE* a_buffer, ULONG a_size, IMFAsyncCallback* a_callback, IUnknown* a_state) override
+			{
+				ULONG                  count = 0;
+				const HRESULT          hr = Read(a_buffer, a_size, &count);
+				ComPtr<IMFAsyncResult> result;
+				if (FAILED(MFCreateAsyncResult(nullptr, a_callback, a_state, &result))) {
+					return E_OUTOFMEMORY;
+				}
+				result->SetStatus(hr);
+				{
+					Locker locker(lock);
+					completedReads[result.Get()] = count;
+				}
+				return MFInvokeCallback(result.Get());
+			}
+
+			STDMETHODIMP EndRead(IMFAsyncResult* a_result, ULONG* a_read) override
+			{
+				Locker     locker(lock);
+				const auto it = completedReads.find(a_result);
+				*a_read = it != completedReads.end() ? it->second : 0;
+				if (it != completedReads.end()) {
+					completedReads.erase(it);
+				}
+				return a_result->GetStatus();
+			}
+
+			STDMETHODIMP Seek(MFBYTESTREAM_SEEK_ORIGIN a_origin, LONGLONG a_offset, DWORD, QWORD* a_position) override
+			{
+				Locker     locker(lock);
+				const auto target = (a_origin == msoCurrent ? static_cast<LONGLONG>(position) : 0) + a_offset;
+				if (target < 0 || static_cast<QWORD>(target) > view->GetData().size()) {
+					return E_INVALIDARG;
+				}
+				position = static_cast<QWORD>(target);
+				*a_position = position;
+				return S_OK;
+			}
+
+			// read-only
+			STDMETHODIMP SetLength(QWORD) override { return E_NOTIMPL; }
+			STDMETHODIMP Write(const BYTE*, ULONG, ULONG*) override { return E_NOTIMPL; }
+			STDMETHODIMP BeginWrite(const BYTE*, ULONG, IMFAsyncCallback*, IUnknown*) override { return E_NOTIMPL; }
+			STDMETHODIMP EndWrite(IMFAsyncResult*, ULONG*) override { return E_NOTIMPL; }
+			STDMETHODIMP Flush() override { return S_OK; }
+			STDMETHODIMP Close() override { return S_OK; }
+
+		private:
+			using Locker = std::scoped_lock<std::mutex>;
+
+			// members
+			std::shared_ptr<const View>                view;
+			std::mutex                                 lock;
+			QWORD                                      position{ 0 };
+			std::unordered_map<IMFAsyncResult*, ULONG> completedReads;  // counts BeginRead leaves for EndRead
+		};
+	}
+
+	std::vector<std::filesystem::path> Scan(const std::filesystem::path& a_dataDirectory, std::string_view a_directory, std::span<const std::string_view> a_extensions)
+	{
+		std::vector<std::filesystem::path> present;
+		std::error_code                    ec;
+		for (const auto& entry : std::filesystem::directory_iterator(a_dataDirectory, ec)) {
+			const auto ext = clib_util::string::tolower(entry.path().extension().string());
+			if ((ext == ".bsa"sv || ext == ".ba2"sv) && entry.is_regular_file(ec)) {
+				present.push_back(entry.path());
+			}
+		}
+
+		// only the archives the game loads, the one loaded last first so its videos override the others'
+		auto archives = LoadOrder::GetArchives(detail::get_plugins(a_dataDirectory), present);
+		std::ranges::reverse(archives);
+		if (archives.size() < present.size()) {
+			logger::info("{} of {} archives belong to a loaded plugin", archives.size(), present.size());
+		}
+
+		auto&                              registry = detail::get_registry();
+		detail::WriteLocker                lock(registry.lock);
+		std::vector<std::filesystem::path> videos;
+		for (const auto& archive : archives) {
+			std::ifstream file(archive, std::ios::binary);
+			const auto    files = ArchiveIndex::Read(file, a_directory);
+			if (!files) {
+				continue;  // texture archives, or something else named .bsa
+			}
+
+			for (const auto& [name, offset, size, compressed] : *files) {
+				auto       path = archive / name;
+				const auto ext = clib_util::string::tolower(path.extension().string());
+				if (std::ranges::find(a_extensions, ext) == a_extensions.end()) {
+					continue;
+				}
+				if (compressed) {
+					logger::warn("Skipping {}, videos in archives have to be stored uncompressed to play", path.string());
+					continue;
+				}
+				registry.entries.insert_or_assign(clib_util::string::tolower(path.string()), Entry{ archive, offset, size });
+				videos.push_back(std::move(path));
+			}
+		}
+		return videos;
+	}
+
+	std::optional<Entry> Find(const std::string& a_path)
+	{
+		auto&              registry = detail::get_registry();
+		detail::ReadLocker lock(registry.lock);
+		if (const auto it = registry.entries.find(clib_util::string::tolower(a_path)); it != registry.entries.end()) {
+			return it->second;
+		}
+		return std::nullopt;
+	}
+
+	View::~View()
+	{
+		Close();
+	}
+
+	bool View::Open(const Entry& a_entry)
+	{
+		Close();
+
+		file = CreateFileW(a_entry.archive.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+
+		// only the file's own range is mapped, from the allocation granularity boundary before it
+		SYSTEM_INFO info{};
+		GetSystemInfo(&info);
+		const std::uint64_t start = a_entry.offset / info.dwAllocationGranularity * info.dwAllocationGranularity;
+		const std::uint64_t viewSize = a_entry.offset + a_entry.size - start;
+
+		mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping) {
+			base = MapViewOfFile(mapping, FILE_MAP_READ, static_cast<DWORD>(start >> 32), static_cast<DWORD>(start), static_cast<SIZE_T>(viewSize));
+		}
+		if (!base) {
+			Close();
+			return false;
+		}
+
+		data = { static_cast<const std::uint8_t*>(base) + (a_entry.offset - start), static_cast<std::size_t>(a_entry.size) };
+		return true;
+	}
+
+	void View::Close()
+	{
+		if (base) {
+			UnmapViewOfFile(base);
+			base = nullptr;
+		}
+		if (mapping) {
+			CloseHandle(mapping);
+			mapping = nullptr;
+		}
+		if (file != INVALID_HANDLE_VALUE) {
+			CloseHandle(file);
+			file = INVALID_HANDLE_VALUE;
+		}
+		data = {};
+	}
+
+	std::span<const std::uint8_t> View::GetData() const
+	{
+		return data;
+	}
+
+	cv::Ptr<cv::IStreamReader> CreateStreamReader(const std::string& a_path)
+	{
+		auto view = detail::open_view(a_path);
+		if (!view) {
+			return nullptr;
+		}
+		return cv::makePtr<detail::StreamReader>(std::move(view));
+	}
+
+	HRESULT CreateSourceReader(const std::string& a_path, IMFAttributes* a_attributes, IMFSourceReader** a_reader)
+	{
+		if (!Find(a_path)) {
+			return MFCreateSourceReaderFromURL(stl::utf8_to_utf16(a_path)->c_str(), a_attributes, a_reader);
+		}
+
+		auto view = detail::open_view(a_path);
+		if (!view) {
+			return E_FAIL;
+		}
+		const auto stream = Microsoft::WRL::Make<detail::ByteStream>(std::move(view));
+		if (!stream) {
+			return E_OUTOFMEMORY;
+		}
+		return MFCreateSourceReaderFromByteStream(stream.Get(), a_attributes, a_reader);
+	}
+}
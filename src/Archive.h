@@ -0,0 +1,52 @@
+#pragma once
+
+#include "ArchiveIndex.h"
+
+// Videos shipped inside BSA/BA2 archives, played straight out of them: decoders read a mapped view of the file's
+// range, nothing is extracted. Such a video's path is the archive's followed by the name inside it
+// (Data\MyMod.bsa\mainmenuvideo\intro.mp4), so caches, logs and variant grouping treat it like a loose file.
+namespace Archive
+{
+	struct Entry
+	{
+		std::filesystem::path archive;
+		std::uint64_t         offset{ 0 };
+		std::uint64_t         size{ 0 };
+	};
+
+	// videos directly under a_directory in the archives of loaded plugins in a_dataDirectory, remembered for Find. The
+	// archive loaded last comes first, its videos win over the others'. Compressed ones are skipped with a warning, they'd
+	// have to be extracted to play
+	std::vector<std::filesystem::path> Scan(const std::filesystem::path& a_dataDirectory, std::string_view a_directory, std::span<const std::string_view> a_extensions);
+
+	// nullopt for anything Scan didn't return, loose files included
+	std::optional<Entry> Find(const std::string& a_path);
+
+	class View
+	{
+	public:
+		View() = default;
+		View(const View&) = delete;
+		~View();
+
+		View& operator=(const View&) = delete;
+
+		bool Open(const Entry& a_entry);
+		void Close();
+
+		std::span<const std::uint8_t> GetData() const;
+
+	private:
+		// members
+		HANDLE                        file{ INVALID_HANDLE_VALUE };
+		HANDLE                        mapping{ nullptr };
+		void*                         base{ nullptr };
+		std::span<const std::uint8_t> data;
+	};
+
+	// cv::VideoCapture input reading the mapped file, nullptr for loose files or if the archive can't be mapped
+	cv::Ptr<cv::IStreamReader> CreateStreamReader(const std::string& a_path);
+
+	// MFCreateSourceReaderFromURL for loose files, a source reader over the mapped file for archived ones
+	HRESULT CreateSourceReader(const std::string& a_path, IMFAttributes* a_attributes, IMFSourceReader** a_reader);
+}
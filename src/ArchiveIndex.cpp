@@ -0,0 +1,239 @@
+#include "ArchiveIndex.h"
+
+namespace ArchiveIndex
+{
+	namespace detail
+	{
+		namespace bsa
+		{
+			constexpr std::array<char, 4> magic{ 'B', 'S', 'A', '\0' };
+
+			enum ArchiveFlag : std::uint32_t
+			{
+				kDirectoryNames = 1 << 0,
+				kFileNames = 1 << 1,
+				kCompressed = 1 << 2,
+				kEmbeddedNames = 1 << 8
+			};
+
+			constexpr std::uint32_t compressionToggle{ 1u << 30 };  // in a file's size, flips the archive's default
+			constexpr std::uint32_t sizeMask{ compressionToggle - 1 };
+		}
+
+		namespace ba2
+		{
+			constexpr std::array<char, 4> magic{ 'B', 'T', 'D', 'X' };
+			constexpr std::array<char, 4> general{ 'G', 'N', 'R', 'L' };
+		}
+
+		template <class T>
+		bool read(std::istream& a_stream, T& a_value)
+		{
+			return static_cast<bool>(a_stream.read(reinterpret_cast<char*>(&a_value), sizeof(T)));
+		}
+
+		std::string normalize(std::string a_name)
+		{
+			std::ranges::replace(a_name, '/', '\\');
+			std::ranges::transform(a_name, a_name.begin(), [](char a_char) { return static_cast<char>(std::tolower(static_cast<unsigned char>(a_char))); });
+			return a_name;
+		}
+
+		// a_name is normalized, a_directory is normalized without a trailing separator
+		bool in_directory(std::string_view a_name, std::string_view a_directory)
+		{
+			if (a_directory.empty()) {
+				return true;
+			}
+			return a_name.size() > a_directory.size() + 1 && a_name.starts_with(a_directory) && a_name[a_directory.size()] == '\\' &&
+			       a_name.find('\\', a_directory.size() + 1) == std::string_view::npos;
+		}
+
+		std::optional<std::vector<File>> read_bsa(std::istream& a_archive, const std::string& a_directory)
+		{
+			struct Header
+			{
+				std::uint32_t version;
+				std::uint32_t headerSize;
+				std::uint32_t flags;
+				std::uint32_t folderCount;
+				std::uint32_t fileCount;
+				std::uint32_t folderNamesLength;
+				std::uint32_t fileNamesLength;
+				std::uint32_t contentFlags;
+			} header;
+			if (!read(a_archive, header) || header.version < 103 || header.version > 105) {
+				return std::nullopt;
+			}
+			// folder and file names are optional, without them there's nothing to find a file by
+			if ((header.flags & bsa::kDirectoryNames) == 0 || (header.flags & bsa::kFileNames) == 0) {
+				return std::vector<File>{};
+			}
+
+			// folder records only hold hashes and counts here; 105 widened the offset to 64 bits
+			const std::uint32_t        folderRecordSize = header.version == 105 ? 24 : 16;
+			std::vector<std::uint32_t> folderFileCounts(header.folderCount);
+			a_archive.seekg(header.headerSize);
+			for (auto& count : folderFileCounts) {
+				std::uint64_t hash;
+				if (!read(a_archive, hash) || !read(a_archive, count) || !a_archive.ignore(folderRecordSize - 12)) {
+					return std::nullopt;
+				}
+			}
+
+			// only the wanted folders' records are kept, the rest (every texture in a vanilla archive) are skipped over
+			struct Record
+			{
+				std::uint32_t index;  // into the file names
+				std::string   folder;
+				std::uint32_t size;
+				std::uint32_t offset;
+			};
+			std::vector<Record> records;
+			std::uint32_t       fileIndex = 0;
+			for (const auto count : folderFileCounts) {
+				std::uint8_t length = 0;
+				if (!read(a_archive, length) || length == 0) {
+					return std::nullopt;
+				}
+				std::string folder(length, '\0');
+				if (!a_archive.read(folder.data(), length)) {
+					return std::nullopt;
+				}
+				folder = normalize(folder.substr(0, folder.find('\0')));
+
+				if (!a_directory.empty() && folder != a_directory) {
+					if (!a_archive.ignore(std::streamsize(count) * 16)) {
+						return std::nullopt;
+					}
+					fileIndex += count;
+					continue;
+				}
+
+				for (std::uint32_t i = 0; i < count; ++i) {
+					std::uint64_t hash;
+					Record        record{ fileIndex++, folder, 0, 0 };
+					if (!read(a_archive, hash) || !read(a_archive, record.size) || !read(a_archive, record.offset)) {
+						return std::nullopt;
+					}
+					records.push_back(std::move(record));
+				}
+			}
+
+			std::string names(header.fileNamesLength, '\0');
+			if (!a_archive.read(names.data(), static_cast<std::streamsize>(names.size()))) {
+				return std::nullopt;
+			}
+
+			const bool embeddedNames = header.version != 103 && (header.flags & bsa::kEmbeddedNames) != 0;
+
+			std::vector<File> files;
+			std::uint32_t     nameIndex = 0;
+			std::size_t       nameStart = 0;
+			for (const auto& record : records) {
+				// names are in record order, walk up to this one's
+				for (; nameIndex < record.index; ++nameIndex) {
+					nameStart = names.find('\0', nameStart);
+					if (nameStart == std::string::npos) {
+						return std::nullopt;
+					}
+					nameStart++;
+				}
+				const auto nameEnd = names.find('\0', nameStart);
+				if (nameEnd == std::string::npos) {
+					return std::nullopt;
+				}
+
+				File file{ record.folder + '\\' + normalize(names.substr(nameStart, nameEnd - nameStart)), record.offset, record.size & bsa::sizeMask,
+					((header.flags & bsa::kCompressed) != 0) != ((record.size & bsa::compressionToggle) != 0) };
+				if (embeddedNames) {
+					// a length prefixed copy of the path sits in front of the data and is counted in its size
+					std::uint8_t length = 0;
+					if (!a_archive.seekg(static_cast<std::streamoff>(file.offset)) || !read(a_archive, length) || file.size < length + 1u) {
+						return std::nullopt;
+					}
+					file.offset += length + 1u;
+					file.size -= length + 1u;
+				}
+				files.push_back(std::move(file));
+			}
+			return files;
+		}
+
+		std::optional<std::vector<File>> read_ba2(std::istream& a_archive, const std::string& a_directory)
+		{
+			std::uint32_t       version = 0;
+			std::array<char, 4> type{};
+			std::uint32_t       fileCount = 0;
+			std::uint64_t       namesOffset = 0;
+			if (!read(a_archive, version) || !read(a_archive, type) || !read(a_archive, fileCount) || !read(a_archive, namesOffset)) {
+				return std::nullopt;
+			}
+			// texture archives (DX10, GNMF) hold chunked mips, never videos
+			if (type != ba2::general) {
+				return std::nullopt;
+			}
+			// Starfield's versions carry extra header fields
+			if (version == 2 || version == 3) {
+				a_archive.ignore(version == 3 ? 12 : 8);
+			}
+
+			// 36 bytes each: name hash, extension, directory hash, flags, then these, then a 0xBAADF00D sentinel
+			struct Record
+			{
+				std::uint64_t offset;
+				std::uint32_t packedSize;  // 0 if stored uncompressed
+				std::uint32_t size;
+			};
+			std::vector<Record> records(fileCount);
+			for (auto& record : records) {
+				if (!a_archive.ignore(16) || !read(a_archive, record.offset) || !read(a_archive, record.packedSize) || !read(a_archive, record.size) || !a_archive.ignore(4)) {
+					return std::nullopt;
+				}
+			}
+
+			if (!a_archive.seekg(static_cast<std::streamoff>(namesOffset))) {
+				return std::nullopt;
+			}
+
+			std::vector<File> files;
+			for (const auto& record : records) {
+				std::uint16_t length = 0;
+				if (!read(a_archive, length)) {
+					return std::nullopt;
+				}
+				std::string name(length, '\0');
+				if (!a_archive.read(name.data(), length)) {
+					return std::nullopt;
+				}
+				name = normalize(std::move(name));
+
+				if (in_directory(name, a_directory)) {
+					const bool compressed = record.packedSize != 0;
+					files.push_back({ std::move(name), record.offset, compressed ? record.packedSize : record.size, compressed });
+				}
+			}
+			return files;
+		}
+	}
+
+	std::optional<std::vector<File>> Read(std::istream& a_archive, std::string_view a_directory)
+	{
+		auto directory = detail::normalize(std::string(a_directory));
+		while (directory.ends_with('\\')) {
+			directory.pop_back();
+		}
+
+		std::array<char, 4> magic{};
+		if (!detail::read(a_archive, magic)) {
+			return std::nullopt;
+		}
+		if (magic == detail::bsa::magic) {
+			return detail::read_bsa(a_archive, directory);
+		}
+		if (magic == detail::ba2::magic) {
+			return detail::read_ba2(a_archive, directory);
+		}
+		return std::nullopt;
+	}
+}
@@ -0,0 +1,17 @@
+#pragma once
+
+// Table of contents of Bethesda archives: BSA (Skyrim LE 104, SE 105) and general BA2 (Fallout 4, Starfield).
+// Only enough of it to find a file's bytes; shared with tools/ArchiveReader.
+namespace ArchiveIndex
+{
+	struct File
+	{
+		std::string   name;          // lowercase and backslash separated, "mainmenuvideo\intro.mp4"
+		std::uint64_t offset{ 0 };   // of the file's own bytes, past any name the archive embeds in front of them
+		std::uint64_t size{ 0 };     // as stored, so the packed size if compressed
+		bool          compressed{ false };
+	};
+
+	// files directly inside a_directory (any case, empty for every file), nullopt if a_archive isn't a BSA or general BA2
+	std::optional<std::vector<File>> Read(std::istream& a_archive, std::string_view a_directory);
+}
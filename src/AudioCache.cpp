@@ -0,0 +1,85 @@
+#include "AudioCache.h"
+
+namespace AudioCache
+{
+	Reader::~Reader()
+	{
+		Close();
+	}
+
+	bool Reader::Open(const std::filesystem::path& a_path, const Cache::Stamp& a_stamp)
+	{
+		Close();
+
+		file = CreateFileW(a_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(Header))) {
+			Close();
+			return false;
+		}
+
+		mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping) {
+			view = static_cast<const std::uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		}
+		if (!view) {
+			Close();
+			return false;
+		}
+
+		const auto valid = Validate({ view, static_cast<std::size_t>(size.QuadPart) }, a_stamp);
+		if (!valid) {
+			Close();
+			std::error_code ec;
+			std::filesystem::remove(a_path, ec);
+			return false;
+		}
+		header = *valid;
+
+		return true;
+	}
+
+	void Reader::Close()
+	{
+		if (view) {
+			UnmapViewOfFile(view);
+			view = nullptr;
+		}
+		if (mapping) {
+			CloseHandle(mapping);
+			mapping = nullptr;
+		}
+		if (file != INVALID_HANDLE_VALUE) {
+			CloseHandle(file);
+			file = INVALID_HANDLE_VALUE;
+		}
+		header = {};
+	}
+
+	bool Reader::IsOpen() const
+	{
+		return view != nullptr;
+	}
+
+	const WAVEFORMATEX* Reader::GetFormat() const
+	{
+		return view ? reinterpret_cast<const WAVEFORMATEX*>(view + sizeof(Header)) : nullptr;
+	}
+
+	std::uint32_t Reader::GetFormatSize() const
+	{
+		return header.formatBytes;
+	}
+
+	std::span<const std::uint8_t> Reader::GetData() const
+	{
+		if (!view) {
+			return {};
+		}
+		return { view + sizeof(Header) + header.formatBytes, static_cast<std::size_t>(header.dataBytes) };
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include "AudioCacheFile.h"
+#include "Cache.h"
+
+// Decoded audio tracks, in whatever PCM/float format the audio renderer accepted.
+// The first playthrough writes the decoder's output, later loops and boots map the file and feed it straight to the sink.
+namespace AudioCache
+{
+	class Reader
+	{
+	public:
+		Reader() = default;
+		Reader(const Reader&) = delete;
+		~Reader();
+
+		Reader& operator=(const Reader&) = delete;
+
+		bool Open(const std::filesystem::path& a_path, const Cache::Stamp& a_stamp);
+		void Close();
+
+		bool IsOpen() const;
+
+		const WAVEFORMATEX*           GetFormat() const;
+		std::uint32_t                 GetFormatSize() const;
+		std::span<const std::uint8_t> GetData() const;  // mapped view, no copy is made
+
+	private:
+		// members
+		HANDLE              file{ INVALID_HANDLE_VALUE };
+		HANDLE              mapping{ nullptr };
+		const std::uint8_t* view{ nullptr };
+		Header              header{};
+	};
+}
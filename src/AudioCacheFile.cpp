@@ -0,0 +1,127 @@
+#include "AudioCacheFile.h"
+
+namespace AudioCache
+{
+	std::optional<Header> Validate(std::span<const std::uint8_t> a_file, const Cache::Stamp& a_stamp)
+	{
+		if (a_file.size() < sizeof(Header)) {
+			return std::nullopt;
+		}
+
+		Header header;
+		std::memcpy(&header, a_file.data(), sizeof(Header));
+		if (header.magic != magic || header.version != version || header.stamp != a_stamp || header.formatBytes < sizeof(WAVEFORMATEX) ||
+			a_file.size() != sizeof(Header) + header.formatBytes + header.dataBytes) {
+			return std::nullopt;
+		}
+
+		WAVEFORMATEX format;
+		std::memcpy(&format, a_file.data() + sizeof(Header), sizeof(WAVEFORMATEX));
+		if (format.nBlockAlign == 0 || header.dataBytes % format.nBlockAlign != 0) {
+			return std::nullopt;
+		}
+
+		return header;
+	}
+
+	Writer::~Writer()
+	{
+		Abort("playback stopped before the end of the track"sv);
+	}
+
+	bool Writer::Begin(const std::filesystem::path& a_path, const Cache::Stamp& a_stamp, const WAVEFORMATEX* a_format, std::uint32_t a_formatSize, std::uint64_t a_maxBytes)
+	{
+		if (!a_format || a_formatSize < sizeof(WAVEFORMATEX) || a_format->nBlockAlign == 0) {
+			return false;
+		}
+
+		path = a_path;
+		tempPath = a_path;
+		tempPath += ".tmp"sv;
+		maxBytes = a_maxBytes;
+
+		header = {
+			.magic = magic,
+			.version = version,
+			.stamp = a_stamp,
+			.formatBytes = a_formatSize,
+			.padding = 0,
+			.dataBytes = 0
+		};
+
+		file.open(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(&header), sizeof(Header));  // data size is patched in on finish
+		file.write(reinterpret_cast<const char*>(a_format), a_formatSize);
+
+		active = true;
+		return true;
+	}
+
+	bool Writer::Append(std::span<const std::uint8_t> a_data)
+	{
+		if (!active) {
+			return false;
+		}
+
+		if (header.dataBytes + a_data.size() > maxBytes) {
+			Abort("track exceeds iMaxAudioCacheMB"sv);
+			return false;
+		}
+
+		file.write(reinterpret_cast<const char*>(a_data.data()), static_cast<std::streamsize>(a_data.size()));
+		if (!file) {
+			Abort("couldn't write to disk"sv);
+			return false;
+		}
+		header.dataBytes += a_data.size();
+
+		return true;
+	}
+
+	void Writer::Finish()
+	{
+		if (!active) {
+			return;
+		}
+		active = false;
+
+		file.seekp(0);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		file.close();
+
+		std::error_code ec;
+		std::filesystem::rename(tempPath, path, ec);
+		if (ec) {
+			logger::warn("\tCaching audio to {} failed: {}", path.filename().string(), ec.message());
+			Cleanup();
+		} else {
+			logger::info("\tCached {:.1f} MB of decoded audio to {}", header.dataBytes / (1024.0 * 1024.0), path.filename().string());
+		}
+	}
+
+	void Writer::Abort(std::string_view a_reason)
+	{
+		if (active) {
+			active = false;
+			logger::info("\tCaching audio to {} abandoned: {}", path.filename().string(), a_reason);
+			Cleanup();
+		}
+	}
+
+	bool Writer::IsActive() const
+	{
+		return active;
+	}
+
+	void Writer::Cleanup()
+	{
+		if (file.is_open()) {
+			file.close();
+		}
+		std::error_code ec;
+		std::filesystem::remove(tempPath, ec);
+	}
+}
@@ -0,0 +1,53 @@
+#pragma once
+
+#include "CacheEntry.h"
+
+// The audio cache's file layout, its validation and the writer, apart from the mapped reader so they build anywhere.
+// No dependencies beyond the standard library, WAVEFORMATEX and the log; shared with tests/.
+namespace AudioCache
+{
+	struct Header
+	{
+		std::uint32_t magic{ 0 };
+		std::uint32_t version{ 0 };
+		Cache::Stamp  stamp{};
+		std::uint32_t formatBytes{ 0 };  // WAVEFORMATEX(TENSIBLE) that follows the header
+		std::uint32_t padding{ 0 };
+		std::uint64_t dataBytes{ 0 };
+	};
+
+	inline constexpr std::uint32_t magic{ 0x41564D4D };  // MMVA
+	inline constexpr std::uint32_t version{ 1 };
+
+	// a_file is the whole file, nothing if it's stale, truncated or holds partial sample frames
+	std::optional<Header> Validate(std::span<const std::uint8_t> a_file, const Cache::Stamp& a_stamp);
+
+	// fed from the audio thread, so everything happens inline
+	class Writer
+	{
+	public:
+		Writer() = default;
+		Writer(const Writer&) = delete;
+		~Writer();
+
+		Writer& operator=(const Writer&) = delete;
+
+		bool Begin(const std::filesystem::path& a_path, const Cache::Stamp& a_stamp, const WAVEFORMATEX* a_format, std::uint32_t a_formatSize, std::uint64_t a_maxBytes);
+		bool Append(std::span<const std::uint8_t> a_data);
+		void Finish();
+		void Abort(std::string_view a_reason);
+
+		bool IsActive() const;
+
+	private:
+		void Cleanup();
+
+		// members
+		std::filesystem::path path;
+		std::filesystem::path tempPath;
+		std::ofstream         file;
+		Header                header{};
+		std::uint64_t         maxBytes{ 0 };
+		bool                  active{ false };
+	};
+}
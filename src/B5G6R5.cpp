@@ -0,0 +1,89 @@
+#include "B5G6R5.h"
+
+#include <emmintrin.h>
+
+namespace B5G6R5
+{
+	namespace detail
+	{
+		constexpr std::uint8_t bayer[4][4]{
+			{ 0, 8, 2, 10 },
+			{ 12, 4, 14, 6 },
+			{ 3, 11, 1, 9 },
+			{ 15, 7, 13, 5 }
+		};
+
+		// added to B, G, R before their low bits are dropped. Without dithering it's half a step, which rounds; with it
+		// each step of the 4x4 pattern gets a different bias spread evenly over [0, step), so the average colour is kept
+		std::array<std::uint8_t, 16> get_bias(std::uint32_t a_row, bool a_dither)
+		{
+			std::array<std::uint8_t, 16> bias{};
+			for (std::uint32_t x = 0; x < 4; ++x) {
+				const std::uint8_t threshold = a_dither ? bayer[a_row & 3][x] : 8;
+				bias[x * 4 + 0] = static_cast<std::uint8_t>(threshold >> 1);  // 5 bits, steps of 8
+				bias[x * 4 + 1] = static_cast<std::uint8_t>(threshold >> 2);  // 6 bits, steps of 4
+				bias[x * 4 + 2] = static_cast<std::uint8_t>(threshold >> 1);
+			}
+			return bias;
+		}
+
+		inline std::uint16_t pack(std::uint32_t a_bgra)
+		{
+			return static_cast<std::uint16_t>(((a_bgra >> 8) & 0xF800) | ((a_bgra >> 5) & 0x07E0) | ((a_bgra >> 3) & 0x001F));
+		}
+
+		// the same as pack() on four pixels, left sign extended so the signed 32 -> 16 bit pack keeps the bit pattern
+		inline __m128i pack(__m128i a_bgra)
+		{
+			const __m128i r = _mm_and_si128(_mm_srli_epi32(a_bgra, 8), _mm_set1_epi32(0xF800));
+			const __m128i g = _mm_and_si128(_mm_srli_epi32(a_bgra, 5), _mm_set1_epi32(0x07E0));
+			const __m128i b = _mm_and_si128(_mm_srli_epi32(a_bgra, 3), _mm_set1_epi32(0x001F));
+			return _mm_srai_epi32(_mm_slli_epi32(_mm_or_si128(_mm_or_si128(r, g), b), 16), 16);
+		}
+	}
+
+	void PackRow(const std::uint8_t* a_bgra, std::uint16_t* a_out, std::uint32_t a_width, std::uint32_t a_row, bool a_dither)
+	{
+		const auto    bias = detail::get_bias(a_row, a_dither);
+		const __m128i biasVec = _mm_loadu_si128(reinterpret_cast<const __m128i*>(bias.data()));
+
+		// 8 pixels a step, which keeps x a multiple of 4 so the bias lines up with the pattern
+		std::uint32_t x = 0;
+		for (; x + 8 <= a_width; x += 8) {
+			const __m128i lo = _mm_adds_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a_bgra + x * 4)), biasVec);
+			const __m128i hi = _mm_adds_epu8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a_bgra + x * 4 + 16)), biasVec);
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(a_out + x), _mm_packs_epi32(detail::pack(lo), detail::pack(hi)));
+		}
+
+		for (; x < a_width; ++x) {
+			std::uint32_t pixel = 0;
+			for (std::uint32_t c = 0; c < 3; ++c) {
+				const auto value = std::min(a_bgra[x * 4 + c] + bias[(x & 3) * 4 + c], 255);
+				pixel |= static_cast<std::uint32_t>(value) << (c * 8);
+			}
+			a_out[x] = detail::pack(pixel);
+		}
+	}
+
+	void Pack(const cv::Mat& a_src, cv::Mat& a_packed, bool a_dither, int a_firstRow)
+	{
+		a_packed.create(a_src.rows, a_src.cols, CV_16UC1);
+
+		// BGR rows are widened one at a time, so the intermediate stays in cache
+		cv::Mat widened;
+		for (int y = 0; y < a_src.rows; ++y) {
+			const std::uint8_t* bgra = a_src.ptr<std::uint8_t>(y);
+			if (a_src.channels() == 3) {
+				cv::cvtColor(a_src.row(y), widened, cv::COLOR_BGR2BGRA);
+				bgra = widened.ptr<std::uint8_t>();
+			}
+			PackRow(bgra, a_packed.ptr<std::uint16_t>(y), static_cast<std::uint32_t>(a_src.cols), static_cast<std::uint32_t>(y + a_firstRow), a_dither);
+		}
+	}
+
+	void Unpack(const cv::Mat& a_packed, cv::Mat& a_bgra)
+	{
+		const cv::Mat pairs(a_packed.rows, a_packed.cols, CV_8UC2, a_packed.data, a_packed.step);
+		cv::cvtColor(pairs, a_bgra, cv::COLOR_BGR5652BGRA);
+	}
+}
@@ -0,0 +1,13 @@
+#pragma once
+
+// 16-bit colour for opaque frames, half the upload of BGRA.
+// Packed frames are CV_16UC1 mats with blue in the low bits, matching DXGI_FORMAT_B5G6R5_UNORM (and OpenCV's BGR565).
+namespace B5G6R5
+{
+	// one row of BGRA pixels, SSE2. a_row picks the line of the 4x4 ordered dither pattern
+	void PackRow(const std::uint8_t* a_bgra, std::uint16_t* a_out, std::uint32_t a_width, std::uint32_t a_row, bool a_dither);
+
+	// a_src is BGR or BGRA; a_firstRow keeps the dither pattern continuous when a frame is packed in stripes
+	void Pack(const cv::Mat& a_src, cv::Mat& a_packed, bool a_dither, int a_firstRow = 0);
+	void Unpack(const cv::Mat& a_packed, cv::Mat& a_bgra);
+}
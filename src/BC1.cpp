@@ -0,0 +1,195 @@
+#include "BC1.h"
+
+namespace BC1
+{
+	namespace detail
+	{
+		using Color = std::array<float, 3>;  // RGB
+
+		inline std::uint16_t pack_565(const Color& a_color)
+		{
+			const auto r = static_cast<std::uint16_t>(std::clamp(a_color[0], 0.0f, 255.0f) * (31.0f / 255.0f) + 0.5f);
+			const auto g = static_cast<std::uint16_t>(std::clamp(a_color[1], 0.0f, 255.0f) * (63.0f / 255.0f) + 0.5f);
+			const auto b = static_cast<std::uint16_t>(std::clamp(a_color[2], 0.0f, 255.0f) * (31.0f / 255.0f) + 0.5f);
+			return static_cast<std::uint16_t>((r << 11) | (g << 5) | b);
+		}
+
+		inline std::array<std::uint8_t, 3> unpack_565(std::uint16_t a_color)
+		{
+			const auto r = static_cast<std::uint8_t>((a_color >> 11) & 0x1F);
+			const auto g = static_cast<std::uint8_t>((a_color >> 5) & 0x3F);
+			const auto b = static_cast<std::uint8_t>(a_color & 0x1F);
+			return {
+				static_cast<std::uint8_t>((r << 3) | (r >> 2)),
+				static_cast<std::uint8_t>((g << 2) | (g >> 4)),
+				static_cast<std::uint8_t>((b << 3) | (b >> 2))
+			};
+		}
+
+		std::array<std::array<std::uint8_t, 3>, 4> make_palette(std::uint16_t a_c0, std::uint16_t a_c1)
+		{
+			const auto c0 = unpack_565(a_c0);
+			const auto c1 = unpack_565(a_c1);
+
+			std::array<std::array<std::uint8_t, 3>, 4> palette{ c0, c1 };
+			for (std::size_t i = 0; i < 3; ++i) {
+				if (a_c0 > a_c1) {
+					palette[2][i] = static_cast<std::uint8_t>((2 * c0[i] + c1[i]) / 3);
+					palette[3][i] = static_cast<std::uint8_t>((c0[i] + 2 * c1[i]) / 3);
+				} else {
+					palette[2][i] = static_cast<std::uint8_t>((c0[i] + c1[i]) / 2);
+					palette[3][i] = 0;
+				}
+			}
+			return palette;
+		}
+
+		// principal axis fit: project the block onto its dominant colour direction and take the extremes as endpoints
+		void encode_block(const std::array<Color, 16>& a_pixels, std::uint8_t* a_out)
+		{
+			Color mean{};
+			for (const auto& px : a_pixels) {
+				for (std::size_t i = 0; i < 3; ++i) {
+					mean[i] += px[i];
+				}
+			}
+			for (auto& m : mean) {
+				m /= 16.0f;
+			}
+
+			std::array<float, 6> cov{};  // rr rg rb gg gb bb
+			for (const auto& px : a_pixels) {
+				const float r = px[0] - mean[0];
+				const float g = px[1] - mean[1];
+				const float b = px[2] - mean[2];
+				cov[0] += r * r;
+				cov[1] += r * g;
+				cov[2] += r * b;
+				cov[3] += g * g;
+				cov[4] += g * b;
+				cov[5] += b * b;
+			}
+
+			Color axis{ 1.0f, 1.0f, 1.0f };
+			for (std::uint32_t iter = 0; iter < 4; ++iter) {
+				const Color next{
+					cov[0] * axis[0] + cov[1] * axis[1] + cov[2] * axis[2],
+					cov[1] * axis[0] + cov[3] * axis[1] + cov[4] * axis[2],
+					cov[2] * axis[0] + cov[4] * axis[1] + cov[5] * axis[2]
+				};
+				const float length = std::max({ std::abs(next[0]), std::abs(next[1]), std::abs(next[2]) });
+				if (length < 1e-6f) {
+					break;  // flat block, any axis will do
+				}
+				axis = { next[0] / length, next[1] / length, next[2] / length };
+			}
+
+			float minT = std::numeric_limits<float>::max();
+			float maxT = std::numeric_limits<float>::lowest();
+			for (const auto& px : a_pixels) {
+				const float t = (px[0] - mean[0]) * axis[0] + (px[1] - mean[1]) * axis[1] + (px[2] - mean[2]) * axis[2];
+				minT = std::min(minT, t);
+				maxT = std::max(maxT, t);
+			}
+
+			// inset slightly, the extremes are usually noise and pulling them in lowers the average error
+			const float axisLengthSq = axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2];
+			const float inset = (maxT - minT) / 16.0f;
+			minT = (minT + inset) / std::max(axisLengthSq, 1e-6f);
+			maxT = (maxT - inset) / std::max(axisLengthSq, 1e-6f);
+
+			auto c0 = pack_565({ mean[0] + axis[0] * maxT, mean[1] + axis[1] * maxT, mean[2] + axis[2] * maxT });
+			auto c1 = pack_565({ mean[0] + axis[0] * minT, mean[1] + axis[1] * minT, mean[2] + axis[2] * minT });
+			if (c0 < c1) {
+				std::swap(c0, c1);
+			}
+
+			std::uint32_t indices = 0;
+			if (c0 != c1) {
+				const auto palette = make_palette(c0, c1);
+				for (std::uint32_t p = 0; p < 16; ++p) {
+					std::uint32_t best = 0;
+					float         bestDistance = std::numeric_limits<float>::max();
+					for (std::uint32_t i = 0; i < 4; ++i) {
+						const float dr = a_pixels[p][0] - palette[i][0];
+						const float dg = a_pixels[p][1] - palette[i][1];
+						const float db = a_pixels[p][2] - palette[i][2];
+						const float distance = dr * dr + dg * dg + db * db;
+						if (distance < bestDistance) {
+							bestDistance = distance;
+							best = i;
+						}
+					}
+					indices |= best << (p * 2);
+				}
+			}
+
+			std::memcpy(a_out, &c0, 2);
+			std::memcpy(a_out + 2, &c1, 2);
+			std::memcpy(a_out + 4, &indices, 4);
+		}
+	}
+
+	void Encode(const cv::Mat& a_bgra, cv::Mat& a_blocks)
+	{
+		const auto width = static_cast<std::uint32_t>(a_bgra.cols);
+		const auto height = static_cast<std::uint32_t>(a_bgra.rows);
+		const auto blocksX = GetBlockCount(width);
+		const auto blocksY = GetBlockCount(height);
+
+		a_blocks.create(static_cast<int>(blocksY), static_cast<int>(blocksX * blockBytes), CV_8UC1);
+
+		cv::parallel_for_(cv::Range(0, static_cast<int>(blocksY)), [&](const cv::Range& a_range) {
+			std::array<detail::Color, 16> pixels;
+			for (int by = a_range.start; by < a_range.end; ++by) {
+				auto* out = a_blocks.ptr<std::uint8_t>(by);
+				for (std::uint32_t bx = 0; bx < blocksX; ++bx) {
+					for (std::uint32_t py = 0; py < 4; ++py) {
+						// edge blocks repeat the last row/column
+						const auto  y = std::min(static_cast<std::uint32_t>(by) * 4 + py, height - 1);
+						const auto* row = a_bgra.ptr<std::uint8_t>(static_cast<int>(y));
+						for (std::uint32_t px = 0; px < 4; ++px) {
+							const auto* src = row + std::min(bx * 4 + px, width - 1) * 4;
+							pixels[py * 4 + px] = { static_cast<float>(src[2]), static_cast<float>(src[1]), static_cast<float>(src[0]) };
+						}
+					}
+					detail::encode_block(pixels, out + bx * blockBytes);
+				}
+			}
+		});
+	}
+
+	void Decode(const cv::Mat& a_blocks, std::uint32_t a_width, std::uint32_t a_height, cv::Mat& a_bgra)
+	{
+		a_bgra.create(static_cast<int>(a_height), static_cast<int>(a_width), CV_8UC4);
+
+		const auto blocksX = GetBlockCount(a_width);
+		const auto blocksY = GetBlockCount(a_height);
+
+		for (std::uint32_t by = 0; by < blocksY; ++by) {
+			const auto* in = a_blocks.ptr<std::uint8_t>(static_cast<int>(by));
+			for (std::uint32_t bx = 0; bx < blocksX; ++bx) {
+				std::uint16_t c0, c1;
+				std::uint32_t indices;
+				std::memcpy(&c0, in + bx * blockBytes, 2);
+				std::memcpy(&c1, in + bx * blockBytes + 2, 2);
+				std::memcpy(&indices, in + bx * blockBytes + 4, 4);
+
+				const auto palette = detail::make_palette(c0, c1);
+				for (std::uint32_t p = 0; p < 16; ++p) {
+					const auto x = bx * 4 + p % 4;
+					const auto y = by * 4 + p / 4;
+					if (x >= a_width || y >= a_height) {
+						continue;
+					}
+					const auto& color = palette[(indices >> (p * 2)) & 0x3];
+					auto*       dst = a_bgra.ptr<std::uint8_t>(static_cast<int>(y)) + x * 4;
+					dst[0] = color[2];
+					dst[1] = color[1];
+					dst[2] = color[0];
+					dst[3] = 255;
+				}
+			}
+		}
+	}
+}
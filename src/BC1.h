@@ -0,0 +1,17 @@
+#pragma once
+
+// DXT1/BC1 block compression for opaque BGRA frames.
+// Blocks are laid out as a CV_8UC1 mat with one row per row of 4x4 blocks, so they can go through the same pitched copy as raw frames.
+namespace BC1
+{
+	inline constexpr std::uint32_t blockBytes = 8;
+
+	constexpr std::uint32_t GetBlockCount(std::uint32_t a_pixels)
+	{
+		return (a_pixels + 3) / 4;
+	}
+
+	// splits block rows across OpenCV's worker threads
+	void Encode(const cv::Mat& a_bgra, cv::Mat& a_blocks);
+	void Decode(const cv::Mat& a_blocks, std::uint32_t a_width, std::uint32_t a_height, cv::Mat& a_bgra);
+}
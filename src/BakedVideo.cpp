@@ -0,0 +1,248 @@
+#include "BakedVideo.h"
+
+#include "BC1.h"
+
+namespace BakedVideo
+{
+	std::uint64_t GetSize(std::uint32_t a_width, std::uint32_t a_height, std::uint32_t a_frameCount)
+	{
+		const std::uint64_t frameBytes = std::uint64_t(BC1::GetBlockCount(a_width)) * BC1::GetBlockCount(a_height) * BC1::blockBytes;
+		return sizeof(Header) + frameBytes * a_frameCount;
+	}
+
+	Reader::~Reader()
+	{
+		Close();
+	}
+
+	bool Reader::Open(const std::filesystem::path& a_path, const Cache::Stamp& a_stamp)
+	{
+		Close();
+
+		file = CreateFileW(a_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			return false;
+		}
+
+		LARGE_INTEGER size{};
+		if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(Header))) {
+			Close();
+			return false;
+		}
+
+		mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping) {
+			view = static_cast<const std::uint8_t*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+		}
+		if (!view) {
+			Close();
+			return false;
+		}
+
+		std::memcpy(&header, view, sizeof(Header));
+
+		const auto expectedSize = sizeof(Header) + std::uint64_t(header.frameBytes) * header.frameCount;
+		if (header.magic != magic || header.version != version || header.stamp != a_stamp || header.blockRows != BC1::GetBlockCount(header.height) || static_cast<std::uint64_t>(size.QuadPart) != expectedSize) {
+			Close();
+			std::error_code ec;
+			std::filesystem::remove(a_path, ec);
+			return false;
+		}
+
+		return true;
+	}
+
+	void Reader::Close()
+	{
+		if (view) {
+			UnmapViewOfFile(view);
+			view = nullptr;
+		}
+		if (mapping) {
+			CloseHandle(mapping);
+			mapping = nullptr;
+		}
+		if (file != INVALID_HANDLE_VALUE) {
+			CloseHandle(file);
+			file = INVALID_HANDLE_VALUE;
+		}
+		header = {};
+	}
+
+	bool Reader::IsOpen() const
+	{
+		return view != nullptr;
+	}
+
+	const Header& Reader::GetHeader() const
+	{
+		return header;
+	}
+
+	cv::Mat Reader::GetFrame(std::uint32_t a_index) const
+	{
+		if (!view || a_index >= header.frameCount) {
+			return {};
+		}
+		auto* data = const_cast<std::uint8_t*>(view + sizeof(Header) + std::size_t(header.frameBytes) * a_index);
+		return cv::Mat(static_cast<int>(header.blockRows), static_cast<int>(header.frameBytes / header.blockRows), CV_8UC1, data);
+	}
+
+	Writer::~Writer()
+	{
+		if (encodeThread.joinable()) {
+			if (finishing.load(std::memory_order_relaxed)) {
+				encodeThread.join();
+			} else {
+				Abort("playback stopped before the end of the video"sv);
+			}
+		}
+	}
+
+	bool Writer::Begin(const std::filesystem::path& a_path, const Cache::Stamp& a_stamp, std::uint32_t a_width, std::uint32_t a_height, float a_fps)
+	{
+		path = a_path;
+		tempPath = a_path;
+		tempPath += ".tmp"sv;
+
+		header = {
+			.magic = magic,
+			.version = version,
+			.stamp = a_stamp,
+			.width = a_width,
+			.height = a_height,
+			.fps = a_fps,
+			.frameCount = 0,
+			.frameBytes = BC1::GetBlockCount(a_width) * BC1::GetBlockCount(a_height) * BC1::blockBytes,
+			.blockRows = BC1::GetBlockCount(a_height)
+		};
+
+		file.open(tempPath, std::ios::binary | std::ios::trunc);
+		if (!file) {
+			return false;
+		}
+		file.write(reinterpret_cast<const char*>(&header), sizeof(Header));  // frame count is patched in on finish
+
+		finishing.store(false, std::memory_order_relaxed);
+		active.store(true, std::memory_order_relaxed);
+		encodeThread = std::jthread([this](std::stop_token st) {
+			SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+			WriteFrames(st);
+		});
+
+		return true;
+	}
+
+	bool Writer::Push(const cv::Mat& a_frame)
+	{
+		if (!IsActive()) {
+			return false;
+		}
+
+		const auto frameBytes = static_cast<std::int64_t>(a_frame.total() * a_frame.elemSize());
+		bool       withinBudget = true;
+		{
+			Locker lock(queueLock);
+			withinBudget = Memory::Tracker::GetSingleton()->CanAllocate(frameBytes);
+			if (queue.size() < maxQueuedFrames && withinBudget) {
+				queue.push_back(a_frame.clone());
+				queueMemory.Set(queueMemory.Get() + frameBytes);
+				queueCV.notify_one();
+				return true;
+			}
+		}
+
+		Abort(withinBudget ? "encoder couldn't keep up with playback"sv : "memory budget exceeded"sv);
+		return false;
+	}
+
+	void Writer::Finish()
+	{
+		Locker lock(queueLock);
+		finishing.store(true, std::memory_order_relaxed);
+		queueCV.notify_one();
+	}
+
+	void Writer::Abort(std::string_view a_reason)
+	{
+		if (encodeThread.joinable()) {
+			encodeThread.request_stop();
+			encodeThread.join();
+		}
+		if (active.exchange(false, std::memory_order_relaxed)) {
+			logger::info("\tBaking {} abandoned: {}", path.filename().string(), a_reason);
+			Cleanup();
+		}
+	}
+
+	bool Writer::IsActive() const
+	{
+		return active.load(std::memory_order_relaxed) && !finishing.load(std::memory_order_relaxed);
+	}
+
+	void Writer::WriteFrames(std::stop_token a_st)
+	{
+		cv::Mat blocks;
+		while (true) {
+			cv::Mat frame;
+			{
+				Locker lock(queueLock);
+				if (!queueCV.wait(lock, a_st, [this] { return !queue.empty() || finishing; })) {
+					return;  // aborted, caller cleans up
+				}
+				if (queue.empty()) {
+					break;  // finishing and fully drained
+				}
+				frame = std::move(queue.front());
+				queue.pop_front();
+				queueMemory.Set(queueMemory.Get() - static_cast<std::int64_t>(frame.total() * frame.elemSize()));
+			}
+
+			const auto startTime = std::chrono::steady_clock::now();
+			BC1::Encode(frame, blocks);
+
+			if (header.frameCount == 0) {
+				const auto encodeTime = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+				cv::Mat    decoded;
+				BC1::Decode(blocks, header.width, header.height, decoded);
+				logger::info("\tBaking {} ({:.1f} ms/frame, {:.1f} dB PSNR)", path.filename().string(), encodeTime, cv::PSNR(frame, decoded));
+			}
+
+			file.write(reinterpret_cast<const char*>(blocks.data), header.frameBytes);
+			if (!file) {
+				logger::warn("\tBaking {} failed: couldn't write to disk", path.filename().string());
+				active.store(false, std::memory_order_relaxed);
+				Cleanup();
+				return;
+			}
+			header.frameCount++;
+		}
+
+		file.seekp(0);
+		file.write(reinterpret_cast<const char*>(&header), sizeof(Header));
+		file.close();
+
+		std::error_code ec;
+		std::filesystem::rename(tempPath, path, ec);
+		if (ec) {
+			logger::warn("\tBaking {} failed: {}", path.filename().string(), ec.message());
+			Cleanup();
+		} else {
+			logger::info("\tBaked {} frames to {}", header.frameCount, path.filename().string());
+		}
+		active.store(false, std::memory_order_relaxed);
+	}
+
+	void Writer::Cleanup()
+	{
+		if (file.is_open()) {
+			file.close();
+		}
+		std::error_code ec;
+		std::filesystem::remove(tempPath, ec);
+
+		Locker lock(queueLock);
+		queue.clear();
+		queueMemory.Set(0);
+	}
+}
@@ -0,0 +1,95 @@
+#pragma once
+
+#include "Cache.h"
+#include "Memory.h"
+
+// Pre-compressed (BC1) frames for videos that loop every boot.
+// The first playthrough is encoded to the cache, later boots map the file and upload blocks as-is.
+namespace BakedVideo
+{
+	struct Header
+	{
+		std::uint32_t magic{ 0 };
+		std::uint32_t version{ 0 };
+		Cache::Stamp  stamp{};
+		std::uint32_t width{ 0 };
+		std::uint32_t height{ 0 };
+		float         fps{ 0.0f };
+		std::uint32_t frameCount{ 0 };
+		std::uint32_t frameBytes{ 0 };
+		std::uint32_t blockRows{ 0 };
+	};
+
+	inline constexpr std::uint32_t magic{ 0x42564D4D };  // MMVB
+	inline constexpr std::uint32_t version{ 1 };
+
+	std::uint64_t GetSize(std::uint32_t a_width, std::uint32_t a_height, std::uint32_t a_frameCount);
+
+	class Reader
+	{
+	public:
+		Reader() = default;
+		Reader(const Reader&) = delete;
+		~Reader();
+
+		Reader& operator=(const Reader&) = delete;
+
+		bool Open(const std::filesystem::path& a_path, const Cache::Stamp& a_stamp);
+		void Close();
+
+		bool          IsOpen() const;
+		const Header& GetHeader() const;
+
+		// wraps the mapped view, no copy is made
+		cv::Mat GetFrame(std::uint32_t a_index) const;
+
+	private:
+		// members
+		HANDLE              file{ INVALID_HANDLE_VALUE };
+		HANDLE              mapping{ nullptr };
+		const std::uint8_t* view{ nullptr };
+		Header              header{};
+	};
+
+	class Writer
+	{
+	public:
+		Writer() = default;
+		Writer(const Writer&) = delete;
+		~Writer();
+
+		Writer& operator=(const Writer&) = delete;
+
+		bool Begin(const std::filesystem::path& a_path, const Cache::Stamp& a_stamp, std::uint32_t a_width, std::uint32_t a_height, float a_fps);
+		// takes a BGRA frame, returns false once the bake has been abandoned
+		bool Push(const cv::Mat& a_frame);
+		void Finish();
+		void Abort(std::string_view a_reason);
+
+		// true while frames are still being accepted
+		bool IsActive() const;
+
+	private:
+		using Lock = std::mutex;
+		using Locker = std::unique_lock<Lock>;
+
+		void WriteFrames(std::stop_token a_st);
+		void Cleanup();
+
+		// members
+		std::filesystem::path       path;
+		std::filesystem::path       tempPath;
+		std::ofstream               file;
+		Header                      header{};
+		std::deque<cv::Mat>         queue;
+		Lock                        queueLock;
+		std::condition_variable_any queueCV;
+		std::jthread                encodeThread;
+		Memory::Usage               queueMemory{ Memory::Category::kBake };
+		std::atomic<bool>           finishing{ false };
+		std::atomic<bool>           active{ false };
+
+		// the encoder runs behind playback; if it can't keep up the bake is dropped rather than stalling the video
+		static constexpr std::size_t maxQueuedFrames{ 8 };
+	};
+}
@@ -0,0 +1,44 @@
+#include "Blend.h"
+
+#include <emmintrin.h>
+
+namespace Blend
+{
+	void LerpRow(const std::uint8_t* a_from, const std::uint8_t* a_to, std::uint8_t* a_out, std::size_t a_bytes, std::uint32_t a_weight)
+	{
+		// both products fit 16 bits (255 * 256 at most between them), so the sum never carries out of a lane
+		const __m128i zero = _mm_setzero_si128();
+		const __m128i fromWeight = _mm_set1_epi16(static_cast<short>(fullWeight - a_weight));
+		const __m128i toWeight = _mm_set1_epi16(static_cast<short>(a_weight));
+		const __m128i rounding = _mm_set1_epi16(128);
+
+		const auto lerp = [&](__m128i a_fromWords, __m128i a_toWords) {
+			const __m128i sum = _mm_add_epi16(_mm_mullo_epi16(a_fromWords, fromWeight), _mm_mullo_epi16(a_toWords, toWeight));
+			return _mm_srli_epi16(_mm_add_epi16(sum, rounding), 8);
+		};
+
+		std::size_t i = 0;
+		for (; i + 16 <= a_bytes; i += 16) {
+			const __m128i from = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a_from + i));
+			const __m128i to = _mm_loadu_si128(reinterpret_cast<const __m128i*>(a_to + i));
+			const __m128i lo = lerp(_mm_unpacklo_epi8(from, zero), _mm_unpacklo_epi8(to, zero));
+			const __m128i hi = lerp(_mm_unpackhi_epi8(from, zero), _mm_unpackhi_epi8(to, zero));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(a_out + i), _mm_packus_epi16(lo, hi));
+		}
+
+		for (; i < a_bytes; ++i) {
+			a_out[i] = static_cast<std::uint8_t>((a_from[i] * (fullWeight - a_weight) + a_to[i] * a_weight + 128) >> 8);
+		}
+	}
+
+	std::uint32_t GetWeight(double a_elapsed, double a_interval)
+	{
+		if (a_interval <= 0.0 || a_elapsed >= a_interval) {
+			return fullWeight;
+		}
+		if (a_elapsed <= 0.0) {
+			return 0;
+		}
+		return static_cast<std::uint32_t>(a_elapsed / a_interval * fullWeight + 0.5);
+	}
+}
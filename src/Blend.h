@@ -0,0 +1,14 @@
+#pragma once
+
+// Cross-fading between consecutive frames, for videos with fewer frames than the display has refreshes.
+// The frame on screen fades into the newest one over a frame's time, which shows every frame a frame late.
+namespace Blend
+{
+	inline constexpr std::uint32_t fullWeight{ 256 };  // all of the newer frame
+
+	// a_from * (256 - a_weight) + a_to * a_weight, per byte, SSE2. a_out can be mapped texture memory
+	void LerpRow(const std::uint8_t* a_from, const std::uint8_t* a_to, std::uint8_t* a_out, std::size_t a_bytes, std::uint32_t a_weight);
+
+	// weight of the newer frame a_elapsed seconds after it arrived, fading in over a_interval
+	std::uint32_t GetWeight(double a_elapsed, double a_interval);
+}
@@ -0,0 +1,65 @@
+#include "Cache.h"
+
+#include "Archive.h"
+
+namespace Cache
+{
+	std::optional<std::filesystem::path> GetDirectory()
+	{
+		static const auto directory = []() -> std::optional<std::filesystem::path> {
+			auto path = logger::log_directory();
+			if (!path) {
+				return std::nullopt;
+			}
+			*path /= "MainMenuVideo"sv;
+
+			std::error_code ec;
+			std::filesystem::create_directories(*path, ec);
+			if (ec) {
+				logger::warn("Unable to create cache directory {}: {}", path->string(), ec.message());
+				return std::nullopt;
+			}
+			return path;
+		}();
+
+		return directory;
+	}
+
+	std::optional<std::filesystem::path> GetPath(const std::string& a_video, std::string_view a_extension)
+	{
+		auto directory = GetDirectory();
+		if (!directory) {
+			return std::nullopt;
+		}
+
+		// videos with the same name can live in different folders (or archives), so key on the full path too
+		const std::filesystem::path video(a_video);
+		const auto                  hash = std::hash<std::string>{}(clib_util::string::tolower(a_video));
+
+		return *directory / std::format("{}_{:016X}{}", video.stem().string(), hash, a_extension);
+	}
+
+	std::optional<Stamp> GetStamp(const std::string& a_video)
+	{
+		// an archived video changes along with its archive
+		if (const auto entry = Archive::Find(a_video)) {
+			std::error_code ec;
+			const auto      writeTime = std::filesystem::last_write_time(entry->archive, ec);
+			if (ec) {
+				return std::nullopt;
+			}
+			return Stamp{ entry->size, writeTime.time_since_epoch().count() };
+		}
+
+		std::error_code ec;
+		const auto      fileSize = std::filesystem::file_size(a_video, ec);
+		if (ec) {
+			return std::nullopt;
+		}
+		const auto writeTime = std::filesystem::last_write_time(a_video, ec);
+		if (ec) {
+			return std::nullopt;
+		}
+		return Stamp{ fileSize, writeTime.time_since_epoch().count() };
+	}
+}
@@ -0,0 +1,11 @@
+#pragma once
+
+#include "CacheEntry.h"
+
+// Per-video files derived from the source (poster frames etc.), kept next to the plugin log.
+namespace Cache
+{
+	std::optional<std::filesystem::path> GetDirectory();
+	std::optional<std::filesystem::path> GetPath(const std::string& a_video, std::string_view a_extension);
+	std::optional<Stamp>                 GetStamp(const std::string& a_video);
+}
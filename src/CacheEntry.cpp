@@ -0,0 +1,70 @@
+#include "CacheEntry.h"
+
+namespace Cache
+{
+	bool Write(const std::filesystem::path& a_path, std::uint32_t a_magic, const Stamp& a_stamp, std::span<const std::uint8_t> a_payload)
+	{
+		auto tempPath = a_path;
+		tempPath += ".tmp"sv;
+
+		{
+			std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+			if (!file) {
+				return false;
+			}
+			file.write(reinterpret_cast<const char*>(&a_magic), sizeof(a_magic));
+			file.write(reinterpret_cast<const char*>(&a_stamp.fileSize), sizeof(a_stamp.fileSize));
+			file.write(reinterpret_cast<const char*>(&a_stamp.writeTime), sizeof(a_stamp.writeTime));
+			file.write(reinterpret_cast<const char*>(a_payload.data()), static_cast<std::streamsize>(a_payload.size()));
+			if (!file) {
+				return false;
+			}
+		}
+
+		std::error_code ec;
+		std::filesystem::rename(tempPath, a_path, ec);
+		if (ec) {
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+		return true;
+	}
+
+	std::optional<std::vector<std::uint8_t>> Read(const std::filesystem::path& a_path, std::uint32_t a_magic, const Stamp& a_stamp)
+	{
+		std::ifstream file(a_path, std::ios::binary | std::ios::ate);
+		if (!file) {
+			return std::nullopt;
+		}
+
+		constexpr std::streamoff headerSize = sizeof(std::uint32_t) + sizeof(Stamp::fileSize) + sizeof(Stamp::writeTime);
+
+		const std::streamoff size = file.tellg();
+		if (size < headerSize) {
+			return std::nullopt;
+		}
+		file.seekg(0);
+
+		std::uint32_t magic = 0;
+		Stamp         stamp{};
+		file.read(reinterpret_cast<char*>(&magic), sizeof(magic));
+		file.read(reinterpret_cast<char*>(&stamp.fileSize), sizeof(stamp.fileSize));
+		file.read(reinterpret_cast<char*>(&stamp.writeTime), sizeof(stamp.writeTime));
+
+		if (!file || magic != a_magic || stamp != a_stamp) {
+			// stale entry from an older copy of the video, drop it
+			file.close();
+			std::error_code ec;
+			std::filesystem::remove(a_path, ec);
+			return std::nullopt;
+		}
+
+		std::vector<std::uint8_t> payload(static_cast<std::size_t>(size - headerSize));
+		file.read(reinterpret_cast<char*>(payload.data()), static_cast<std::streamsize>(payload.size()));
+		if (!file) {
+			return std::nullopt;
+		}
+
+		return payload;
+	}
+}
@@ -0,0 +1,18 @@
+#pragma once
+
+// The file a cache entry is kept in. No dependencies beyond the standard library; shared with tests/.
+namespace Cache
+{
+	// identifies the exact source file a cache entry was built from
+	struct Stamp
+	{
+		bool operator==(const Stamp&) const = default;
+
+		std::uint64_t fileSize{ 0 };
+		std::int64_t  writeTime{ 0 };
+	};
+
+	// <magic><stamp><payload>, written to a temp file first so a crash never leaves a half written entry behind
+	bool                                     Write(const std::filesystem::path& a_path, std::uint32_t a_magic, const Stamp& a_stamp, std::span<const std::uint8_t> a_payload);
+	std::optional<std::vector<std::uint8_t>> Read(const std::filesystem::path& a_path, std::uint32_t a_magic, const Stamp& a_stamp);
+}
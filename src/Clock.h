@@ -0,0 +1,50 @@
+#pragma once
+
+// Time source for the playback loop, so it can run against virtual time instead of the wall clock.
+class Clock
+{
+public:
+	using duration = std::chrono::duration<double>;
+	using time_point = std::chrono::time_point<std::chrono::steady_clock, duration>;
+
+	virtual ~Clock() = default;
+
+	virtual time_point now() const = 0;
+	virtual void       sleep_for(duration a_duration) = 0;
+};
+
+class SteadyClock final : public Clock
+{
+public:
+	time_point now() const override
+	{
+		return std::chrono::steady_clock::now();
+	}
+
+	void sleep_for(duration a_duration) override
+	{
+		std::this_thread::sleep_for(a_duration);
+	}
+};
+
+// Time only moves when the player sleeps, so playback runs as fast as frames can be decoded.
+class VirtualClock final : public Clock
+{
+public:
+	time_point now() const override
+	{
+		return time_point(duration(seconds.load(std::memory_order_relaxed)));
+	}
+
+	void sleep_for(duration a_duration) override
+	{
+		if (a_duration.count() > 0.0) {
+			double expected = seconds.load(std::memory_order_relaxed);
+			while (!seconds.compare_exchange_weak(expected, expected + a_duration.count(), std::memory_order_relaxed)) {}
+		}
+	}
+
+private:
+	// members
+	std::atomic<double> seconds{ 0.0 };
+};
@@ -0,0 +1,121 @@
+#include "ConvertStage.h"
+
+#include "B5G6R5.h"
+
+ConvertStage::ConvertStage(bool a_pipelined, std::uint32_t a_stripeThreads, Output a_output, Publish a_publish) :
+	publish(std::move(a_publish)),
+	outputFormat(a_output),
+	stripes(a_stripeThreads)
+{
+	if (a_pipelined) {
+		thread = std::jthread([this](std::stop_token st) {
+			SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+			Run(st);
+		});
+	}
+}
+
+bool ConvertStage::Submit(const cv::Mat& a_frame, bool a_convert, std::stop_token a_st)
+{
+	if (!thread.joinable()) {
+		input = a_frame;
+		convert = a_convert;
+		Process();
+		return true;
+	}
+
+	const auto waitStart = std::chrono::steady_clock::now();
+	{
+		Locker locker(lock);
+		if (!stateCV.wait(locker, a_st, [this] { return !pending; })) {
+			return false;
+		}
+		input = a_frame;
+		convert = a_convert;
+		pending = true;
+	}
+	stateCV.notify_all();
+	stalledNanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - waitStart).count(), std::memory_order_relaxed);
+
+	return true;
+}
+
+void ConvertStage::Drain()
+{
+	Locker locker(lock);
+	stateCV.wait(locker, [this] { return !pending; });
+}
+
+std::uint32_t ConvertStage::GetStripeThreadCount() const
+{
+	return stripes.GetThreadCount();
+}
+
+ConvertStage::Stats ConvertStage::TakeStats()
+{
+	return {
+		.busy = std::chrono::nanoseconds(busyNanoseconds.exchange(0, std::memory_order_relaxed)),
+		.stalled = std::chrono::nanoseconds(stalledNanoseconds.exchange(0, std::memory_order_relaxed)),
+		.frames = processedFrames.exchange(0, std::memory_order_relaxed)
+	};
+}
+
+void ConvertStage::Process()
+{
+	const auto startTime = std::chrono::steady_clock::now();
+
+	const bool packed = outputFormat == Output::kB5G6R5 || outputFormat == Output::kB5G6R5Dithered;
+	const bool dither = outputFormat == Output::kB5G6R5Dithered;
+	const bool highBitDepth = input.depth() == CV_16U;
+
+	// BGRA frames are already in the output format unless it's packed, 16-bit ones unless there's no 10-bit texture
+	if (convert && highBitDepth && outputFormat != Output::kR10G10B10A2) {
+		input.convertTo(output, CV_8U, 1.0 / 257.0);
+	} else if (convert && !highBitDepth && (packed || input.channels() == 3)) {
+		const auto convertRows = [&](const cv::Mat& a_src, cv::Mat& a_dst, int a_firstRow) {
+			if (packed) {
+				B5G6R5::Pack(a_src, a_dst, dither, a_firstRow);
+			} else {
+				cv::cvtColor(a_src, a_dst, cv::COLOR_BGR2BGRA);
+			}
+		};
+
+		output.create(input.rows, input.cols, packed ? CV_16UC1 : CV_8UC4);
+		if (input.total() >= stripeMinPixels && stripes.GetThreadCount() > 0) {
+			stripes.Run(input.rows, minStripeRows, [&](int a_begin, int a_end) {
+				cv::Mat stripe = output.rowRange(a_begin, a_end);
+				convertRows(input.rowRange(a_begin, a_end), stripe, a_begin);
+			});
+		} else {
+			convertRows(input, output, 0);
+		}
+	} else {
+		output = input;
+	}
+	input.release();
+
+	publish(output);
+
+	busyNanoseconds.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count(), std::memory_order_relaxed);
+	processedFrames.fetch_add(1, std::memory_order_relaxed);
+}
+
+void ConvertStage::Run(std::stop_token a_st)
+{
+	while (true) {
+		{
+			Locker locker(lock);
+			if (!stateCV.wait(locker, a_st, [this] { return pending; })) {
+				return;
+			}
+		}
+
+		Process();
+
+		{
+			Locker locker(lock);
+			pending = false;
+		}
+		stateCV.notify_all();
+	}
+}
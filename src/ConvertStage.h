@@ -0,0 +1,70 @@
+#pragma once
+
+#include "StripePool.h"
+
+// Colour conversion and publishing as a pipeline stage of its own: the decode thread hands a frame over and goes on to
+// decode the next one while this converts it. Large frames are converted in stripes on a StripePool.
+class ConvertStage
+{
+public:
+	// gets the converted frame and may swap it out, the stage reuses whatever it's left with
+	using Publish = std::function<void(cv::Mat&)>;
+
+	enum class Output
+	{
+		kBGRA,
+		kB5G6R5,
+		kB5G6R5Dithered,
+		kR10G10B10A2  // 16-bit BGRA goes through as-is, the texture packs it as it uploads
+	};
+
+	struct Stats
+	{
+		std::chrono::nanoseconds busy{ 0 };     // converting and publishing
+		std::chrono::nanoseconds stalled{ 0 };  // Submit waiting for the previous frame to be published
+		std::uint32_t            frames{ 0 };
+	};
+
+	// not pipelined converts and publishes on the submitting thread
+	ConvertStage(bool a_pipelined, std::uint32_t a_stripeThreads, Output a_output, Publish a_publish);
+	ConvertStage(const ConvertStage&) = delete;
+	~ConvertStage() = default;
+
+	ConvertStage& operator=(const ConvertStage&) = delete;
+
+	// waits until the previous frame is published, then hands a_frame over. The stage only reads it, but keeps reading
+	// after this returns, so the caller mustn't decode into the same buffer. a_convert turns BGR or BGRA (8 or 16-bit)
+	// into the output format, otherwise the frame is published as-is. false if a_st stopped the wait
+	bool Submit(const cv::Mat& a_frame, bool a_convert, std::stop_token a_st);
+	// waits until everything submitted so far is published
+	void Drain();
+
+	std::uint32_t GetStripeThreadCount() const;
+	Stats         TakeStats();
+
+private:
+	using Lock = std::mutex;
+	using Locker = std::unique_lock<Lock>;
+
+	void Process();
+	void Run(std::stop_token a_st);
+
+	// members
+	Publish                     publish;
+	Output                      outputFormat;
+	StripePool                  stripes;
+	cv::Mat                     input;
+	cv::Mat                     output;
+	bool                        convert{ false };
+	bool                        pending{ false };  // input is waiting for or going through the stage
+	Lock                        lock;
+	std::condition_variable_any stateCV;
+	std::atomic<std::int64_t>   busyNanoseconds{ 0 };
+	std::atomic<std::int64_t>   stalledNanoseconds{ 0 };
+	std::atomic<std::uint32_t>  processedFrames{ 0 };
+	std::jthread                thread;  // last, so it stops before anything it uses is destroyed
+
+	// below this a frame converts faster than the helpers wake up
+	static constexpr std::size_t stripeMinPixels{ 1280 * 720 };
+	static constexpr int         minStripeRows{ 64 };
+};
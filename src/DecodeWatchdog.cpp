@@ -0,0 +1,61 @@
+#include "DecodeWatchdog.h"
+
+void DecodeWatchdog::LoadSettings(CSimpleIniA& a_ini)
+{
+	ini::get_value(a_ini, enabled, "Watchdog", "bEnable", ";Switch a video to software decoding when the hardware decoder stalls (remembered for later sessions)");
+	ini::get_value(a_ini, missFactor, "Watchdog", "fMissFactor", ";A read slower than this many frame durations counts as a miss");
+	ini::get_value(a_ini, maxMisses, "Watchdog", "iMaxMisses", ";Misses (net of on-time reads) before falling back to software decoding");
+	ini::get_value(a_ini, hangSeconds, "Watchdog", "fHangSeconds", ";A single read taking longer than this is reported as a hang");
+
+	maxMisses = std::max(maxMisses, 1u);
+}
+
+void DecodeWatchdog::Start(duration a_frameBudget)
+{
+	frameBudget = a_frameBudget;
+	warmedUp.store(false, std::memory_order_relaxed);
+	readStart.store(0.0, std::memory_order_relaxed);
+	misses.store(0, std::memory_order_relaxed);
+}
+
+void DecodeWatchdog::BeginRead(time_point a_now)
+{
+	readStart.store(a_now.time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+bool DecodeWatchdog::EndRead(time_point a_now)
+{
+	const auto latency = a_now.time_since_epoch().count() - readStart.exchange(0.0, std::memory_order_relaxed);
+	if (!enabled || !warmedUp.exchange(true, std::memory_order_relaxed)) {
+		return false;
+	}
+
+	// on-time reads pay misses back, so only a sustained slowdown gets through
+	auto count = misses.load(std::memory_order_relaxed);
+	if (latency > frameBudget.count() * missFactor) {
+		count++;
+	} else if (count > 0) {
+		count--;
+	}
+	misses.store(count, std::memory_order_relaxed);
+
+	return count >= maxMisses;
+}
+
+bool DecodeWatchdog::IsHung(time_point a_now) const
+{
+	// decoder setup and a cold disk can stretch the first read well past a normal one, and a hang found here is remembered for good
+	const auto start = readStart.load(std::memory_order_relaxed);
+	const auto threshold = warmedUp.load(std::memory_order_relaxed) ? hangSeconds : hangSeconds * setupAllowance;
+	return enabled && start != 0.0 && a_now.time_since_epoch().count() - start > threshold;
+}
+
+bool DecodeWatchdog::IsEnabled() const
+{
+	return enabled;
+}
+
+std::uint32_t DecodeWatchdog::GetMisses() const
+{
+	return misses.load(std::memory_order_relaxed);
+}
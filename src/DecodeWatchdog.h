@@ -0,0 +1,39 @@
+#pragma once
+
+#include "Clock.h"
+
+// Times every decoder read against the frame budget. A run of slow reads asks for a fallback decoder,
+// a read that doesn't come back at all is reported as a hang (it can only be noticed from another thread).
+class DecodeWatchdog
+{
+public:
+	using duration = Clock::duration;
+	using time_point = Clock::time_point;
+
+	void LoadSettings(CSimpleIniA& a_ini);
+
+	void Start(duration a_frameBudget);
+
+	// around each read on the decode thread, EndRead returns true once the decoder should be replaced
+	void BeginRead(time_point a_now);
+	bool EndRead(time_point a_now);
+
+	// from any thread, true while the current read has been running longer than the hang threshold
+	bool IsHung(time_point a_now) const;
+
+	bool          IsEnabled() const;
+	std::uint32_t GetMisses() const;
+
+private:
+	// members
+	bool                       enabled{ true };
+	float                      missFactor{ 2.0f };
+	std::uint32_t              maxMisses{ 15 };
+	float                      hangSeconds{ 1.0f };
+	duration                   frameBudget{ 0.0 };
+	std::atomic<bool>          warmedUp{ false };  // the first read after opening includes decoder setup
+	std::atomic<double>        readStart{ 0.0 };   // seconds since the clock's epoch, 0 = not reading
+	std::atomic<std::uint32_t> misses{ 0 };
+
+	static constexpr float setupAllowance{ 10.0f };  // x hangSeconds, for the first read
+};
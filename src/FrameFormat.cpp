@@ -0,0 +1,40 @@
+#include "FrameFormat.h"
+
+#include "B5G6R5.h"
+#include "BC1.h"
+
+namespace FrameFormat
+{
+	bool ToBGRA8(const cv::Mat& a_frame, std::uint32_t a_width, std::uint32_t a_height, cv::Mat& a_bgra)
+	{
+		// block rows are a quarter of the frame's and 8 bytes per 4 pixels, they can't be taken for pixels
+		if (a_frame.type() == CV_8UC1) {
+			if (a_frame.rows != static_cast<int>(BC1::GetBlockCount(a_height)) || a_frame.cols != static_cast<int>(BC1::GetBlockCount(a_width) * BC1::blockBytes)) {
+				return false;
+			}
+			BC1::Decode(a_frame, a_width, a_height, a_bgra);
+			return true;
+		}
+
+		if (a_frame.cols != static_cast<int>(a_width) || a_frame.rows != static_cast<int>(a_height)) {
+			return false;
+		}
+		switch (a_frame.type()) {
+		case CV_16UC1:
+			B5G6R5::Unpack(a_frame, a_bgra);
+			break;
+		case CV_16UC4:
+			a_frame.convertTo(a_bgra, CV_8U, 1.0 / 257.0);
+			break;
+		case CV_8UC3:
+			cv::cvtColor(a_frame, a_bgra, cv::COLOR_BGR2BGRA);
+			break;
+		case CV_8UC4:
+			a_frame.copyTo(a_bgra);
+			break;
+		default:
+			return false;
+		}
+		return true;
+	}
+}
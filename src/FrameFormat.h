@@ -0,0 +1,9 @@
+#pragma once
+
+// Frames as the player keeps them, in whatever format the texture takes, back to plain 8-bit BGRA for posters and bakes.
+namespace FrameFormat
+{
+	// a_frame is BGR(A), 16-bit BGRA, B5G6R5 (CV_16UC1) or BC1 blocks (CV_8UC1, see BC1.h) of an a_width x a_height frame.
+	// false if it's none of those, or its size doesn't match
+	bool ToBGRA8(const cv::Mat& a_frame, std::uint32_t a_width, std::uint32_t a_height, cv::Mat& a_bgra);
+}
@@ -0,0 +1,65 @@
+#include "FrameHash.h"
+
+namespace FrameHash
+{
+	namespace detail
+	{
+		constexpr std::int32_t  sampledRows{ 32 };
+		constexpr std::uint64_t prime{ 0x9E3779B97F4A7C15 };
+
+		// four independent lanes keep the multiplies pipelined, a single chain would wait on each one
+		std::uint64_t hash_row(const std::uint8_t* a_data, std::size_t a_bytes, std::uint64_t a_seed)
+		{
+			std::array<std::uint64_t, 4> lanes{ a_seed, a_seed + 1, a_seed + 2, a_seed + 3 };
+
+			std::size_t i = 0;
+			for (; i + 32 <= a_bytes; i += 32) {
+				for (std::size_t lane = 0; lane < lanes.size(); ++lane) {
+					std::uint64_t word;
+					std::memcpy(&word, a_data + i + lane * 8, sizeof(word));
+					lanes[lane] = (lanes[lane] ^ word) * prime;
+				}
+			}
+
+			auto hash = lanes[0] ^ std::rotl(lanes[1], 16) ^ std::rotl(lanes[2], 32) ^ std::rotl(lanes[3], 48);
+			for (; i < a_bytes; ++i) {
+				hash = (hash ^ a_data[i]) * prime;
+			}
+			return hash;
+		}
+	}
+
+	std::uint64_t Fingerprint(const cv::Mat& a_frame)
+	{
+		if (a_frame.empty()) {
+			return 0;
+		}
+
+		const auto rowBytes = a_frame.cols * a_frame.elemSize();
+		const auto rows = std::min(a_frame.rows, detail::sampledRows);
+
+		// spread over the whole frame, a change that falls between sampled rows is still caught by Equal
+		auto hash = (std::uint64_t(a_frame.cols) << 32 | std::uint64_t(a_frame.rows)) ^ std::uint64_t(a_frame.type());
+		for (std::int32_t i = 0; i < rows; ++i) {
+			const auto y = (2 * i + 1) * a_frame.rows / (2 * rows);
+			hash = detail::hash_row(a_frame.ptr<std::uint8_t>(y), rowBytes, hash);
+		}
+		return hash;
+	}
+
+	bool Equal(const cv::Mat& a_lhs, const cv::Mat& a_rhs)
+	{
+		if (a_lhs.empty() || a_lhs.size() != a_rhs.size() || a_lhs.type() != a_rhs.type()) {
+			return false;
+		}
+
+		// memcmp is vectorised and stops at the first difference
+		const auto rowBytes = a_lhs.cols * a_lhs.elemSize();
+		for (std::int32_t y = 0; y < a_lhs.rows; ++y) {
+			if (std::memcmp(a_lhs.ptr(y), a_rhs.ptr(y), rowBytes) != 0) {
+				return false;
+			}
+		}
+		return true;
+	}
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+// Change detection between consecutive decoded frames.
+// The fingerprint only reads a spread of rows, which rules out most changed frames cheaply; Equal confirms a match byte for byte.
+namespace FrameHash
+{
+	std::uint64_t Fingerprint(const cv::Mat& a_frame);
+	bool          Equal(const cv::Mat& a_lhs, const cv::Mat& a_rhs);
+}
@@ -0,0 +1,62 @@
+#include "FrameTimeline.h"
+
+FrameTimeline::FrameTimeline(duration a_frameDuration, bool a_useTimestamps, duration a_start) :
+	frameDuration(a_frameDuration),
+	useTimestamps(a_useTimestamps),
+	start(a_start)
+{}
+
+void FrameTimeline::Restart(duration a_position)
+{
+	start = a_position;
+	lastTimestamp = duration(-1.0);
+	timestampedFrames = 0;
+}
+
+FrameTimeline::duration FrameTimeline::GetTimestamp(std::optional<duration> a_reported) const
+{
+	if (useTimestamps && a_reported) {
+		return *a_reported;
+	}
+	return lastTimestamp < duration(0.0) ? start : lastTimestamp + frameDuration;
+}
+
+FrameTimeline::Verdict FrameTimeline::Add(duration a_timestamp)
+{
+	auto verdict = Verdict::kPresent;
+	if (lastTimestamp >= duration(0.0)) {
+		const auto delta = a_timestamp - lastTimestamp;
+		if (delta <= duration(0.0)) {
+			// a repeated timestamp would be on screen for no time at all
+			duplicateFrames++;
+			if (++consecutiveDuplicates >= maxDuplicateFrames && useTimestamps) {
+				useTimestamps = false;
+				return Verdict::kTimestampsLost;
+			}
+			return Verdict::kDuplicate;
+		}
+		consecutiveDuplicates = 0;
+		// a quarter is well clear of millisecond rounding, and still catches a 30 FPS video switching to 60
+		if (std::abs((delta - frameDuration).count()) > frameDuration.count() * irregularTolerance && !std::exchange(variable, true)) {
+			verdict = Verdict::kFirstIrregular;
+		}
+	} else {
+		firstTimestamp = a_timestamp;
+	}
+	lastTimestamp = a_timestamp;
+	timestampedFrames++;
+	return verdict;
+}
+
+float FrameTimeline::GetContentFPS() const
+{
+	if (timestampedFrames < 2 || lastTimestamp <= firstTimestamp) {
+		return 0.0f;
+	}
+	return static_cast<float>((timestampedFrames - 1) / (lastTimestamp - firstTimestamp).count());
+}
+
+std::uint32_t FrameTimeline::TakeDuplicates()
+{
+	return std::exchange(duplicateFrames, 0);
+}
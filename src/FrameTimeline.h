@@ -0,0 +1,51 @@
+#pragma once
+
+#include "Clock.h"
+
+// When each decoded frame is due on the media timeline, from its own presentation timestamp so variable frame rate
+// videos keep their timing. Gaps are held longer, repeated or backwards timestamps are dropped, and a backend that keeps
+// repeating them is assumed not to report any, so frames fall back to nominal spacing.
+// No dependencies beyond the standard library; shared with tests/.
+class FrameTimeline
+{
+public:
+	using duration = Clock::duration;
+
+	enum class Verdict
+	{
+		kPresent,
+		kFirstIrregular,  // present, the first interval that wasn't nominal
+		kDuplicate,       // drop
+		kTimestampsLost   // drop, frames use nominal spacing from here on
+	};
+
+	FrameTimeline(duration a_frameDuration, bool a_useTimestamps, duration a_start);
+
+	// the next frame is expected at a_position, after a seek or a loop restart
+	void Restart(duration a_position);
+
+	// a_reported is the backend's timestamp for the frame just decoded, if it has one
+	duration GetTimestamp(std::optional<duration> a_reported) const;
+	Verdict  Add(duration a_timestamp);
+
+	bool          UsesTimestamps() const { return useTimestamps; }
+	bool          IsVariable() const { return variable; }
+	duration      GetLastTimestamp() const { return lastTimestamp; }  // negative before the first frame
+	float         GetContentFPS() const;                              // 0 until two frames have been added
+	std::uint32_t TakeDuplicates();                                   // dropped since the last call
+
+private:
+	// members
+	duration      frameDuration;
+	bool          useTimestamps;
+	bool          variable{ false };
+	duration      start;  // where the next frame should be, until it says otherwise
+	duration      lastTimestamp{ -1.0 };
+	duration      firstTimestamp{ -1.0 };
+	std::uint32_t timestampedFrames{ 0 };
+	std::uint32_t duplicateFrames{ 0 };
+	std::uint32_t consecutiveDuplicates{ 0 };
+
+	static constexpr std::uint32_t maxDuplicateFrames{ 8 };     // in a row before timestamps are considered broken
+	static constexpr double        irregularTolerance{ 0.25 };  // x frameDuration an interval may be off by
+};
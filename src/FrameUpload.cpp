@@ -0,0 +1,39 @@
+#include "FrameUpload.h"
+
+#include "Blend.h"
+#include "R10G10B10A2.h"
+
+namespace FrameUpload
+{
+	std::size_t WriteRows(const cv::Mat& a_frame, void* a_dst, std::uint32_t a_rowPitch)
+	{
+		auto* dst = static_cast<std::uint8_t*>(a_dst);
+
+		if (a_frame.type() == CV_16UC4) {
+			for (std::int32_t y = 0; y < a_frame.rows; ++y) {
+				R10G10B10A2::PackRow(a_frame.ptr<std::uint16_t>(y), reinterpret_cast<std::uint32_t*>(dst + std::size_t(y) * a_rowPitch), static_cast<std::uint32_t>(a_frame.cols));
+			}
+			return a_frame.total() * 4;
+		}
+
+		const auto srcRowBytes = static_cast<std::uint32_t>(a_frame.cols * a_frame.elemSize());
+		if (a_rowPitch == srcRowBytes && a_frame.isContinuous()) {
+			std::memcpy(dst, a_frame.data, std::size_t(a_frame.rows) * srcRowBytes);
+		} else {
+			for (std::int32_t y = 0; y < a_frame.rows; ++y) {
+				std::memcpy(dst + std::size_t(y) * a_rowPitch, a_frame.ptr<std::uint8_t>(y), srcRowBytes);
+			}
+		}
+		return std::size_t(a_frame.rows) * srcRowBytes;
+	}
+
+	std::size_t WriteBlendedRows(const cv::Mat& a_from, const cv::Mat& a_to, std::uint32_t a_weight, void* a_dst, std::uint32_t a_rowPitch)
+	{
+		auto*      dst = static_cast<std::uint8_t*>(a_dst);
+		const auto rowBytes = static_cast<std::size_t>(a_to.cols) * a_to.elemSize();
+		for (std::int32_t y = 0; y < a_to.rows; ++y) {
+			Blend::LerpRow(a_from.ptr<std::uint8_t>(y), a_to.ptr<std::uint8_t>(y), dst + std::size_t(y) * a_rowPitch, rowBytes, a_weight);
+		}
+		return std::size_t(a_to.rows) * rowBytes;
+	}
+}
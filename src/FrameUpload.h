@@ -0,0 +1,13 @@
+#pragma once
+
+// The CPU half of a texture update, frame rows into mapped memory whose rows can be further apart than the frame's.
+// Kept apart from the D3D calls so tools/Benchmark can time it without a GPU.
+namespace FrameUpload
+{
+	// one frame row per texture row (or per row of blocks for compressed formats). 16-bit BGRA frames are packed to
+	// R10G10B10A2 on the way, a separate packing pass would write and read every pixel once more; returns the bytes written
+	std::size_t WriteRows(const cv::Mat& a_frame, void* a_dst, std::uint32_t a_rowPitch);
+
+	// two BGRA frames of the same size mixed on the way (Blend::LerpRow), so blending costs no pass of its own
+	std::size_t WriteBlendedRows(const cv::Mat& a_from, const cv::Mat& a_to, std::uint32_t a_weight, void* a_dst, std::uint32_t a_rowPitch);
+}
@@ -0,0 +1,222 @@
+#include "History.h"
+
+namespace History
+{
+	namespace detail
+	{
+		constexpr std::string_view header{ "# MainMenuVideo play history v1"sv };
+		constexpr std::string_view columns{ "# plays\tskips\ttarget fps\tachieved fps\tdecode ms p95\tdrop rate\tfirst pixel ms\tvideo"sv };
+		constexpr std::size_t      fieldCount{ 7 };
+
+		constexpr float recentWeight{ 0.33f };  // of each play after the first
+
+		std::string to_key(std::string_view a_video)
+		{
+			std::string key(a_video);
+			std::ranges::transform(key, key.begin(), [](char a_char) { return static_cast<char>(std::tolower(static_cast<unsigned char>(a_char))); });
+			return key;
+		}
+
+		template <class T>
+		bool parse_field(std::string_view a_field, T& a_value)
+		{
+			const auto [ptr, ec] = std::from_chars(a_field.data(), a_field.data() + a_field.size(), a_value);
+			return ec == std::errc() && ptr == a_field.data() + a_field.size();
+		}
+
+		// "plays\tskips\t...\tvideo", the path last since it's the only field that can hold anything
+		std::optional<std::pair<std::string, Record>> parse_line(std::string_view a_line)
+		{
+			std::array<std::string_view, fieldCount> fields;
+			for (auto& field : fields) {
+				const auto tab = a_line.find('\t');
+				if (tab == std::string_view::npos) {
+					return std::nullopt;
+				}
+				field = a_line.substr(0, tab);
+				a_line.remove_prefix(tab + 1);
+			}
+
+			Record record;
+			if (a_line.empty() ||
+				!parse_field(fields[0], record.plays) ||
+				!parse_field(fields[1], record.skips) ||
+				!parse_field(fields[2], record.targetFPS) ||
+				!parse_field(fields[3], record.achievedFPS) ||
+				!parse_field(fields[4], record.decodeTime) ||
+				!parse_field(fields[5], record.dropRate) ||
+				!parse_field(fields[6], record.firstPixelTime)) {
+				return std::nullopt;
+			}
+			return std::make_pair(to_key(a_line), record);
+		}
+	}
+
+	void Record::Add(const Session& a_session)
+	{
+		const auto dueFrames = a_session.frames + a_session.droppedFrames;
+		const auto sessionDropRate = dueFrames > 0 ? static_cast<float>(a_session.droppedFrames) / static_cast<float>(dueFrames) : 0.0f;
+
+		// the first play sets the record outright
+		const auto weight = plays == 0 ? 1.0f : detail::recentWeight;
+		const auto blend = [weight](float& a_value, float a_sample) {
+			a_value += (a_sample - a_value) * weight;
+		};
+		blend(targetFPS, a_session.targetFPS);
+		blend(achievedFPS, a_session.achievedFPS);
+		blend(decodeTime, a_session.decodeTime);
+		blend(dropRate, sessionDropRate);
+
+		// loops have no first pixel to measure, only loads do
+		if (a_session.firstPixelTime > 0.0f) {
+			firstPixelTime = firstPixelTime > 0.0f ? firstPixelTime + (a_session.firstPixelTime - firstPixelTime) * detail::recentWeight : a_session.firstPixelTime;
+		}
+
+		plays++;
+		skips = 0;
+	}
+
+	Verdict Assess(const Record& a_record, const Policy& a_policy)
+	{
+		if (a_record.plays < a_policy.minPlays || a_record.targetFPS <= 0.0f) {
+			return Verdict::kPlay;
+		}
+		// a video that isn't played can't show it got better (new drivers, lighter settings), so it gets another go now and then
+		if (a_policy.retryAfter > 0 && a_record.skips >= a_policy.retryAfter) {
+			return Verdict::kPlay;
+		}
+
+		const auto fpsRatio = a_record.achievedFPS / a_record.targetFPS;
+		if (fpsRatio < a_policy.skipFPSRatio || (a_policy.maxFirstPixelTime > 0.0f && a_record.firstPixelTime > a_policy.maxFirstPixelTime)) {
+			return Verdict::kSkip;
+		}
+
+		// a decoder that often takes longer than a frame falls behind however the rest of the pipeline does
+		const bool decodeBound = a_record.decodeTime > 1000.0f / a_record.targetFPS;
+		if (fpsRatio < a_policy.minFPSRatio || a_record.dropRate > a_policy.maxDropRate || decodeBound) {
+			return Verdict::kDownscale;
+		}
+		return Verdict::kPlay;
+	}
+
+	std::string_view GetName(Verdict a_verdict)
+	{
+		switch (a_verdict) {
+		case Verdict::kPlay:
+			return "play"sv;
+		case Verdict::kDownscale:
+			return "downscale"sv;
+		case Verdict::kSkip:
+			return "skip"sv;
+		default:
+			return "unknown"sv;
+		}
+	}
+
+	float Percentile(std::vector<float>& a_samples, float a_fraction)
+	{
+		if (a_samples.empty()) {
+			return 0.0f;
+		}
+		const auto index = std::min(static_cast<std::size_t>(static_cast<float>(a_samples.size()) * a_fraction), a_samples.size() - 1);
+		const auto nth = a_samples.begin() + static_cast<std::ptrdiff_t>(index);
+		std::ranges::nth_element(a_samples, nth);
+		return *nth;
+	}
+
+	bool Store::Load(const std::filesystem::path& a_path)
+	{
+		std::scoped_lock locker(lock);
+		path = a_path;
+		records.clear();
+
+		std::ifstream file(a_path);
+		std::string   line;
+		if (!file || !std::getline(file, line) || line != detail::header) {
+			return false;  // first run, or another version's file that the next save replaces
+		}
+
+		while (std::getline(file, line)) {
+			if (line.empty() || line.front() == '#') {
+				continue;
+			}
+			if (auto entry = detail::parse_line(line)) {
+				records.insert_or_assign(std::move(entry->first), entry->second);
+			}
+		}
+		return true;
+	}
+
+	bool Store::Save() const
+	{
+		std::scoped_lock locker(lock);
+		if (path.empty()) {
+			return false;
+		}
+
+		// written aside and swapped in, so a crash mid-save keeps the previous history
+		auto tempPath = path;
+		tempPath += ".tmp"sv;
+		{
+			std::ofstream file(tempPath, std::ios::trunc);
+			if (!file) {
+				return false;
+			}
+			file << detail::header << '\n'
+				 << detail::columns << '\n';
+
+			char fields[160];
+			for (const auto& [video, record] : records) {
+				std::snprintf(fields, sizeof(fields), "%u\t%u\t%.3f\t%.3f\t%.3f\t%.4f\t%.1f\t",
+					record.plays, record.skips, record.targetFPS, record.achievedFPS, record.decodeTime, record.dropRate, record.firstPixelTime);
+				file << fields << video << '\n';
+			}
+			if (!file) {
+				return false;
+			}
+		}
+
+		std::error_code ec;
+		std::filesystem::rename(tempPath, path, ec);
+		if (ec) {
+			std::filesystem::remove(tempPath, ec);
+			return false;
+		}
+		return true;
+	}
+
+	std::optional<Record> Store::Find(std::string_view a_video) const
+	{
+		std::scoped_lock locker(lock);
+		if (const auto it = records.find(detail::to_key(a_video)); it != records.end()) {
+			return it->second;
+		}
+		return std::nullopt;
+	}
+
+	bool Store::Add(std::string_view a_video, const Session& a_session)
+	{
+		const auto seconds = a_session.targetFPS > 0.0f ? static_cast<float>(a_session.frames + a_session.droppedFrames) / a_session.targetFPS : 0.0f;
+		if (seconds < minSessionSeconds) {
+			return false;
+		}
+
+		std::scoped_lock locker(lock);
+		records[detail::to_key(a_video)].Add(a_session);
+		return true;
+	}
+
+	void Store::Skip(std::string_view a_video)
+	{
+		std::scoped_lock locker(lock);
+		if (const auto it = records.find(detail::to_key(a_video)); it != records.end()) {
+			it->second.skips++;
+		}
+	}
+
+	std::vector<std::pair<std::string, Record>> Store::GetRecords() const
+	{
+		std::scoped_lock locker(lock);
+		return { records.begin(), records.end() };
+	}
+}
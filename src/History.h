@@ -0,0 +1,77 @@
+#pragma once
+
+// How each video has played on this machine, kept across launches so the playlist can steer around the ones it can't keep up with.
+// No dependencies beyond the standard library; shared with tools/HistoryReader.
+namespace History
+{
+	// one playthrough, from the load or a loop's start to the end of the loop or teardown
+	struct Session
+	{
+		float         targetFPS{ 0.0f };
+		float         achievedFPS{ 0.0f };
+		float         decodeTime{ 0.0f };      // ms, 95th percentile
+		std::uint32_t frames{ 0 };             // presented
+		std::uint32_t droppedFrames{ 0 };      // skipped by adaptive quality, or handed on more than a frame late
+		float         firstPixelTime{ 0.0f };  // ms from the load to the first frame on screen, 0 for loops
+	};
+
+	// averages over past plays, recent ones weighted more so a driver update or a re-encode shows within a few boots
+	struct Record
+	{
+		void Add(const Session& a_session);
+
+		std::uint32_t plays{ 0 };
+		std::uint32_t skips{ 0 };  // since the last play
+		float         targetFPS{ 0.0f };
+		float         achievedFPS{ 0.0f };
+		float         decodeTime{ 0.0f };
+		float         dropRate{ 0.0f };  // of the frames that were due
+		float         firstPixelTime{ 0.0f };
+	};
+
+	enum class Verdict
+	{
+		kPlay,
+		kDownscale,  // falling behind, a smaller variant should be tried
+		kSkip        // too far behind to be worth playing
+	};
+
+	struct Policy
+	{
+		std::uint32_t minPlays{ 2 };              // before a record is trusted
+		float         minFPSRatio{ 0.9f };        // achieved / target below this is falling behind
+		float         maxDropRate{ 0.05f };
+		float         skipFPSRatio{ 0.6f };
+		float         maxFirstPixelTime{ 0.0f };  // ms, skip videos slower to show than this (0 - never)
+		std::uint32_t retryAfter{ 10 };           // skips before a video is given another chance
+	};
+
+	Verdict          Assess(const Record& a_record, const Policy& a_policy);
+	std::string_view GetName(Verdict a_verdict);
+
+	// reorders a_samples, 0 if there are none
+	float Percentile(std::vector<float>& a_samples, float a_fraction);
+
+	// sessions shorter than this say more about the player skipping ahead than about the machine
+	inline constexpr float minSessionSeconds{ 2.0f };
+
+	// keyed by the video's path, any case; reads come from the main thread and sessions from the video thread
+	class Store
+	{
+	public:
+		bool Load(const std::filesystem::path& a_path);
+		bool Save() const;
+
+		std::optional<Record> Find(std::string_view a_video) const;
+		bool                  Add(std::string_view a_video, const Session& a_session);
+		void                  Skip(std::string_view a_video);
+
+		std::vector<std::pair<std::string, Record>> GetRecords() const;
+
+	private:
+		// members
+		mutable std::mutex            lock;
+		std::filesystem::path         path;
+		std::map<std::string, Record> records;  // by lowercase path
+	};
+}
@@ -47,10 +47,15 @@ namespace ImGui::Renderer
 					return;
 				}
 
+				window = desc.OutputWindow;
+
 				logger::info("ImGui initialized.");
 				logger::info("{}", cv::getBuildInformation());
 
 				initialized.store(true);
+
+				// a video opened at kPostLoad only needed the device to be fully ready
+				Manager::GetSingleton()->OnDeviceReady(device);
 			}
 		}
 		static inline REL::Relocation<decltype(thunk)> func;
@@ -6,4 +6,5 @@ namespace ImGui::Renderer
 
 	// members
 	inline std::atomic initialized{ false };
+	inline HWND        window{ nullptr };
 }
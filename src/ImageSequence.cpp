@@ -0,0 +1,317 @@
+#include "ImageSequence.h"
+
+#include "QOI.h"
+
+namespace
+{
+	constexpr std::array frameExtensions{ ".png"sv, ".jpg"sv, ".jpeg"sv, ".qoi"sv };
+
+	// "frame_0012" -> 12, frames without a number sort after the numbered ones
+	std::uint64_t get_frame_number(const std::filesystem::path& a_path)
+	{
+		const auto stem = a_path.stem().string();
+		const auto end = stem.find_last_of("0123456789");
+		if (end == std::string::npos) {
+			return std::numeric_limits<std::uint64_t>::max();
+		}
+		auto begin = end;
+		while (begin > 0 && std::isdigit(static_cast<unsigned char>(stem[begin - 1]))) {
+			--begin;
+		}
+
+		std::uint64_t number = 0;
+		std::from_chars(stem.data() + begin, stem.data() + end + 1, number);
+		return number;
+	}
+}
+
+ImageSequence::~ImageSequence()
+{
+	Close();
+}
+
+bool ImageSequence::IsSequence(const std::filesystem::path& a_path)
+{
+	std::error_code ec;
+	return std::filesystem::is_directory(a_path, ec) && std::filesystem::is_regular_file(a_path / manifestName, ec);
+}
+
+void ImageSequence::LoadSettings(CSimpleIniA& a_ini)
+{
+	ini::get_value(a_ini, decodeThreads, "ImageSequence", "iDecodeThreads", ";Threads decoding image sequence frames ahead of playback (0 - all cores but one)");
+	ini::get_value(a_ini, lookahead, "ImageSequence", "iLookaheadFrames", ";Frames decoded ahead of playback");
+	ini::get_value(a_ini, highBitDepth, "ImageSequence", "bHighBitDepth", ";Play 16-bit PNG sequences at 10 bits per channel instead of reducing them to 8 (doubles their memory use while decoding)");
+
+	lookahead = std::max(lookahead, 1u);
+}
+
+bool ImageSequence::Open(const std::filesystem::path& a_folder, bool a_allowHighBitDepth)
+{
+	Close();
+
+	CSimpleIniA manifest;
+	manifest.SetUnicode();
+	if (manifest.LoadFile((a_folder / manifestName).c_str()) < 0) {
+		return false;
+	}
+	fps = static_cast<float>(manifest.GetDoubleValue("Sequence", "fFPS", 30.0));
+	if (const auto audio = manifest.GetValue("Sequence", "sAudio", ""); audio && *audio) {
+		audioPath = a_folder / std::filesystem::path(reinterpret_cast<const char8_t*>(audio));
+	}
+
+	std::error_code ec;
+	for (const auto& entry : std::filesystem::directory_iterator(a_folder, ec)) {
+		const auto ext = clib_util::string::tolower(entry.path().extension().string());
+		if (entry.is_regular_file(ec) && std::ranges::find(frameExtensions, ext) != frameExtensions.end()) {
+			frames.push_back(entry.path());
+		}
+	}
+	std::ranges::sort(frames, [](const auto& a_lhs, const auto& a_rhs) {
+		return std::pair(get_frame_number(a_lhs), a_lhs.filename()) < std::pair(get_frame_number(a_rhs), a_rhs.filename());
+	});
+
+	// every frame is decoded to the first one's size and depth, so it has to be read up front
+	cv::Mat first;
+	if (frames.empty() || fps <= 0.0f || !Decode(frames.front(), first, -1)) {
+		logger::warn("Image sequence {} has no readable frames", a_folder.string());
+		Close();
+		return false;
+	}
+	width = static_cast<std::uint32_t>(first.cols);
+	height = static_cast<std::uint32_t>(first.rows);
+	depth = highBitDepth && a_allowHighBitDepth && first.depth() == CV_16U ? CV_16U : CV_8U;
+	if (depth == CV_16U) {
+		logger::info("\tImage sequence has 16-bit frames, keeping 10 bits per channel");
+	}
+
+	// set before the first worker starts, the workers log it while the rest are still being started
+	threadCount = decodeThreads > 0 ? decodeThreads : std::max(std::thread::hardware_concurrency(), 2u) - 1;
+	openTime = std::chrono::steady_clock::now();
+	workers.reserve(threadCount);
+	for (std::uint32_t i = 0; i < threadCount; ++i) {
+		workers.emplace_back([this](std::stop_token st) {
+			SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+			DecodeFrames(st);
+		});
+	}
+
+	return true;
+}
+
+void ImageSequence::Close()
+{
+	for (auto& worker : workers) {
+		worker.request_stop();
+	}
+	workCV.notify_all();
+	workers.clear();
+	const auto workerCount = std::exchange(threadCount, 0);
+
+	const auto frameCount = decodedFrames.exchange(0, std::memory_order_relaxed);
+	const auto decodeTime = decodeNanoseconds.exchange(0, std::memory_order_relaxed) / 1e6;
+	if (frameCount > 0) {
+		const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - openTime).count();
+		logger::info("Image sequence: decoded {} frames at {:.1f} ms/frame on {} threads", frameCount, decodeTime / frameCount, workerCount);
+		logger::info("\t{:.1f} threads busy on average", decodeTime / 1000.0 / std::max(elapsed, 1e-6));
+	}
+
+	Locker locker(lock);
+	frames.clear();
+	audioPath.reset();
+	ready.clear();
+	readyMemory.Set(0);
+	nextRead = 0;
+	nextDecode = 0;
+	width = 0;
+	height = 0;
+	depth = CV_8U;
+}
+
+bool ImageSequence::IsOpen() const
+{
+	return !workers.empty();
+}
+
+std::uint32_t ImageSequence::GetWidth() const
+{
+	return width;
+}
+
+std::uint32_t ImageSequence::GetHeight() const
+{
+	return height;
+}
+
+std::uint32_t ImageSequence::GetFrameCount() const
+{
+	return static_cast<std::uint32_t>(frames.size());
+}
+
+float ImageSequence::GetFPS() const
+{
+	return fps;
+}
+
+std::uint32_t ImageSequence::GetThreadCount() const
+{
+	return threadCount;
+}
+
+bool ImageSequence::IsHighBitDepth() const
+{
+	return depth == CV_16U;
+}
+
+const std::optional<std::filesystem::path>& ImageSequence::GetAudioPath() const
+{
+	return audioPath;
+}
+
+bool ImageSequence::Read(cv::Mat& a_frame, std::stop_token a_st)
+{
+	Locker locker(lock);
+	if (nextRead >= frames.size()) {
+		return false;
+	}
+
+	if (!readyCV.wait(locker, a_st, [this] { return ready.contains(nextRead); })) {
+		return false;
+	}
+
+	auto node = ready.extract(nextRead++);
+	readyMemory.Set(readyMemory.Get() - static_cast<std::int64_t>(node.mapped().total() * node.mapped().elemSize()));
+	workCV.notify_one();
+
+	a_frame = std::move(node.mapped());
+	return !a_frame.empty();
+}
+
+std::uint32_t ImageSequence::GetPosition() const
+{
+	Locker locker(lock);
+	return nextRead;
+}
+
+std::uint32_t ImageSequence::GetQueuedFrames() const
+{
+	Locker locker(lock);
+	return static_cast<std::uint32_t>(ready.size());
+}
+
+void ImageSequence::Seek(std::uint32_t a_frame)
+{
+	{
+		Locker locker(lock);
+		nextRead = std::min(a_frame, GetFrameCount());
+		nextDecode = nextRead;
+		generation++;
+		ready.clear();
+		readyMemory.Set(0);
+	}
+	workCV.notify_all();
+}
+
+// a_depth is CV_8U or CV_16U, or -1 to keep whatever the file has
+bool ImageSequence::Decode(const std::filesystem::path& a_path, cv::Mat& a_frame, int a_depth)
+{
+	// read through a stream rather than cv::imread, which can't open non-ANSI paths
+	std::ifstream file(a_path, std::ios::binary | std::ios::ate);
+	if (!file) {
+		return false;
+	}
+	std::vector<std::uint8_t> data(static_cast<std::size_t>(file.tellg()));
+	file.seekg(0);
+	file.read(reinterpret_cast<char*>(data.data()), static_cast<std::streamsize>(data.size()));
+	if (!file) {
+		return false;
+	}
+
+	cv::Mat decoded;
+	if (clib_util::string::tolower(a_path.extension().string()) == ".qoi") {
+		QOI::Image image;
+		if (!QOI::Decode(data, image)) {
+			return false;
+		}
+		decoded = cv::Mat(static_cast<int>(image.height), static_cast<int>(image.width), CV_8UC4, image.pixels.data());
+		if (a_depth != CV_16U) {
+			decoded.copyTo(a_frame);
+			return true;
+		}
+	} else {
+		decoded = cv::imdecode(data, cv::IMREAD_UNCHANGED);
+		if (decoded.empty()) {
+			return false;
+		}
+	}
+
+	// 16-bit frames scale down to 8 and the odd 8-bit frame in a 16-bit sequence scales up
+	if (a_depth == -1) {
+		a_depth = decoded.depth() == CV_16U ? CV_16U : CV_8U;
+	}
+	if (decoded.depth() != a_depth) {
+		const double scale = decoded.depth() == CV_16U ? 1.0 / 257.0 : decoded.depth() == CV_8U ? 257.0 : 1.0;
+		decoded.convertTo(decoded, a_depth, scale);
+	}
+
+	// converting here keeps it on the worker threads, the player publishes 4 channel frames as-is
+	switch (decoded.channels()) {
+	case 1:
+		cv::cvtColor(decoded, a_frame, cv::COLOR_GRAY2BGRA);
+		break;
+	case 3:
+		cv::cvtColor(decoded, a_frame, cv::COLOR_BGR2BGRA);
+		break;
+	case 4:
+		a_frame = std::move(decoded);
+		break;
+	default:
+		return false;
+	}
+	return true;
+}
+
+void ImageSequence::DecodeFrames(std::stop_token a_st)
+{
+	while (true) {
+		std::uint32_t index = 0;
+		std::uint32_t claimedGeneration = 0;
+		{
+			// stay within the lookahead window and the memory budget
+			const auto frameBytes = std::int64_t(width) * height * (depth == CV_16U ? 8 : 4);
+			const auto hasWork = [&] {
+				return nextDecode < frames.size() && nextDecode < nextRead + lookahead && (ready.empty() || Memory::Tracker::GetSingleton()->CanAllocate(frameBytes));
+			};
+
+			Locker locker(lock);
+			if (!workCV.wait(locker, a_st, hasWork)) {
+				return;
+			}
+			index = nextDecode++;
+			claimedGeneration = generation;
+		}
+
+		const auto startTime = std::chrono::steady_clock::now();
+		cv::Mat    frame;
+		if (!Decode(frames[index], frame, depth) || frame.cols != static_cast<int>(width) || frame.rows != static_cast<int>(height)) {
+			logger::warn("Image sequence frame {} couldn't be decoded or doesn't match the first frame's size", frames[index].filename().string());
+			frame.release();
+		}
+		decodeNanoseconds.fetch_add(static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - startTime).count()), std::memory_order_relaxed);
+
+		// how fast the pool fills its first window is what decides startup time
+		if (decodedFrames.fetch_add(1, std::memory_order_relaxed) + 1 == std::min<std::size_t>(lookahead, frames.size())) {
+			logger::info("\tDecoded first {} frames in {:.0f} ms on {} threads", decodedFrames.load(std::memory_order_relaxed),
+				std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - openTime).count(), GetThreadCount());
+		}
+
+		{
+			Locker locker(lock);
+			if (claimedGeneration != generation) {
+				continue;  // a seek happened while this frame was decoding
+			}
+			readyMemory.Set(readyMemory.Get() + static_cast<std::int64_t>(frame.total() * frame.elemSize()));
+			ready.emplace(index, std::move(frame));
+		}
+		readyCV.notify_all();
+	}
+}
@@ -0,0 +1,75 @@
+#pragma once
+
+#include "Memory.h"
+
+// A folder of numbered frames (PNG, JPEG or QOI) with a sequence.ini manifest:
+//   [Sequence]
+//   fFPS = 30
+//   sAudio = music.ogg   ; optional, relative to the folder
+// Frames don't depend on each other, so a pool of workers decodes ahead of playback in parallel.
+class ImageSequence
+{
+public:
+	ImageSequence() = default;
+	ImageSequence(const ImageSequence&) = delete;
+	~ImageSequence();
+
+	ImageSequence& operator=(const ImageSequence&) = delete;
+
+	static constexpr auto manifestName{ "sequence.ini"sv };
+
+	static bool IsSequence(const std::filesystem::path& a_path);
+
+	void LoadSettings(CSimpleIniA& a_ini);
+
+	// a_allowHighBitDepth keeps 16-bit frames at 16 bits (as BGRA) if the first frame has them, for a 10-bit texture
+	bool Open(const std::filesystem::path& a_folder, bool a_allowHighBitDepth);
+	void Close();
+
+	bool                                        IsOpen() const;
+	std::uint32_t                               GetWidth() const;
+	std::uint32_t                               GetHeight() const;
+	std::uint32_t                               GetFrameCount() const;
+	float                                       GetFPS() const;
+	std::uint32_t                               GetThreadCount() const;
+	bool                                        IsHighBitDepth() const;
+	const std::optional<std::filesystem::path>& GetAudioPath() const;
+
+	// next frame in order as BGRA (16-bit if IsHighBitDepth), blocks until a worker has it ready; false at the end or on a bad frame
+	bool          Read(cv::Mat& a_frame, std::stop_token a_st);
+	std::uint32_t GetPosition() const;
+	std::uint32_t GetQueuedFrames() const;  // decoded and waiting to be read
+	void          Seek(std::uint32_t a_frame);
+
+private:
+	using Lock = std::mutex;
+	using Locker = std::unique_lock<Lock>;
+
+	static bool Decode(const std::filesystem::path& a_path, cv::Mat& a_frame, int a_depth);
+
+	void DecodeFrames(std::stop_token a_st);
+
+	// members
+	std::uint32_t                         decodeThreads{ 0 };  // 0 = all cores but one
+	std::uint32_t                         lookahead{ 16 };
+	bool                                  highBitDepth{ true };
+	std::vector<std::filesystem::path>    frames;
+	std::optional<std::filesystem::path>  audioPath;
+	std::uint32_t                         width{ 0 };
+	std::uint32_t                         height{ 0 };
+	float                                 fps{ 30.0f };
+	int                                   depth{ CV_8U };  // of every decoded frame
+	std::map<std::uint32_t, cv::Mat>      ready;  // decoded ahead of nextRead, empty mat = failed
+	std::uint32_t                         nextRead{ 0 };
+	std::uint32_t                         nextDecode{ 0 };
+	std::uint32_t                         generation{ 0 };  // bumped on seek so in-flight frames from before it are dropped
+	mutable Lock                          lock;
+	std::condition_variable_any           readyCV;
+	std::condition_variable_any           workCV;
+	std::vector<std::jthread>             workers;
+	std::uint32_t                         threadCount{ 0 };
+	Memory::Usage                         readyMemory{ Memory::Category::kFrames };
+	std::atomic<std::uint64_t>            decodeNanoseconds{ 0 };
+	std::atomic<std::uint32_t>            decodedFrames{ 0 };
+	std::chrono::steady_clock::time_point openTime{};
+};
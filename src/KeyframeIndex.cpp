@@ -0,0 +1,116 @@
+#include "KeyframeIndex.h"
+
+#include "Archive.h"
+#include "Cache.h"
+
+std::optional<KeyframeIndex> KeyframeIndex::Load(const std::string& a_video)
+{
+	const auto stamp = Cache::GetStamp(a_video);
+	const auto path = Cache::GetPath(a_video, ".kfi"sv);
+	if (!stamp || !path) {
+		return std::nullopt;
+	}
+
+	const auto data = Cache::Read(*path, magic, *stamp);
+	if (!data || data->size() < sizeof(std::int64_t) * 2 || data->size() % sizeof(std::int64_t) != 0) {
+		return std::nullopt;
+	}
+
+	KeyframeIndex index;
+	std::memcpy(&index.length, data->data(), sizeof(std::int64_t));
+	index.keyframes.resize(data->size() / sizeof(std::int64_t) - 1);
+	std::memcpy(index.keyframes.data(), data->data() + sizeof(std::int64_t), index.keyframes.size() * sizeof(std::int64_t));
+
+	if (!std::ranges::is_sorted(index.keyframes)) {
+		return std::nullopt;
+	}
+	return index;
+}
+
+std::optional<KeyframeIndex> KeyframeIndex::Build(const std::string& a_video, std::stop_token a_st)
+{
+	const auto startTime = std::chrono::steady_clock::now();
+
+	ComPtr<IMFSourceReader> reader;
+	if (FAILED(Archive::CreateSourceReader(a_video, nullptr, &reader)) ||
+		FAILED(reader->SetStreamSelection((DWORD)MF_SOURCE_READER_ALL_STREAMS, FALSE)) ||
+		FAILED(reader->SetStreamSelection((DWORD)MF_SOURCE_READER_FIRST_VIDEO_STREAM, TRUE))) {
+		logger::warn("Couldn't open {} to index keyframes", a_video);
+		return std::nullopt;
+	}
+
+	// no output type is set, so samples come straight from the demuxer and nothing is decoded
+	KeyframeIndex   index;
+	std::uint32_t   sampleCount = 0;
+	constexpr DWORD videoStreamIndex = static_cast<DWORD>(MF_SOURCE_READER_FIRST_VIDEO_STREAM);
+
+	while (!a_st.stop_requested()) {
+		ComPtr<IMFSample> sample;
+		DWORD             streamFlags = 0;
+		LONGLONG          timestamp = 0;
+
+		if (FAILED(reader->ReadSample(videoStreamIndex, 0, nullptr, &streamFlags, &timestamp, &sample)) || streamFlags & MF_SOURCE_READERF_ENDOFSTREAM) {
+			break;
+		}
+		if (!sample) {
+			continue;
+		}
+
+		sampleCount++;
+
+		LONGLONG sampleDuration = 0;
+		sample->GetSampleDuration(&sampleDuration);
+		index.length = std::max(index.length, timestamp + sampleDuration);
+
+		if (MFGetAttributeUINT32(sample.Get(), MFSampleExtension_CleanPoint, FALSE)) {
+			index.keyframes.push_back(timestamp);
+		}
+	}
+
+	if (a_st.stop_requested() || index.keyframes.empty()) {
+		return std::nullopt;
+	}
+
+	// samples arrive in decode order, which only matches presentation order without B-frames
+	std::ranges::sort(index.keyframes);
+
+	logger::info("Indexed {} keyframes ({} frames) of {} in {:.0f} ms", index.keyframes.size(), sampleCount, std::filesystem::path(a_video).filename().string(),
+		std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count());
+
+	const auto stamp = Cache::GetStamp(a_video);
+	const auto path = Cache::GetPath(a_video, ".kfi"sv);
+	if (stamp && path) {
+		std::vector<std::int64_t> payload;
+		payload.reserve(index.keyframes.size() + 1);
+		payload.push_back(index.length);
+		payload.insert(payload.end(), index.keyframes.begin(), index.keyframes.end());
+
+		if (!Cache::Write(*path, magic, *stamp, { reinterpret_cast<const std::uint8_t*>(payload.data()), payload.size() * sizeof(std::int64_t) })) {
+			logger::warn("Couldn't save keyframe index {}", path->string());
+		}
+	}
+
+	return index;
+}
+
+std::size_t KeyframeIndex::GetCount() const
+{
+	return keyframes.size();
+}
+
+KeyframeIndex::duration KeyframeIndex::GetTime(std::size_t a_index) const
+{
+	return duration(keyframes[a_index] / 1e7);
+}
+
+KeyframeIndex::duration KeyframeIndex::GetDuration() const
+{
+	return duration(length / 1e7);
+}
+
+std::size_t KeyframeIndex::FindBefore(duration a_time) const
+{
+	const auto time = static_cast<std::int64_t>(a_time.count() * 1e7);
+	const auto it = std::ranges::upper_bound(keyframes, time);
+	return it == keyframes.begin() ? 0 : static_cast<std::size_t>(std::distance(keyframes.begin(), it) - 1);
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+// Presentation times of every keyframe in a video, read from the container without decoding and cached.
+// Seeking straight to one of these never has to decode forward from an earlier keyframe.
+class KeyframeIndex
+{
+public:
+	using duration = std::chrono::duration<double>;
+
+	static std::optional<KeyframeIndex> Load(const std::string& a_video);
+	static std::optional<KeyframeIndex> Build(const std::string& a_video, std::stop_token a_st);
+
+	std::size_t GetCount() const;
+	duration    GetTime(std::size_t a_index) const;
+	duration    GetDuration() const;
+
+	// last keyframe at or before a_time
+	std::size_t FindBefore(duration a_time) const;
+
+private:
+	KeyframeIndex() = default;
+
+	// members
+	std::vector<std::int64_t> keyframes;  // 100ns units, ascending
+	std::int64_t              length{ 0 };
+
+	static constexpr std::uint32_t magic{ 0x4B564D4D };  // MMVK
+};
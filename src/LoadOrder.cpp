@@ -0,0 +1,78 @@
+#include "LoadOrder.h"
+
+namespace LoadOrder
+{
+	namespace detail
+	{
+		std::string lowercase(std::string a_string)
+		{
+			std::ranges::transform(a_string, a_string.begin(), [](char a_char) { return static_cast<char>(std::tolower(static_cast<unsigned char>(a_char))); });
+			return a_string;
+		}
+	}
+
+	std::vector<std::string> ReadPlugins(std::istream& a_file, bool a_activeOnly)
+	{
+		std::vector<std::string> plugins;
+		std::string              line;
+		while (std::getline(a_file, line)) {
+			while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) {
+				line.pop_back();
+			}
+			if (line.empty() || line.front() == '#') {
+				continue;
+			}
+
+			const bool active = line.front() == '*';
+			if (a_activeOnly && !active) {
+				continue;
+			}
+			plugins.push_back(active ? line.substr(1) : line);
+		}
+		return plugins;
+	}
+
+	std::vector<std::filesystem::path> GetArchives(std::span<const std::string> a_plugins, std::span<const std::filesystem::path> a_archives)
+	{
+		std::vector<std::pair<std::string, std::filesystem::path>> candidates;  // lowercase stem, archive
+		for (const auto& archive : a_archives) {
+			candidates.emplace_back(detail::lowercase(archive.stem().string()), archive);
+		}
+		std::ranges::sort(candidates);
+
+		std::vector<std::string> stems;
+		for (const auto& plugin : a_plugins) {
+			auto stem = detail::lowercase(std::filesystem::path(plugin).stem().string());
+			if (!stem.empty() && std::ranges::find(stems, stem) == stems.end()) {
+				stems.push_back(std::move(stem));
+			}
+		}
+
+		// "A - B - Textures.bsa" is A - B.esp's if that's loaded too, the longest plugin name it starts with owns it
+		const auto get_owner = [&](const std::string& a_candidate) {
+			std::optional<std::size_t> owner;
+			for (std::size_t i = 0; i < stems.size(); ++i) {
+				const auto& stem = stems[i];
+				const bool  owns = a_candidate == stem || (a_candidate.starts_with(stem) && a_candidate.compare(stem.size(), 3, " - "sv) == 0);
+				if (owns && (!owner || stem.size() > stems[*owner].size())) {
+					owner = i;
+				}
+			}
+			return owner;
+		};
+
+		std::vector<std::pair<std::size_t, std::filesystem::path>> owned;  // plugin index, archive
+		for (const auto& [candidate, archive] : candidates) {
+			if (const auto owner = get_owner(candidate)) {
+				owned.emplace_back(*owner, archive);
+			}
+		}
+		std::ranges::stable_sort(owned, {}, &decltype(owned)::value_type::first);
+
+		std::vector<std::filesystem::path> archives;
+		for (auto& [owner, archive] : owned) {
+			archives.push_back(std::move(archive));
+		}
+		return archives;
+	}
+}
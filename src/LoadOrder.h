@@ -0,0 +1,16 @@
+#pragma once
+
+// Which archives the game loads and in what order: the ones named after a loaded plugin (MyMod.bsa, MyMod - Textures.bsa
+// for MyMod.esp), following the plugins' load order, so a later archive overrides an earlier one's files.
+// No dependencies beyond the standard library; shared with tests/.
+namespace LoadOrder
+{
+	// loaded ahead of everything else, whether Plugins.txt lists them or not
+	inline constexpr std::array<std::string_view, 5> implicitPlugins{ "Skyrim.esm"sv, "Update.esm"sv, "Dawnguard.esm"sv, "HearthFires.esm"sv, "Dragonborn.esm"sv };
+
+	// plugin names in a Plugins.txt or Skyrim.ccc, in order. a_activeOnly keeps only the lines marked active with a '*'
+	std::vector<std::string> ReadPlugins(std::istream& a_file, bool a_activeOnly);
+
+	// the a_archives that belong to a_plugins, in the plugins' load order; a plugin's own archives in name order
+	std::vector<std::filesystem::path> GetArchives(std::span<const std::string> a_plugins, std::span<const std::filesystem::path> a_archives);
+}
@@ -1,5 +1,7 @@
 #include "Manager.h"
 
+#include "Archive.h"
+#include "Cache.h"
 #include "Hooks.h"
 #include "ImGui/Renderer.h"
 #include "ImGui/Util.h"
@@ -14,21 +16,46 @@ void Manager::Register()
 	logger::info("Loading settings...");
 	LoadSettings();
 
+	// before the list, its first shuffle already steers by it
+	if (const auto directory = Cache::GetDirectory(); useHistory && directory) {
+		if (history.Load(*directory / "history.tsv"sv)) {
+			logger::info("{} videos in the play history", history.GetRecords().size());
+		}
+		videoPlayer.SetHistory(&history);
+	}
+
 	logger::info("Getting video list...");
 	GetVideoList();
 
-	if (videoPaths.empty()) {
+	if (videos.empty()) {
 		logger::info("No videos found in Data\\MainMenuVideo...");
 		return;
 	} else {
-		const auto numVideos = videoPaths.size();
+		const auto numVideos = videos.size();
 		logger::info("{} videos found in Data\\MainMenuVideo.", numVideos);
 
 		if (numVideos == 1 && videoPlayer.GetPlaybackMode() == PLAYBACK_MODE::kPlayNext) {
 			videoPlayer.SetPlaybackMode(PLAYBACK_MODE::kLoop);
 		}
+
+		// rolled now rather than at the first loading screen, so the winner can be opened and pre-rolled in the meantime
+		const auto  screenHeight = GetScreenHeight();
+		const auto& first = GetVariant(videos[0], screenHeight);
+		playOnFirstBoot = clib_util::RNG().generate() <= chance;
+		if (playOnFirstBoot && videoPlayer.Prepare(first.string(), playVideoAudio)) {
+			logger::info("Warm starting {}", first.string());
+			prefetcher.OnOpen(first);
+		} else {
+			// first boot plays the head of the shuffled list, warm it up while the game loads
+			prefetcher.Queue(first, true);
+		}
+		if (numVideos > 1) {
+			prefetcher.Queue(GetVariant(videos[1], screenHeight));
+		}
 	}
 
+	videoPlayer.SetVisibilitySource(&gameWindow);
+
 	RE::UI::GetSingleton()->AddEventSink<RE::MenuOpenCloseEvent>(this);
 
 	SKSE::AllocTrampoline(42);
@@ -69,6 +96,19 @@ void Manager::LoadSettings()
 
 	ini::get_value(ini, volumeStep, "Settings", "fVolumeStep", ";Volume change (0.1 = 10%)");
 
+	ini::get_value(ini, useHistory, "History", "bEnable", ";Remember how each video plays on this machine, and play a smaller variant of (or skip) the ones it can't keep up with");
+	ini::get_value(ini, historyPolicy.minPlays, "History", "iMinPlays", ";Plays before a video's history is acted on");
+	ini::get_value(ini, historyPolicy.minFPSRatio, "History", "fMinFPSRatio", ";A video that achieved less than this share of its frame rate plays a smaller variant next time");
+	ini::get_value(ini, historyPolicy.maxDropRate, "History", "fMaxDropRate", ";As does one that dropped more than this share of its frames (0.05 = 5%)");
+	ini::get_value(ini, historyPolicy.skipFPSRatio, "History", "fSkipFPSRatio", ";A video that achieved less than this share of its frame rate, even at its smallest, is skipped");
+	ini::get_value(ini, historyPolicy.maxFirstPixelTime, "History", "fMaxFirstPixelMs", ";Also skip videos that took longer than this to show up, in milliseconds (0 - never)");
+	ini::get_value(ini, historyPolicy.retryAfter, "History", "iRetryAfter", ";Times a video is passed over before it gets another chance (0 - never)");
+
+	prefetcher.LoadSettings(ini);
+	videoPlayer.LoadSettings(ini);
+	gameWindow.LoadSettings(ini);
+	Memory::Tracker::GetSingleton()->LoadSettings(ini);
+
 	stopPlayback.LoadKeys(ini, "iStopPlayback", ";https://learn.microsoft.com/en-us/windows/win32/inputdev/virtual-key-codes (-1 to disable)\n;Stop playback key (default: Backspace)");
 	playNext.LoadKeys(ini, "iPlayNext", ";Next video key (default: Tab)");
 	volumeUp.LoadKeys(ini, "iVolumeUp", ";Volume up key (default: PageUp)");
@@ -101,6 +141,9 @@ void Manager::Draw()
 
 void Manager::Update()
 {
+	// every present counts, a video starting after a stretch without one mustn't find the window looking hidden
+	gameWindow.OnPresent(ImGui::Renderer::window);
+
 	if (!IsPlayingVideo()) {
 		return;
 	}
@@ -114,24 +157,54 @@ void Manager::Update()
 	}
 }
 
+void Manager::OnDeviceReady(ID3D11Device* device)
+{
+	videoPlayer.OnDeviceReady(device);
+}
+
 bool Manager::LoadNextVideo()
 {
-	if (videoPaths.empty()) {
+	if (videos.empty()) {
 		return false;
 	}
 
 	if (auto renderer = RE::BSGraphics::Renderer::GetSingleton()) {
 		if (auto device = reinterpret_cast<ID3D11Device*>(renderer->data.forwarder)) {
-			const std::uint32_t numVideos = static_cast<std::uint32_t>(videoPaths.size());
+			const std::uint32_t numVideos = static_cast<std::uint32_t>(videos.size());
+			const auto          screenHeight = GetScreenHeight();
 
 			if (selectedIndex >= numVideos) {
-				std::random_device rd;
-				std::mt19937       gen(rd());
-				std::ranges::shuffle(videoPaths, gen);
+				ShuffleVideos();
 				selectedIndex = 0;
 			}
-			videoPlayer.LoadVideo(device, videoPaths[selectedIndex].string(), playVideoAudio);
+
+			// skipped videos are shuffled to the back, reaching one ends the round early
+			auto path = SelectVariant(videos[selectedIndex], screenHeight);
+			if (!path && selectedIndex > 0) {
+				ShuffleVideos();
+				selectedIndex = 0;
+				path = SelectVariant(videos[selectedIndex], screenHeight);
+			}
+
+			const auto& video = videos[selectedIndex];
+			if (!path) {
+				path = &video.variants.front().path;
+				logger::info("Every video has fallen behind on this machine before, playing {} anyway", path->string());
+			} else if (const auto& preferred = video.Select(screenHeight); path != &preferred) {
+				logger::info("Playing {} instead of {}, which has fallen behind on this machine before", path->filename().string(), preferred.filename().string());
+				// the larger variants were passed over, which counts towards their retry
+				for (auto it = std::ranges::find(video.variants, preferred, &VideoEntry::Variant::path); &it->path != path; --it) {
+					history.Skip(it->path.string());
+				}
+				history.Save();
+			}
+
+			prefetcher.OnOpen(*path);
+			videoPlayer.LoadVideo(device, path->string(), playVideoAudio);
 			selectedIndex++;
+			if (selectedIndex < numVideos) {
+				prefetcher.Queue(GetVariant(videos[selectedIndex], screenHeight));
+			}
 			return true;
 		}
 	}
@@ -152,18 +225,6 @@ void Manager::GetVideoList()
 {
 	constexpr std::string_view directory = "Data\\MainMenuVideo"sv;
 
-	std::error_code ec;
-	if (!std::filesystem::exists(directory, ec) || ec) {
-		logger::error("Unable to find Data\\MainMenuVideo directory: {}", ec.message());
-		return;
-	}
-
-	std::filesystem::directory_iterator iterator(directory, ec);
-	if (ec) {
-		logger::error("Unable to iterate over Data\\MainMenuVideo directory: {}", ec.message());
-		return;
-	}
-
 	// https://gist.github.com/aaomidi/0a3b5c9bd563c9e012518b495410dc0e
 	static constexpr std::array videoExtensions{
 		".3g2"sv,
@@ -205,22 +266,124 @@ void Manager::GetVideoList()
 		".yuv"sv,
 	};
 
-	for (auto& entry : iterator) {
-		if (!entry.is_regular_file(ec) || ec) {
-			continue;
+	std::vector<std::filesystem::path> videoPaths;
+	std::vector<std::filesystem::path> sequencePaths;
+
+	std::error_code ec;
+	if (std::filesystem::exists(directory, ec) && !ec) {
+		std::filesystem::directory_iterator iterator(directory, ec);
+		if (ec) {
+			logger::error("Unable to iterate over Data\\MainMenuVideo directory: {}", ec.message());
+		}
+		for (auto& entry : iterator) {
+			if (ImageSequence::IsSequence(entry.path())) {
+				sequencePaths.push_back(entry.path());
+				continue;
+			}
+			if (!entry.is_regular_file(ec) || ec) {
+				continue;
+			}
+			auto ext = clib_util::string::tolower(entry.path().extension().string());
+			if (std::ranges::find(videoExtensions, ext) != videoExtensions.end()) {
+				videoPaths.push_back({ entry.path().string() });
+			} else {
+				logger::warn("Skipping unsupported file: {}", entry.path().string());
+			}
 		}
-		auto ext = clib_util::string::tolower(entry.path().extension().string());
-		if (std::ranges::find(videoExtensions, ext) != videoExtensions.end()) {
-			videoPaths.push_back({ entry.path().string() });
+	} else {
+		logger::info("No Data\\MainMenuVideo directory, only looking in archives");
+	}
+
+	// loose files override archived ones of the same name, as they do for the game; between archives the one loaded last wins
+	std::set<std::string> names;
+	for (const auto& path : videoPaths) {
+		names.insert(clib_util::string::tolower(path.filename().string()));
+	}
+	for (auto& path : Archive::Scan("Data"sv, "MainMenuVideo"sv, videoExtensions)) {
+		if (names.insert(clib_util::string::tolower(path.filename().string())).second) {
+			logger::info("\t{} is in an archive", path.string());
+			videoPaths.push_back(std::move(path));
 		} else {
-			logger::warn("Skipping unsupported file: {}", entry.path().string());
+			logger::info("\t{} is overridden by another file of the same name", path.string());
 		}
 	}
 
+	// resolution variants of one video count as a single entry
+	videos = VideoList::Group(videoPaths);
+	for (const auto& video : videos) {
+		if (video.variants.size() > 1) {
+			logger::info("\t{} has {} resolution variants", video.variants.back().path.filename().string(), video.variants.size());
+		}
+	}
+
+	// a folder's name is all of it ("intro.1080" isn't a variant of "intro"), so sequences aren't grouped
+	for (auto& path : sequencePaths) {
+		logger::info("\t{} is an image sequence", path.filename().string());
+		videos.push_back({ clib_util::string::tolower(path.string()), { { VideoList::originalHeight, std::move(path) } } });
+	}
+
 	// first shuffle
+	ShuffleVideos();
+}
+
+void Manager::ShuffleVideos()
+{
 	std::random_device rd;
 	std::mt19937       gen(rd());
-	std::ranges::shuffle(videoPaths, gen);
+	std::ranges::shuffle(videos, gen);
+
+	if (!useHistory) {
+		return;
+	}
+
+	// videos this machine can't keep up with go to the back, where a round only reaches them if nothing else is left
+	const auto screenHeight = GetScreenHeight();
+	const auto skipped = std::ranges::stable_partition(videos, [&](const auto& a_video) { return SelectVariant(a_video, screenHeight) != nullptr; });
+	for (const auto& video : skipped) {
+		logger::info("\tSkipping {} this round, it has fallen behind on this machine before", video.variants.back().path.filename().string());
+		for (const auto& variant : video.variants) {
+			history.Skip(variant.path.string());
+		}
+	}
+	if (!skipped.empty()) {
+		history.Save();
+	}
+}
+
+// the variant the screen asks for, or the largest smaller one that hasn't fallen behind; nullptr if even the smallest should be skipped
+const std::filesystem::path* Manager::SelectVariant(const VideoEntry& a_video, std::uint32_t a_screenHeight) const
+{
+	const auto& preferred = a_video.Select(a_screenHeight);
+	if (!useHistory) {
+		return &preferred;
+	}
+
+	for (auto it = std::ranges::find(a_video.variants, preferred, &VideoEntry::Variant::path);; --it) {
+		const auto record = history.Find(it->path.string());
+		const auto verdict = record ? History::Assess(*record, historyPolicy) : History::Verdict::kPlay;
+		if (verdict == History::Verdict::kPlay) {
+			return &it->path;
+		}
+		if (it == a_video.variants.begin()) {
+			// nothing smaller to try, a video that's only a little behind still plays
+			return verdict == History::Verdict::kSkip ? nullptr : &it->path;
+		}
+	}
+}
+
+const std::filesystem::path& Manager::GetVariant(const VideoEntry& a_video, std::uint32_t a_screenHeight) const
+{
+	const auto path = SelectVariant(a_video, a_screenHeight);
+	return path ? *path : a_video.variants.front().path;
+}
+
+std::uint32_t Manager::GetScreenHeight()
+{
+	// the renderer isn't up yet at kPostLoad, fall back to the primary monitor there
+	if (RE::BSGraphics::Renderer::GetSingleton() && RE::BSGraphics::Renderer::GetSingleton()->data.forwarder) {
+		return RE::BSGraphics::Renderer::GetScreenSize().height;
+	}
+	return static_cast<std::uint32_t>(GetSystemMetrics(SM_CYSCREEN));
 }
 
 void Manager::ProcessInput()
@@ -251,8 +414,7 @@ EventResult Manager::ProcessEvent(const RE::MenuOpenCloseEvent* a_evn, RE::BSTEv
 		if (a_evn->opening) {
 			if (firstBoot) {
 				firstBoot = false;
-				auto rng = clib_util::RNG().generate();
-				if (rng > chance) {
+				if (!playOnFirstBoot) {
 					return EventResult::kContinue;
 				}
 				timerRunning = true;
@@ -1,5 +1,8 @@
 #pragma once
 
+#include "History.h"
+#include "Prefetcher.h"
+#include "VideoList.h"
 #include "VideoPlayer.h"
 
 struct Key
@@ -45,6 +48,7 @@ public:
 	void GetVideoList();
 
 	bool LoadNextVideo();
+	void OnDeviceReady(ID3D11Device* device);
 
 	bool IsPlayingVideo() const;
 	bool IsPlayingVideoAudio() const;
@@ -52,25 +56,37 @@ public:
 private:
 	void ProcessInput();
 
+	void                         ShuffleVideos();
+	const std::filesystem::path* SelectVariant(const VideoEntry& a_video, std::uint32_t a_screenHeight) const;
+	const std::filesystem::path& GetVariant(const VideoEntry& a_video, std::uint32_t a_screenHeight) const;
+
+	static std::uint32_t GetScreenHeight();
+
 	EventResult ProcessEvent(const RE::MenuOpenCloseEvent* a_evn, RE::BSTEventSource<RE::MenuOpenCloseEvent>*) override;
 	EventResult ProcessEvent(const RE::TESDeathEvent* a_evn, RE::BSTEventSource<RE::TESDeathEvent>*) override;
 
 	// members
-	VideoPlayer                        videoPlayer;
-	std::vector<std::filesystem::path> videoPaths;
-	std::uint32_t                      selectedIndex{ 0 };
-	float                              chance{ 100.0f };
-	Key                                stopPlayback{ VK_BACK };
-	Key                                playNext{ VK_TAB };
-	Key                                volumeUp{ VK_PRIOR };
-	Key                                volumeDown{ VK_NEXT };
-	float                              volumeStep{ 0.1f };
-	bool                               firstBoot{ true };
-	bool                               timerRunning{ false };
-	bool                               mainMenuClosed{ false };
-	bool                               heyYouYoureFinallyAwake{ false };
-	bool                               playerDied{ false };
-	bool                               showDebugInfo{ false };
-	bool                               playVideoAudio{ true };
-	Timer                              timer;
+	VideoPlayer             videoPlayer;
+	Prefetcher              prefetcher;
+	Visibility::GameWindow  gameWindow;
+	std::vector<VideoEntry> videos;
+	std::uint32_t           selectedIndex{ 0 };
+	bool                    useHistory{ true };
+	History::Store          history;
+	History::Policy         historyPolicy;
+	float                   chance{ 100.0f };
+	Key                     stopPlayback{ VK_BACK };
+	Key                     playNext{ VK_TAB };
+	Key                     volumeUp{ VK_PRIOR };
+	Key                     volumeDown{ VK_NEXT };
+	float                   volumeStep{ 0.1f };
+	bool                    firstBoot{ true };
+	bool                    playOnFirstBoot{ false };
+	bool                    timerRunning{ false };
+	bool                    mainMenuClosed{ false };
+	bool                    heyYouYoureFinallyAwake{ false };
+	bool                    playerDied{ false };
+	bool                    showDebugInfo{ false };
+	bool                    playVideoAudio{ true };
+	Timer                   timer;
 };
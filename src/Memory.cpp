@@ -0,0 +1,43 @@
+#include "Memory.h"
+
+namespace Memory
+{
+	void Tracker::LoadSettings(CSimpleIniA& a_ini)
+	{
+		ini::get_value(a_ini, budgetMB, "Memory", "iBudgetMB", ";Memory the player may use for frames and optional buffering, in megabytes (0 - unlimited)");
+	}
+
+	void Tracker::Add(Category a_category, std::int64_t a_bytes)
+	{
+		usage[std::to_underlying(a_category)].fetch_add(a_bytes, std::memory_order_relaxed);
+
+		const auto newTotal = total.fetch_add(a_bytes, std::memory_order_relaxed) + a_bytes;
+		auto       oldPeak = peak.load(std::memory_order_relaxed);
+		while (newTotal > oldPeak && !peak.compare_exchange_weak(oldPeak, newTotal, std::memory_order_relaxed)) {}
+	}
+
+	std::int64_t Tracker::GetUsage(Category a_category) const
+	{
+		return usage[std::to_underlying(a_category)].load(std::memory_order_relaxed);
+	}
+
+	std::int64_t Tracker::GetTotalUsage() const
+	{
+		return total.load(std::memory_order_relaxed);
+	}
+
+	std::int64_t Tracker::GetPeakUsage() const
+	{
+		return peak.load(std::memory_order_relaxed);
+	}
+
+	std::int64_t Tracker::GetBudget() const
+	{
+		return static_cast<std::int64_t>(budgetMB) * 1024 * 1024;
+	}
+
+	bool Tracker::CanAllocate(std::int64_t a_bytes) const
+	{
+		return budgetMB == 0 || GetTotalUsage() + a_bytes <= GetBudget();
+	}
+}
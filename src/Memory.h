@@ -0,0 +1,73 @@
+#pragma once
+
+// Bytes held by the player, per category, checked against a configurable budget.
+namespace Memory
+{
+	enum class Category : std::uint32_t
+	{
+		kFrames,    // decoded, converted and published frames
+		kTexture,   // dynamic video texture
+		kCache,     // poster frames being loaded/saved
+		kBake,      // frames queued for the BC1 encoder
+		kPrefetch,  // read-ahead buffers
+
+		kTotal
+	};
+
+	inline constexpr std::array categoryNames{ "Frames"sv, "Texture"sv, "Cache"sv, "Bake"sv, "Prefetch"sv };
+
+	class Tracker : public REX::Singleton<Tracker>
+	{
+	public:
+		void LoadSettings(CSimpleIniA& a_ini);
+
+		void Add(Category a_category, std::int64_t a_bytes);
+
+		std::int64_t GetUsage(Category a_category) const;
+		std::int64_t GetTotalUsage() const;
+		std::int64_t GetPeakUsage() const;
+		std::int64_t GetBudget() const;
+
+		// whether another a_bytes fits in the budget; optional buffering should check this first
+		bool CanAllocate(std::int64_t a_bytes) const;
+
+		// in MemoryReport.cpp, so the accounting builds for tests/ without the overlay
+		void ShowDebugInfo() const;
+		void LogUsage(std::string_view a_context) const;
+
+	private:
+		// members
+		std::array<std::atomic<std::int64_t>, std::to_underlying(Category::kTotal)> usage{};
+		std::atomic<std::int64_t>                                                   total{ 0 };
+		std::atomic<std::int64_t>                                                   peak{ 0 };
+		std::uint32_t                                                               budgetMB{ 512 };
+	};
+
+	// RAII handle for one allocation (or a group of them) that is resized as it changes
+	class Usage
+	{
+	public:
+		explicit Usage(Category a_category) :
+			category(a_category)
+		{}
+		Usage(const Usage&) = delete;
+		~Usage() { Set(0); }
+
+		Usage& operator=(const Usage&) = delete;
+
+		void Set(std::int64_t a_bytes)
+		{
+			if (a_bytes != bytes) {
+				Tracker::GetSingleton()->Add(category, a_bytes - bytes);
+				bytes = a_bytes;
+			}
+		}
+
+		std::int64_t Get() const { return bytes; }
+
+	private:
+		// members
+		Category     category;
+		std::int64_t bytes{ 0 };
+	};
+}
@@ -0,0 +1,38 @@
+#include "Memory.h"
+
+namespace Memory
+{
+	namespace detail
+	{
+		inline float to_mb(std::int64_t a_bytes)
+		{
+			return static_cast<float>(a_bytes / (1024.0 * 1024.0));
+		}
+	}
+
+	void Tracker::ShowDebugInfo() const
+	{
+		ImGui::Text("\tMemory: %.1f MB (peak %.1f MB, budget %u MB)", detail::to_mb(GetTotalUsage()), detail::to_mb(GetPeakUsage()), budgetMB);
+		for (std::uint32_t i = 0; i < std::to_underlying(Category::kTotal); ++i) {
+			if (const auto bytes = usage[i].load(std::memory_order_relaxed); bytes != 0) {
+				ImGui::Text("\t\t%s: %.1f MB", categoryNames[i].data(), detail::to_mb(bytes));
+			}
+		}
+
+		PROCESS_MEMORY_COUNTERS_EX counters{};
+		if (GetProcessMemoryInfo(GetCurrentProcess(), reinterpret_cast<PROCESS_MEMORY_COUNTERS*>(&counters), sizeof(counters))) {
+			ImGui::Text("\t\tProcess: %.1f MB private", detail::to_mb(static_cast<std::int64_t>(counters.PrivateUsage)));
+		}
+	}
+
+	void Tracker::LogUsage(std::string_view a_context) const
+	{
+		std::string breakdown;
+		for (std::uint32_t i = 0; i < std::to_underlying(Category::kTotal); ++i) {
+			if (const auto bytes = usage[i].load(std::memory_order_relaxed); bytes != 0) {
+				breakdown += std::format(" {}: {:.1f} MB", categoryNames[i], detail::to_mb(bytes));
+			}
+		}
+		logger::info("Memory {}: {:.1f} MB held, peak {:.1f} MB{}", a_context, detail::to_mb(GetTotalUsage()), detail::to_mb(GetPeakUsage()), breakdown);
+	}
+}
@@ -13,9 +13,11 @@
 #include <d3d11.h>
 #include <dxgi.h>
 #include <latch>
+#include <psapi.h>
 #include <shared_mutex>
 #include <shlobj.h>
 #include <wrl/client.h>
+#include <wrl/implements.h>
 
 #include <Mferror.h>
 #include <audioclient.h>
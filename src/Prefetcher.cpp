@@ -0,0 +1,162 @@
+#include "Prefetcher.h"
+
+#include "Archive.h"
+#include "Memory.h"
+
+Prefetcher::~Prefetcher()
+{
+	if (prefetchThread.joinable()) {
+		prefetchThread.request_stop();
+		prefetchThread.join();
+	}
+}
+
+void Prefetcher::LoadSettings(CSimpleIniA& a_ini)
+{
+	ini::get_value(a_ini, enabled, "Prefetch", "bEnable", ";Read the start of upcoming videos ahead of time so playback doesn't stall on a cold disk");
+	ini::get_value(a_ini, prefetchSizeMB, "Prefetch", "iPrefetchSizeMB", ";Megabytes to read from the start of each video");
+	ini::get_value(a_ini, bandwidthMB, "Prefetch", "iBandwidthMB", ";Maximum read speed in megabytes per second (0 - uncapped)");
+}
+
+void Prefetcher::Queue(const std::filesystem::path& a_path, bool a_urgent)
+{
+	if (!enabled || prefetchSizeMB == 0) {
+		return;
+	}
+
+	{
+		Locker lock(queueLock);
+		if (const auto it = prefetched.find(a_path); it != prefetched.end() && std::chrono::steady_clock::now() - it->second < prefetchedLifetime) {
+			return;
+		}
+		if (std::ranges::find(queue, a_path) != queue.end()) {
+			return;
+		}
+		if (a_urgent) {
+			queue.push_front(a_path);
+		} else {
+			queue.push_back(a_path);
+		}
+	}
+
+	CreatePrefetchThread();
+	queueCV.notify_one();
+}
+
+void Prefetcher::OnOpen(const std::filesystem::path& a_path)
+{
+	// the decoder reads it from here on, a prefetch now would only compete with it; its next play warms it again
+	Locker lock(queueLock);
+	prefetched.erase(a_path);
+	std::erase(queue, a_path);
+}
+
+std::uint64_t Prefetcher::GetBytesPrefetched() const
+{
+	return bytesPrefetched.load(std::memory_order_relaxed);
+}
+
+void Prefetcher::CreatePrefetchThread()
+{
+	if (prefetchThread.joinable()) {
+		return;
+	}
+
+	prefetchThread = std::jthread([this](std::stop_token st) {
+		// lowers both CPU and I/O priority, so the game's own reads always win
+		SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+
+		while (!st.stop_requested()) {
+			std::filesystem::path path;
+			{
+				Locker lock(queueLock);
+				if (!queueCV.wait(lock, st, [this] { return !queue.empty(); })) {
+					break;
+				}
+				path = std::move(queue.front());
+				queue.pop_front();
+				prefetched.insert_or_assign(path, std::chrono::steady_clock::now());
+			}
+			Prefetch(path, st);
+		}
+
+		SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+	});
+}
+
+void Prefetcher::Prefetch(const std::filesystem::path& a_path, std::stop_token a_st)
+{
+	struct Range
+	{
+		std::filesystem::path file;
+		std::uint64_t         offset{ 0 };
+		std::uint64_t         size{ std::numeric_limits<std::uint64_t>::max() };
+	};
+
+	// an image sequence is warmed from its first frame on, the size limit and bandwidth cap cover the whole folder.
+	// An archived video is its range of the archive
+	std::vector<Range> files;
+	std::error_code    ec;
+	if (const auto entry = Archive::Find(a_path.string())) {
+		files.push_back({ entry->archive, entry->offset, entry->size });
+	} else if (std::filesystem::is_directory(a_path, ec)) {
+		for (const auto& entry : std::filesystem::directory_iterator(a_path, ec)) {
+			if (entry.is_regular_file(ec)) {
+				files.push_back({ entry.path() });
+			}
+		}
+		std::ranges::sort(files, {}, &Range::file);
+	} else {
+		files.push_back({ a_path });
+	}
+
+	const auto                startTime = std::chrono::steady_clock::now();
+	const std::uint64_t       limit = static_cast<std::uint64_t>(prefetchSizeMB) * 1024 * 1024;
+	const double              bytesPerSecond = static_cast<double>(bandwidthMB) * 1024 * 1024;
+	std::vector<std::uint8_t> buffer(chunkSize);
+	std::uint64_t             totalRead = 0;
+
+	Memory::Usage bufferMemory(Memory::Category::kPrefetch);
+	bufferMemory.Set(chunkSize);
+
+	for (const auto& [file, offset, size] : files) {
+		if (totalRead >= limit || a_st.stop_requested()) {
+			break;
+		}
+
+		const auto handle = CreateFileW(file.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+		if (handle == INVALID_HANDLE_VALUE) {
+			logger::warn("Prefetch: couldn't open {} (error {})", file.string(), GetLastError());
+			continue;
+		}
+		LARGE_INTEGER start{};
+		start.QuadPart = static_cast<LONGLONG>(offset);
+		SetFilePointerEx(handle, start, nullptr, FILE_BEGIN);
+
+		std::uint64_t fileRead = 0;
+		while (totalRead < limit && fileRead < size && !a_st.stop_requested()) {
+			DWORD bytesRead = 0;
+			if (!ReadFile(handle, buffer.data(), static_cast<DWORD>(std::min<std::uint64_t>(chunkSize, size - fileRead)), &bytesRead, nullptr) || bytesRead == 0) {
+				break;
+			}
+			fileRead += bytesRead;
+			totalRead += bytesRead;
+
+			// token bucket: never get ahead of where the cap says we should be
+			if (bytesPerSecond > 0.0) {
+				const auto expected = std::chrono::duration<double>(totalRead / bytesPerSecond);
+				const auto elapsed = std::chrono::steady_clock::now() - startTime;
+				if (expected > elapsed) {
+					std::this_thread::sleep_for(expected - elapsed);
+				}
+			}
+		}
+
+		CloseHandle(handle);
+	}
+
+	bytesPrefetched.fetch_add(totalRead, std::memory_order_relaxed);
+
+	const auto elapsedMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - startTime).count();
+	logger::info("Prefetched {:.1f} MB of {} in {:.0f} ms", totalRead / (1024.0 * 1024.0), a_path.filename().string(), elapsedMs);
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+// Warms the OS file cache for videos that are about to be opened, so the decoder's
+// small random reads at startup hit memory instead of a cold (possibly spinning) disk.
+class Prefetcher
+{
+public:
+	Prefetcher() = default;
+	~Prefetcher();
+
+	void LoadSettings(CSimpleIniA& a_ini);
+
+	void Queue(const std::filesystem::path& a_path, bool a_urgent = false);
+	void OnOpen(const std::filesystem::path& a_path);
+
+	std::uint64_t GetBytesPrefetched() const;
+
+private:
+	using Lock = std::mutex;
+	using Locker = std::unique_lock<Lock>;
+	using TimePoint = std::chrono::steady_clock::time_point;
+
+	void CreatePrefetchThread();
+	void Prefetch(const std::filesystem::path& a_path, std::stop_token a_st);
+
+	// members
+	bool                                       enabled{ true };
+	std::uint32_t                              prefetchSizeMB{ 32 };
+	std::uint32_t                              bandwidthMB{ 64 };  // per second, 0 = uncapped
+	std::deque<std::filesystem::path>          queue;
+	std::map<std::filesystem::path, TimePoint> prefetched;  // when each was warmed, until it's opened
+	Lock                                       queueLock;
+	std::condition_variable_any                queueCV;
+	std::jthread                               prefetchThread;
+	std::atomic<std::uint64_t>                 bytesPrefetched{ 0 };
+
+	static constexpr std::uint32_t chunkSize{ 1024 * 1024 };
+	static constexpr auto          prefetchedLifetime{ std::chrono::minutes(2) };  // the OS may have evicted the pages since
+};
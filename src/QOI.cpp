@@ -0,0 +1,197 @@
+#include "QOI.h"
+
+namespace QOI
+{
+	namespace detail
+	{
+		struct Pixel
+		{
+			bool operator==(const Pixel&) const = default;
+
+			std::uint8_t r{ 0 };
+			std::uint8_t g{ 0 };
+			std::uint8_t b{ 0 };
+			std::uint8_t a{ 255 };
+		};
+
+		constexpr std::uint8_t OP_INDEX = 0x00;
+		constexpr std::uint8_t OP_DIFF = 0x40;
+		constexpr std::uint8_t OP_LUMA = 0x80;
+		constexpr std::uint8_t OP_RUN = 0xC0;
+		constexpr std::uint8_t OP_RGB = 0xFE;
+		constexpr std::uint8_t OP_RGBA = 0xFF;
+		constexpr std::uint8_t MASK_2 = 0xC0;
+
+		constexpr std::size_t                 headerSize = 14;
+		constexpr std::array<std::uint8_t, 8> padding{ 0, 0, 0, 0, 0, 0, 0, 1 };
+		constexpr std::uint32_t               maxPixels = 400'000'000;
+
+		inline std::uint32_t hash(const Pixel& a_px)
+		{
+			return (a_px.r * 3u + a_px.g * 5u + a_px.b * 7u + a_px.a * 11u) % 64u;
+		}
+
+		inline void write_u32(std::vector<std::uint8_t>& a_out, std::uint32_t a_value)
+		{
+			a_out.push_back(static_cast<std::uint8_t>(a_value >> 24));
+			a_out.push_back(static_cast<std::uint8_t>(a_value >> 16));
+			a_out.push_back(static_cast<std::uint8_t>(a_value >> 8));
+			a_out.push_back(static_cast<std::uint8_t>(a_value));
+		}
+
+		inline std::uint32_t read_u32(const std::uint8_t* a_data)
+		{
+			return (std::uint32_t(a_data[0]) << 24) | (std::uint32_t(a_data[1]) << 16) | (std::uint32_t(a_data[2]) << 8) | std::uint32_t(a_data[3]);
+		}
+	}
+
+	std::vector<std::uint8_t> Encode(const std::uint8_t* a_bgra, std::uint32_t a_width, std::uint32_t a_height, std::size_t a_stride)
+	{
+		using namespace detail;
+
+		std::vector<std::uint8_t> out;
+		if (!a_bgra || a_width == 0 || a_height == 0 || std::uint64_t(a_width) * a_height > maxPixels) {
+			return out;
+		}
+
+		// worst case is one OP_RGBA per pixel, typical frames land far below that
+		out.reserve(headerSize + std::size_t(a_width) * a_height + padding.size());
+
+		out.insert(out.end(), { 'q', 'o', 'i', 'f' });
+		write_u32(out, a_width);
+		write_u32(out, a_height);
+		out.push_back(4);  // RGBA
+		out.push_back(0);  // sRGB with linear alpha
+
+		std::array<Pixel, 64> index{};
+		Pixel                 prev{};
+		std::uint32_t         run = 0;
+
+		for (std::uint32_t y = 0; y < a_height; ++y) {
+			const auto* row = a_bgra + y * a_stride;
+			for (std::uint32_t x = 0; x < a_width; ++x) {
+				const auto* src = row + x * 4;
+				const Pixel px{ src[2], src[1], src[0], src[3] };
+
+				if (px == prev) {
+					if (++run == 62) {
+						out.push_back(static_cast<std::uint8_t>(OP_RUN | (run - 1)));
+						run = 0;
+					}
+					continue;
+				}
+
+				if (run > 0) {
+					out.push_back(static_cast<std::uint8_t>(OP_RUN | (run - 1)));
+					run = 0;
+				}
+
+				const auto idx = hash(px);
+				if (index[idx] == px) {
+					out.push_back(static_cast<std::uint8_t>(OP_INDEX | idx));
+				} else {
+					index[idx] = px;
+
+					if (px.a == prev.a) {
+						const auto dr = static_cast<std::int8_t>(px.r - prev.r);
+						const auto dg = static_cast<std::int8_t>(px.g - prev.g);
+						const auto db = static_cast<std::int8_t>(px.b - prev.b);
+						const auto dr_dg = dr - dg;
+						const auto db_dg = db - dg;
+
+						if (dr > -3 && dr < 2 && dg > -3 && dg < 2 && db > -3 && db < 2) {
+							out.push_back(static_cast<std::uint8_t>(OP_DIFF | (dr + 2) << 4 | (dg + 2) << 2 | (db + 2)));
+						} else if (dr_dg > -9 && dr_dg < 8 && dg > -33 && dg < 32 && db_dg > -9 && db_dg < 8) {
+							out.push_back(static_cast<std::uint8_t>(OP_LUMA | (dg + 32)));
+							out.push_back(static_cast<std::uint8_t>((dr_dg + 8) << 4 | (db_dg + 8)));
+						} else {
+							out.insert(out.end(), { OP_RGB, px.r, px.g, px.b });
+						}
+					} else {
+						out.insert(out.end(), { OP_RGBA, px.r, px.g, px.b, px.a });
+					}
+				}
+
+				prev = px;
+			}
+		}
+
+		if (run > 0) {
+			out.push_back(static_cast<std::uint8_t>(OP_RUN | (run - 1)));
+		}
+
+		out.insert(out.end(), padding.begin(), padding.end());
+
+		return out;
+	}
+
+	bool Decode(std::span<const std::uint8_t> a_data, Image& a_image)
+	{
+		using namespace detail;
+
+		if (a_data.size() < headerSize + padding.size() || std::memcmp(a_data.data(), "qoif", 4) != 0) {
+			return false;
+		}
+
+		const auto width = read_u32(a_data.data() + 4);
+		const auto height = read_u32(a_data.data() + 8);
+		const auto channels = a_data[12];
+		if (width == 0 || height == 0 || std::uint64_t(width) * height > maxPixels || (channels != 3 && channels != 4)) {
+			return false;
+		}
+
+		a_image.width = width;
+		a_image.height = height;
+		a_image.pixels.resize(std::size_t(width) * height * 4);
+
+		std::array<Pixel, 64> index{};
+		Pixel                 px{};
+		std::uint32_t         run = 0;
+		std::size_t           p = headerSize;
+		const std::size_t     end = a_data.size() - padding.size();
+
+		for (auto* dst = a_image.pixels.data(), *last = dst + a_image.pixels.size(); dst < last; dst += 4) {
+			if (run > 0) {
+				--run;
+			} else if (p < end) {
+				const auto b1 = a_data[p++];
+
+				if (b1 == OP_RGB) {
+					px.r = a_data[p++];
+					px.g = a_data[p++];
+					px.b = a_data[p++];
+				} else if (b1 == OP_RGBA) {
+					px.r = a_data[p++];
+					px.g = a_data[p++];
+					px.b = a_data[p++];
+					px.a = a_data[p++];
+				} else if ((b1 & MASK_2) == OP_INDEX) {
+					px = index[b1];
+				} else if ((b1 & MASK_2) == OP_DIFF) {
+					px.r = static_cast<std::uint8_t>(px.r + ((b1 >> 4) & 0x03) - 2);
+					px.g = static_cast<std::uint8_t>(px.g + ((b1 >> 2) & 0x03) - 2);
+					px.b = static_cast<std::uint8_t>(px.b + (b1 & 0x03) - 2);
+				} else if ((b1 & MASK_2) == OP_LUMA) {
+					const auto b2 = a_data[p++];
+					const auto vg = (b1 & 0x3F) - 32;
+					px.r = static_cast<std::uint8_t>(px.r + vg - 8 + ((b2 >> 4) & 0x0F));
+					px.g = static_cast<std::uint8_t>(px.g + vg);
+					px.b = static_cast<std::uint8_t>(px.b + vg - 8 + (b2 & 0x0F));
+				} else {  // OP_RUN
+					run = b1 & 0x3F;
+				}
+
+				index[hash(px)] = px;
+			} else {
+				return false;  // truncated
+			}
+
+			dst[0] = px.b;
+			dst[1] = px.g;
+			dst[2] = px.r;
+			dst[3] = px.a;
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,16 @@
+#pragma once
+
+// https://qoiformat.org/qoi-specification.pdf
+// Pixels are BGRA in memory (matching the video texture) and RGBA in the encoded stream, as the spec requires.
+namespace QOI
+{
+	struct Image
+	{
+		std::uint32_t             width{ 0 };
+		std::uint32_t             height{ 0 };
+		std::vector<std::uint8_t> pixels;  // BGRA, tightly packed
+	};
+
+	std::vector<std::uint8_t> Encode(const std::uint8_t* a_bgra, std::uint32_t a_width, std::uint32_t a_height, std::size_t a_stride);
+	bool                      Decode(std::span<const std::uint8_t> a_data, Image& a_image);
+}
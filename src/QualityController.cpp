@@ -0,0 +1,90 @@
+#include "QualityController.h"
+
+void QualityController::LoadSettings(CSimpleIniA& a_ini)
+{
+	ini::get_value(a_ini, enabled, "AdaptiveQuality", "bEnable", ";Skip video frames when the game's own frame rate drops below the target");
+	ini::get_value(a_ini, targetFrameTime, "AdaptiveQuality", "fTargetFrameTime", ";Game frame time to maintain, in milliseconds (16.7 = 60 FPS)");
+	ini::get_value(a_ini, maxLevel, "AdaptiveQuality", "iMaxLevel", ";Highest quality reduction allowed (1 - every 2nd frame, 2 - every 3rd frame...)");
+	ini::get_value(a_ini, windowSize, "AdaptiveQuality", "iWindowFrames", ";Game frames per measurement window");
+	ini::get_value(a_ini, downgradeWindows, "AdaptiveQuality", "iDowngradeWindows", ";Consecutive slow windows before lowering quality");
+	ini::get_value(a_ini, upgradeWindows, "AdaptiveQuality", "iUpgradeWindows", ";Consecutive fast windows before raising quality");
+
+	windowSize = std::max(windowSize, 1u);
+	downgradeWindows = std::max(downgradeWindows, 1u);
+	upgradeWindows = std::max(upgradeWindows, 1u);
+	upgradeWindowsRequired = upgradeWindows;
+	window.reserve(windowSize);
+}
+
+std::optional<QualityController::Decision> QualityController::Sample(float a_frameTime)
+{
+	if (!enabled || targetFrameTime <= 0.0f) {
+		return std::nullopt;
+	}
+
+	Locker locker(lock);
+	window.push_back(a_frameTime);
+	if (window.size() < windowSize) {
+		return std::nullopt;
+	}
+
+	// median, so a single loading hitch can't push quality down on its own
+	const auto mid = window.begin() + window.size() / 2;
+	std::ranges::nth_element(window, mid);
+	const float median = *mid;
+	window.clear();
+
+	const auto currentLevel = level.load(std::memory_order_relaxed);
+
+	if (median > targetFrameTime * downgradeThreshold) {
+		underBudgetCount = 0;
+		if (++overBudgetCount >= downgradeWindows && currentLevel < maxLevel) {
+			overBudgetCount = 0;
+			// dropping straight back after an upgrade means we're flapping around the limit, back off
+			if (lastChangeWasUpgrade) {
+				upgradeWindowsRequired = std::min(upgradeWindowsRequired * 2, upgradeWindows * maxUpgradeBackoff);
+			}
+			lastChangeWasUpgrade = false;
+			level.store(currentLevel + 1, std::memory_order_relaxed);
+			return Decision{ currentLevel, currentLevel + 1, median };
+		}
+	} else if (median < targetFrameTime * upgradeThreshold) {
+		overBudgetCount = 0;
+		if (currentLevel == 0) {
+			upgradeWindowsRequired = upgradeWindows;  // fully recovered, forget the backoff
+		}
+		if (++underBudgetCount >= upgradeWindowsRequired && currentLevel > 0) {
+			underBudgetCount = 0;
+			lastChangeWasUpgrade = true;
+			level.store(currentLevel - 1, std::memory_order_relaxed);
+			return Decision{ currentLevel, currentLevel - 1, median };
+		}
+	} else {
+		overBudgetCount = 0;
+		underBudgetCount = 0;
+	}
+
+	return std::nullopt;
+}
+
+// a new video starts at full quality, it may well be cheaper than the last one
+void QualityController::Reset()
+{
+	Locker locker(lock);
+	window.clear();
+	overBudgetCount = 0;
+	underBudgetCount = 0;
+	upgradeWindowsRequired = upgradeWindows;
+	lastChangeWasUpgrade = false;
+	level.store(0, std::memory_order_relaxed);
+}
+
+bool QualityController::IsEnabled() const
+{
+	return enabled;
+}
+
+std::uint32_t QualityController::GetLevel() const
+{
+	return level.load(std::memory_order_relaxed);
+}
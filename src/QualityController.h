@@ -0,0 +1,46 @@
+#pragma once
+
+// Watches how long the game takes to present and trades video smoothness for game frame time.
+// Level 0 shows every decoded frame, level N shows every (N+1)th and skips conversion/upload for the rest.
+class QualityController
+{
+public:
+	struct Decision
+	{
+		std::uint32_t oldLevel;
+		std::uint32_t newLevel;
+		float         medianFrameTime;
+	};
+
+	void LoadSettings(CSimpleIniA& a_ini);
+
+	// feed one present interval (ms) from the render thread, returns a decision when the level changes
+	std::optional<Decision> Sample(float a_frameTime);
+	void                    Reset();  // from whichever thread starts the next video
+
+	bool          IsEnabled() const;
+	std::uint32_t GetLevel() const;
+
+private:
+	using Lock = std::mutex;
+	using Locker = std::unique_lock<Lock>;
+
+	// members
+	bool                       enabled{ false };
+	float                      targetFrameTime{ 16.7f };
+	std::uint32_t              maxLevel{ 3 };
+	std::uint32_t              windowSize{ 60 };
+	std::uint32_t              downgradeWindows{ 2 };
+	std::uint32_t              upgradeWindows{ 5 };
+	std::uint32_t              upgradeWindowsRequired{ 5 };
+	std::uint32_t              overBudgetCount{ 0 };
+	std::uint32_t              underBudgetCount{ 0 };
+	bool                       lastChangeWasUpgrade{ false };
+	std::vector<float>         window;
+	std::atomic<std::uint32_t> level{ 0 };  // read without the lock by the video thread
+	Lock                       lock;        // the window and counters, shared by Sample and Reset
+
+	static constexpr float         downgradeThreshold{ 1.15f };  // x target
+	static constexpr float         upgradeThreshold{ 1.05f };    // x target
+	static constexpr std::uint32_t maxUpgradeBackoff{ 8 };       // x upgradeWindows
+};
@@ -0,0 +1,49 @@
+#include "R10G10B10A2.h"
+
+#include <emmintrin.h>
+
+namespace R10G10B10A2
+{
+	namespace detail
+	{
+		// v * 1023 / 65536, rounded: scale to 1023 * 64 first so the rounding happens on the final shift
+		inline std::uint32_t to_10bit(std::uint16_t a_value)
+		{
+			return (std::min((a_value * 65472u >> 16) + 32u, 65535u)) >> 6;
+		}
+
+		inline __m128i to_10bit(__m128i a_values)
+		{
+			return _mm_srli_epi16(_mm_adds_epu16(_mm_mulhi_epu16(a_values, _mm_set1_epi16(static_cast<short>(65472))), _mm_set1_epi16(32)), 6);
+		}
+	}
+
+	void PackRow(const std::uint16_t* a_bgra, std::uint32_t* a_out, std::uint32_t a_width)
+	{
+		// per pixel: B * 1024 + G and R from one multiply-add, shifted into place below
+		const __m128i weights = _mm_setr_epi16(1024, 1, 1, 0, 1024, 1, 1, 0);
+
+		std::uint32_t x = 0;
+		for (; x + 4 <= a_width; x += 4) {
+			const __m128i lo = detail::to_10bit(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a_bgra + x * 4)));
+			const __m128i hi = detail::to_10bit(_mm_loadu_si128(reinterpret_cast<const __m128i*>(a_bgra + x * 4 + 8)));
+
+			// the multiply-add leaves B * 1024 + G in even lanes and R in odd ones, then the top two bits of A go on top of
+			// the odd lanes (even ones pick up bits of G there, which the shift below pushes out)
+			const __m128i loLanes = _mm_or_si128(_mm_madd_epi16(lo, weights), _mm_slli_epi32(_mm_srli_epi32(lo, 24), 30));
+			const __m128i hiLanes = _mm_or_si128(_mm_madd_epi16(hi, weights), _mm_slli_epi32(_mm_srli_epi32(hi, 24), 30));
+
+			// gather the even (BG) and odd (RA) lanes of four pixels and merge them
+			const __m128  lof = _mm_castsi128_ps(loLanes);
+			const __m128  hif = _mm_castsi128_ps(hiLanes);
+			const __m128i bg = _mm_castps_si128(_mm_shuffle_ps(lof, hif, _MM_SHUFFLE(2, 0, 2, 0)));
+			const __m128i ra = _mm_castps_si128(_mm_shuffle_ps(lof, hif, _MM_SHUFFLE(3, 1, 3, 1)));
+			_mm_storeu_si128(reinterpret_cast<__m128i*>(a_out + x), _mm_or_si128(_mm_slli_epi32(bg, 10), ra));
+		}
+
+		for (; x < a_width; ++x) {
+			const auto* pixel = a_bgra + x * 4;
+			a_out[x] = detail::to_10bit(pixel[2]) | detail::to_10bit(pixel[1]) << 10 | detail::to_10bit(pixel[0]) << 20 | (detail::to_10bit(pixel[3]) >> 8) << 30;
+		}
+	}
+}
@@ -0,0 +1,9 @@
+#pragma once
+
+// 10 bits per channel for high bit depth frames, the same 4 bytes a pixel as BGRA.
+// Takes 16-bit BGRA (what OpenCV decodes 16-bit PNGs to) and writes DXGI_FORMAT_R10G10B10A2_UNORM: red in the low bits, 2-bit alpha on top.
+namespace R10G10B10A2
+{
+	// one row, SSE2, each channel rounded to the nearest 10-bit level. Written in a single pass, so a_out can be mapped texture memory
+	void PackRow(const std::uint16_t* a_bgra, std::uint32_t* a_out, std::uint32_t a_width);
+}
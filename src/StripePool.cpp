@@ -0,0 +1,81 @@
+#include "StripePool.h"
+
+StripePool::StripePool(std::uint32_t a_threads)
+{
+	for (std::uint32_t i = 0; i < a_threads; ++i) {
+		helpers.emplace_back([this](std::stop_token st) {
+			std::uint32_t seen = 0;
+			while (true) {
+				{
+					Locker locker(lock);
+					if (!workCV.wait(locker, st, [&] { return generation != seen; })) {
+						return;
+					}
+					seen = generation;
+				}
+				RunStripes(seen);
+			}
+		});
+	}
+}
+
+std::uint32_t StripePool::GetThreadCount() const
+{
+	return static_cast<std::uint32_t>(helpers.size());
+}
+
+void StripePool::Run(int a_rows, int a_minRows, const Job& a_job)
+{
+	// a couple of stripes per thread, so one that starts late doesn't hold up the rest
+	const int threads = static_cast<int>(helpers.size()) + 1;
+	const int count = std::clamp(a_rows / std::max(a_minRows, 1), 1, threads * 2);
+
+	std::uint32_t runGeneration = 0;
+	{
+		Locker locker(lock);
+		job = &a_job;
+		rows = a_rows;
+		stripeRows = (a_rows + count - 1) / count;
+		stripeCount = count;
+		nextStripe = 0;
+		remaining = count;
+		runGeneration = ++generation;
+	}
+	workCV.notify_all();
+
+	RunStripes(runGeneration);
+
+	Locker locker(lock);
+	doneCV.wait(locker, [this] { return remaining == 0; });
+	job = nullptr;
+}
+
+void StripePool::RunStripes(std::uint32_t a_generation)
+{
+	while (true) {
+		const Job* current = nullptr;
+		int        begin = 0;
+		int        end = 0;
+		{
+			Locker locker(lock);
+			if (generation != a_generation || nextStripe >= stripeCount) {
+				return;
+			}
+			current = job;
+			begin = nextStripe++ * stripeRows;
+			end = std::min(begin + stripeRows, rows);
+		}
+
+		if (begin < end) {
+			(*current)(begin, end);
+		}
+
+		{
+			Locker locker(lock);
+			if (--remaining > 0) {
+				continue;
+			}
+		}
+		doneCV.notify_all();
+	}
+}
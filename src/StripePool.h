@@ -0,0 +1,39 @@
+#pragma once
+
+// Splits a job over rows into horizontal stripes, run on a few helper threads and the calling thread.
+// No dependencies beyond the standard library; shared with tests/.
+class StripePool
+{
+public:
+	using Job = std::function<void(int, int)>;  // [begin, end) rows
+
+	explicit StripePool(std::uint32_t a_threads);
+	StripePool(const StripePool&) = delete;
+	~StripePool() = default;
+
+	StripePool& operator=(const StripePool&) = delete;
+
+	std::uint32_t GetThreadCount() const;
+
+	// returns once every stripe is done, stripes are at least a_minRows tall
+	void Run(int a_rows, int a_minRows, const Job& a_job);
+
+private:
+	using Lock = std::mutex;
+	using Locker = std::unique_lock<Lock>;
+
+	void RunStripes(std::uint32_t a_generation);
+
+	// members
+	const Job*                  job{ nullptr };
+	int                         rows{ 0 };
+	int                         stripeRows{ 0 };
+	int                         stripeCount{ 0 };
+	int                         nextStripe{ 0 };
+	int                         remaining{ 0 };
+	std::uint32_t               generation{ 0 };  // bumped per run, so a late helper can't pick up a finished one
+	Lock                        lock;
+	std::condition_variable_any workCV;
+	std::condition_variable_any doneCV;
+	std::vector<std::jthread>   helpers;  // last, so they stop before anything they use is destroyed
+};
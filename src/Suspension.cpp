@@ -0,0 +1,24 @@
+#include "Suspension.h"
+
+namespace Suspension
+{
+	bool WaitUntilVisible(const Visibility::Source& a_source, std::stop_token a_st, std::chrono::milliseconds a_pollInterval)
+	{
+		while (!a_source.IsVisible()) {
+			if (a_st.stop_requested()) {
+				return false;
+			}
+			std::this_thread::sleep_for(a_pollInterval);
+		}
+		return true;
+	}
+
+	Resume GetResume(Clock::time_point a_suspendStart, Clock::time_point a_now, Clock::time_point a_playbackStart, bool a_audioPlaying)
+	{
+		Resume resume;
+		resume.suspendedFor = a_now - a_suspendStart;
+		resume.seek = a_audioPlaying;
+		resume.position = a_audioPlaying ? a_now - a_playbackStart : a_suspendStart - a_playbackStart;
+		return resume;
+	}
+}
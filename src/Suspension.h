@@ -0,0 +1,23 @@
+#pragma once
+
+#include "Clock.h"
+#include "Visibility.h"
+
+// Pausing the video while the game isn't visible and where it picks up again, apart from the player so it can run
+// against a fake visibility source and clock.
+namespace Suspension
+{
+	struct Resume
+	{
+		Clock::duration suspendedFor{ 0.0 };  // on the playback clock
+		bool            seek{ false };        // audio played on, the video catches up to it at position
+		Clock::duration position{ 0.0 };      // into the video
+	};
+
+	// blocks until a_source is visible again, polled in real time: a virtual clock would spin here and move its timeline
+	// on with nothing decoded. false if a_st stopped the wait first
+	bool WaitUntilVisible(const Visibility::Source& a_source, std::stop_token a_st, std::chrono::milliseconds a_pollInterval);
+
+	// a_playbackStart is when the first frame was due; without audio nothing moved on, so playback carries on where it stopped
+	Resume GetResume(Clock::time_point a_suspendStart, Clock::time_point a_now, Clock::time_point a_playbackStart, bool a_audioPlaying);
+}
@@ -0,0 +1,92 @@
+#include "Telemetry.h"
+
+#include "Memory.h"
+
+namespace Telemetry
+{
+	Writer::~Writer()
+	{
+		Close();
+	}
+
+	bool Writer::Open()
+	{
+		Close();
+
+		auto path = logger::log_directory();
+		if (!path) {
+			return false;
+		}
+		*path /= std::format("{}.stats", Version::PROJECT);
+
+		// readers may still have the file mapped from an earlier session, so it's reused rather than truncated
+		file = CreateFileW(path->c_str(), GENERIC_READ | GENERIC_WRITE, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, nullptr);
+		if (file == INVALID_HANDLE_VALUE) {
+			logger::warn("Telemetry: unable to open {}", path->string());
+			return false;
+		}
+
+		// grows the file to fit if it's new
+		mapping = CreateFileMappingW(file, nullptr, PAGE_READWRITE, 0, sizeof(Block), nullptr);
+		if (mapping) {
+			block = static_cast<Block*>(MapViewOfFile(mapping, FILE_MAP_WRITE, 0, 0, sizeof(Block)));
+		}
+		if (!block) {
+			logger::warn("Telemetry: unable to map {}", path->string());
+			Close();
+			return false;
+		}
+
+		// an earlier session's sequence keeps counting, so a reader that stayed open sees the restart as one more update
+		if (block->magic != magic || block->version != version || block->statsSize != sizeof(Stats)) {
+			block->sequence.store(0, std::memory_order_relaxed);
+		} else if (const auto sequence = block->sequence.load(std::memory_order_relaxed); sequence & 1) {
+			block->sequence.store(sequence + 1, std::memory_order_relaxed);  // that session ended mid-update
+		}
+		block->magic = magic;
+		block->version = version;
+		block->statsSize = sizeof(Stats);
+
+		Publish({});
+		logger::info("Telemetry: publishing live stats to {}", path->string());
+		return true;
+	}
+
+	void Writer::Close()
+	{
+		Locker locker(lock);
+		if (block) {
+			UnmapViewOfFile(block);
+			block = nullptr;
+		}
+		if (mapping) {
+			CloseHandle(mapping);
+			mapping = nullptr;
+		}
+		if (file != INVALID_HANDLE_VALUE) {
+			CloseHandle(file);
+			file = INVALID_HANDLE_VALUE;
+		}
+	}
+
+	bool Writer::IsOpen() const
+	{
+		return block != nullptr;
+	}
+
+	void Writer::Publish(Stats a_stats)
+	{
+		Locker locker(lock);
+		if (!block) {
+			return;
+		}
+
+		const auto tracker = Memory::Tracker::GetSingleton();
+		a_stats.updateTime = static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+		a_stats.memoryBytes = tracker->GetTotalUsage();
+		a_stats.peakMemoryBytes = tracker->GetPeakUsage();
+		a_stats.memoryBudget = tracker->GetBudget();
+
+		Store(*block, a_stats);
+	}
+}
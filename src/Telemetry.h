@@ -0,0 +1,35 @@
+#pragma once
+
+#include "TelemetryBlock.h"
+
+namespace Telemetry
+{
+	// maps <log directory>/po3_MainMenuVideo.stats, which outlives the game so readers can be started at any time
+	class Writer
+	{
+	public:
+		Writer() = default;
+		Writer(const Writer&) = delete;
+		~Writer();
+
+		Writer& operator=(const Writer&) = delete;
+
+		bool Open();
+		void Close();
+
+		bool IsOpen() const;
+
+		// stamps the time and memory use, the rest is the caller's. Safe from any thread
+		void Publish(Stats a_stats);
+
+	private:
+		using Lock = std::mutex;
+		using Locker = std::scoped_lock<Lock>;
+
+		// members
+		HANDLE file{ INVALID_HANDLE_VALUE };
+		HANDLE mapping{ nullptr };
+		Block* block{ nullptr };
+		Lock   lock;  // there's only ever one writer to the block
+	};
+}
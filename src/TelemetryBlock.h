@@ -0,0 +1,97 @@
+#pragma once
+
+// Layout of the live stats file written with [Debug] bTelemetry, shared with tools/StatsReader.
+// One writer and any number of readers in other processes: the writer never waits on them, a reader that catches an
+// update halfway simply copies again (a sequence lock).
+namespace Telemetry
+{
+	inline constexpr std::uint32_t magic{ 0x544D4D4D };  // MMMT
+	inline constexpr std::uint32_t version{ 1 };
+
+	enum class State : std::uint32_t
+	{
+		kIdle,
+		kPlaying,
+		kSuspended
+	};
+
+	// copied in and out of the block whole. Fields are only ever appended, with a version bump
+	struct Stats
+	{
+		std::uint64_t updateTime{ 0 };      // ms since the Unix epoch; a playing block that stops changing belongs to a closed game
+		std::uint64_t frames{ 0 };          // published since the video was loaded, loops included
+		std::uint64_t droppedFrames{ 0 };   // skipped by adaptive quality or for repeating a timestamp
+		std::uint64_t repeatedFrames{ 0 };  // identical to the frame on screen, neither converted nor uploaded
+		std::int64_t  memoryBytes{ 0 };
+		std::int64_t  peakMemoryBytes{ 0 };
+		std::int64_t  memoryBudget{ 0 };  // 0 = unlimited
+		double        elapsed{ 0.0 };     // seconds into the current loop
+		double        cpuTime{ 0.0 };     // seconds of CPU the video thread has used
+		State         state{ State::kIdle };
+		std::uint32_t width{ 0 };
+		std::uint32_t height{ 0 };
+		std::uint32_t queuedFrames{ 0 };  // decoded ahead of playback and waiting
+		std::uint32_t qualityLevel{ 0 };
+		float         targetFPS{ 0.0f };
+		float         actualFPS{ 0.0f };
+		float         decodeTime{ 0.0f };  // ms, the last frame
+		float         uploadTime{ 0.0f };  // ms per frame, over the last second
+		float         decodeOccupancy{ 0.0f };
+		float         convertOccupancy{ 0.0f };
+		float         drift{ 0.0f };  // ms the last frame was handed on after it was due, negative if early
+		char          video[256]{};   // UTF-8, cut short if it doesn't fit
+	};
+	static_assert(std::is_trivially_copyable_v<Stats> && sizeof(Stats) % sizeof(std::uint64_t) == 0);
+
+	inline constexpr std::size_t statsWords{ sizeof(Stats) / sizeof(std::uint64_t) };
+
+	struct Block
+	{
+		std::uint32_t                                        magic;
+		std::uint32_t                                        version;
+		std::uint32_t                                        statsSize;
+		std::atomic<std::uint32_t>                           sequence;  // odd while an update is being written, 0 before the first
+		std::array<std::atomic<std::uint64_t>, statsWords> data;
+	};
+	static_assert(std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<std::uint32_t>::is_always_lock_free);
+
+	inline void Store(Block& a_block, const Stats& a_stats)
+	{
+		const auto words = std::bit_cast<std::array<std::uint64_t, statsWords>>(a_stats);
+
+		const auto sequence = a_block.sequence.load(std::memory_order_relaxed);
+		a_block.sequence.store(sequence + 1, std::memory_order_relaxed);
+		std::atomic_thread_fence(std::memory_order_release);
+		for (std::size_t i = 0; i < statsWords; ++i) {
+			a_block.data[i].store(words[i], std::memory_order_relaxed);
+		}
+		a_block.sequence.store(sequence + 2, std::memory_order_release);
+	}
+
+	// false if nothing was written yet, the block is from another version, or every attempt raced an update
+	inline bool Load(const Block& a_block, Stats& a_stats)
+	{
+		for (std::uint32_t attempt = 0; attempt < 64; ++attempt) {
+			const auto before = a_block.sequence.load(std::memory_order_acquire);
+			if (before == 0 || a_block.magic != magic || a_block.version != version || a_block.statsSize != sizeof(Stats)) {
+				return false;
+			}
+			if (before & 1) {
+				std::this_thread::yield();
+				continue;
+			}
+
+			std::array<std::uint64_t, statsWords> words;
+			for (std::size_t i = 0; i < statsWords; ++i) {
+				words[i] = a_block.data[i].load(std::memory_order_relaxed);
+			}
+			std::atomic_thread_fence(std::memory_order_acquire);
+
+			if (a_block.sequence.load(std::memory_order_relaxed) == before) {
+				a_stats = std::bit_cast<Stats>(words);
+				return true;
+			}
+		}
+		return false;
+	}
+}
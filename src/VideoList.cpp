@@ -0,0 +1,58 @@
+#include "VideoList.h"
+
+const std::filesystem::path& VideoEntry::Select(std::uint32_t a_screenHeight) const
+{
+	const auto it = std::ranges::find_if(variants, [&](const auto& variant) { return variant.height >= a_screenHeight; });
+	return it != variants.end() ? it->path : variants.back().path;
+}
+
+namespace VideoList
+{
+	std::pair<std::string, std::uint32_t> SplitHeight(const std::filesystem::path& a_path)
+	{
+		const auto stem = a_path.stem().string();
+		const auto dot = stem.rfind('.');
+		if (dot == std::string::npos || dot == 0) {
+			return { stem, originalHeight };
+		}
+
+		std::string_view suffix(stem.begin() + dot + 1, stem.end());
+		if (suffix.ends_with('p') || suffix.ends_with('P')) {
+			suffix.remove_suffix(1);
+		}
+
+		std::uint32_t height = 0;
+		const auto [ptr, ec] = std::from_chars(suffix.data(), suffix.data() + suffix.size(), height);
+		// anything outside plausible video heights is part of the name ("episode.2.mp4")
+		if (ec != std::errc() || ptr != suffix.data() + suffix.size() || height < 100 || height > 10000) {
+			return { stem, originalHeight };
+		}
+
+		return { stem.substr(0, dot), height };
+	}
+
+	std::vector<VideoEntry> Group(const std::vector<std::filesystem::path>& a_paths)
+	{
+		std::vector<VideoEntry> entries;
+
+		for (const auto& path : a_paths) {
+			auto [name, height] = SplitHeight(path);
+
+			// variants must share a folder, the same name in two places is two videos
+			auto key = (path.parent_path() / name).string();
+			key = clib_util::string::tolower(key);
+
+			auto it = std::ranges::find(entries, key, &VideoEntry::name);
+			if (it == entries.end()) {
+				it = entries.insert(entries.end(), VideoEntry{ key, {} });
+			}
+			it->variants.push_back({ height, path });
+		}
+
+		for (auto& entry : entries) {
+			std::ranges::sort(entry.variants, {}, &VideoEntry::Variant::height);
+		}
+
+		return entries;
+	}
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+// One entry per video, with every resolution variant shipped for it.
+// Variants follow a <name>.<height>.<ext> convention (intro.2160.mp4, intro.1080p.mp4), a file without a height is treated as the full size original.
+struct VideoEntry
+{
+	struct Variant
+	{
+		std::uint32_t         height;
+		std::filesystem::path path;
+	};
+
+	// smallest variant that still covers the screen, or the largest one if none do
+	const std::filesystem::path& Select(std::uint32_t a_screenHeight) const;
+
+	// members
+	std::string          name;
+	std::vector<Variant> variants;  // ascending height
+};
+
+namespace VideoList
+{
+	inline constexpr std::uint32_t originalHeight = std::numeric_limits<std::uint32_t>::max();
+
+	// "intro.1080p.mp4" -> { "intro", 1080 }, "intro.mp4" -> { "intro", originalHeight }
+	std::pair<std::string, std::uint32_t> SplitHeight(const std::filesystem::path& a_path);
+	std::vector<VideoEntry>               Group(const std::vector<std::filesystem::path>& a_paths);
+}
@@ -1,15 +1,95 @@
 #include "VideoPlayer.h"
 
+#include "Archive.h"
+#include "B5G6R5.h"
+#include "BC1.h"
+#include "Cache.h"
+#include "ConvertStage.h"
+#include "FrameFormat.h"
+#include "FrameHash.h"
+#include "FrameUpload.h"
 #include "Manager.h"
+#include "QOI.h"
 
-ImGui::Texture::Texture(ID3D11Device* device, std::uint32_t a_width, std::uint32_t a_height)
+namespace
 {
+	// frames can share buffers (4 channel sources are published without conversion), count each buffer once
+	std::int64_t get_frame_bytes(std::initializer_list<const cv::Mat*> a_mats)
+	{
+		std::int64_t                     bytes = 0;
+		std::vector<const std::uint8_t*> seen;
+		for (const auto* mat : a_mats) {
+			if (mat->empty() || std::ranges::find(seen, mat->data) != seen.end()) {
+				continue;
+			}
+			seen.push_back(mat->data);
+			bytes += static_cast<std::int64_t>(mat->total() * mat->elemSize());
+		}
+		return bytes;
+	}
+
+	std::string_view get_format_name(DXGI_FORMAT a_format)
+	{
+		switch (a_format) {
+		case DXGI_FORMAT_BC1_UNORM:
+			return "BC1"sv;
+		case DXGI_FORMAT_B5G6R5_UNORM:
+			return "B5G6R5"sv;
+		case DXGI_FORMAT_R10G10B10A2_UNORM:
+			return "R10G10B10A2"sv;
+		default:
+			return "BGRA"sv;
+		}
+	}
+
+	// seconds of CPU the calling thread has used
+	double get_thread_cpu_time()
+	{
+		FILETIME creationTime{}, exitTime{}, kernelTime{}, userTime{};
+		if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime)) {
+			return 0.0;
+		}
+		const auto to_ticks = [](const FILETIME& a_time) {
+			return std::uint64_t(a_time.dwHighDateTime) << 32 | a_time.dwLowDateTime;
+		};
+		return static_cast<double>(to_ticks(kernelTime) + to_ticks(userTime)) / 1e7;  // 100 ns ticks
+	}
+
+	// joins a_thread if it exits before a_deadline, otherwise leaves it running
+	bool join_before(std::jthread& a_thread, std::chrono::steady_clock::time_point a_deadline)
+	{
+		if (!a_thread.joinable()) {
+			return true;
+		}
+
+		DWORD timeout = INFINITE;
+		if (a_deadline != std::chrono::steady_clock::time_point::max()) {
+			const auto remaining = std::chrono::ceil<std::chrono::milliseconds>(a_deadline - std::chrono::steady_clock::now());
+			timeout = static_cast<DWORD>(std::max<std::int64_t>(remaining.count(), 0));
+		}
+
+		if (WaitForSingleObject(a_thread.native_handle(), timeout) != WAIT_OBJECT_0) {
+			return false;
+		}
+		a_thread.join();
+		return true;
+	}
+}
+
+ImGui::Texture::Texture(ID3D11Device* device, std::uint32_t a_width, std::uint32_t a_height, DXGI_FORMAT a_format)
+{
+	// block compressed textures must cover whole 4x4 blocks, the encoder fills the padding with edge pixels
+	if (a_format == DXGI_FORMAT_BC1_UNORM) {
+		a_width = BC1::GetBlockCount(a_width) * 4;
+		a_height = BC1::GetBlockCount(a_height) * 4;
+	}
+
 	D3D11_TEXTURE2D_DESC desc{
 		.Width = a_width,
 		.Height = a_height,
 		.MipLevels = 1,
 		.ArraySize = 1,
-		.Format = DXGI_FORMAT_B8G8R8A8_UNORM,
+		.Format = a_format,
 		.SampleDesc = { 1, 0 },
 		.Usage = D3D11_USAGE_DYNAMIC,
 		.BindFlags = D3D11_BIND_SHADER_RESOURCE,
@@ -25,30 +105,309 @@ ImGui::Texture::Texture(ID3D11Device* device, std::uint32_t a_width, std::uint32
 	}
 }
 
-void ImGui::Texture::Update(ID3D11DeviceContext* context, const cv::Mat& mat) const
+std::size_t ImGui::Texture::Update(ID3D11DeviceContext* context, const cv::Mat& mat) const
 {
 	D3D11_MAPPED_SUBRESOURCE mapped{};
-	if (SUCCEEDED(context->Map(texture.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
-		constexpr std::uint32_t bytesPerPixel = 4;  // BGRA
-		const auto              srcRowBytes = mat.cols * bytesPerPixel;
+	if (FAILED(context->Map(texture.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+		return 0;
+	}
 
-		if (mapped.RowPitch == srcRowBytes) {
-			std::memcpy(mapped.pData, mat.data, mat.rows * srcRowBytes);
-		} else {
-			auto* dst = static_cast<std::uint8_t*>(mapped.pData);
-			for (std::int32_t y = 0; y < mat.rows; ++y) {
-				std::memcpy(dst + y * mapped.RowPitch, mat.ptr<uchar>(y), srcRowBytes);
-			}
+	const auto bytes = FrameUpload::WriteRows(mat, mapped.pData, mapped.RowPitch);
+	context->Unmap(texture.Get(), 0);
+	return bytes;
+}
+
+std::size_t ImGui::Texture::Update(ID3D11DeviceContext* context, const cv::Mat& from, const cv::Mat& to, std::uint32_t weight) const
+{
+	D3D11_MAPPED_SUBRESOURCE mapped{};
+	if (FAILED(context->Map(texture.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mapped))) {
+		return 0;
+	}
+
+	const auto bytes = FrameUpload::WriteBlendedRows(from, to, weight, mapped.pData, mapped.RowPitch);
+	context->Unmap(texture.Get(), 0);
+	return bytes;
+}
+
+void VideoPlayer::LoadSettings(CSimpleIniA& a_ini)
+{
+	ini::get_value(a_ini, randomStart, "Settings", "bRandomStart", ";Start videos at a random keyframe instead of the beginning (each video is indexed the first time it plays)");
+
+	ini::get_value(a_ini, warmStartEnabled, "Settings", "bWarmStart", ";Open the first video while the game is still starting up, so it starts instantly when the first loading screen appears");
+
+	ini::get_value(a_ini, skipRepeatedFrames, "Settings", "bSkipRepeatedFrames", ";Don't convert or upload decoded frames identical to the one already on screen (slideshows, held shots)");
+
+	ini::get_value(a_ini, teardownTimeoutMs, "Settings", "iTeardownTimeoutMs", ";Longest time stopping playback waits for a blocked decoder before finishing cleanup in the background, in milliseconds");
+
+	ini::get_value(a_ini, usePosterCache, "Cache", "bPosterFrames", ";Save the first frame of each video and show it instantly while the video starts up");
+
+	ini::get_value(a_ini, bakeLoops, "Cache", "bBakeLoops", ";Compress looping videos to BC1 while they play, later boots upload the compressed frames directly instead of decoding");
+	ini::get_value(a_ini, maxBakeSizeMB, "Cache", "iMaxBakeSizeMB", ";Largest compressed video to keep on disk, in megabytes");
+
+	ini::get_value(a_ini, useAudioCache, "Cache", "bAudioCache", ";Keep each video's decoded audio track on disk, so loops and later boots play it without decoding");
+	ini::get_value(a_ini, maxAudioCacheMB, "Cache", "iMaxAudioCacheMB", ";Largest decoded audio track to keep on disk, in megabytes");
+
+	qualityController.LoadSettings(a_ini);
+	watchdog.LoadSettings(a_ini);
+	sequence.LoadSettings(a_ini);
+
+	ini::get_value(a_ini, pipelinedConversion, "Pipeline", "bPipelinedConversion", ";Convert each frame on a thread of its own while the next one decodes, instead of one after the other");
+	ini::get_value(a_ini, convertThreads, "Pipeline", "iConvertThreads", ";Extra threads converting large frames in stripes (0 - a quarter of the cores, at most 3)");
+	ini::get_value(a_ini, use16BitFrames, "Pipeline", "b16BitFrames", ";Upload frames as 16-bit colour (B5G6R5), half the bandwidth of 32-bit, for integrated GPUs and handhelds");
+	ini::get_value(a_ini, ditherFrames, "Pipeline", "bDither16BitFrames", ";Dither 16-bit frames, hiding the banding fewer colour levels leave in gradients");
+	ini::get_value(a_ini, blendFrames, "Pipeline", "bBlendFrames", ";Fade each frame into the next on displays refreshing at least 1.5x faster than the video, smoother motion for a frame of latency (32-bit frames only)");
+	ini::get_value(a_ini, blendBudgetMs, "Pipeline", "fBlendBudgetMs", ";Blending turns itself off if mixing and uploading a frame averages longer than this over a second, in milliseconds");
+
+	// developer only: read if someone added it, never written into the ini the way the user-facing settings are
+	simulateTime = a_ini.GetBoolValue("Debug", "bSimulateTime", simulateTime);
+	if (simulateTime) {
+		SetClock(std::make_unique<VirtualClock>());
+	}
+	ini::get_value(a_ini, telemetryEnabled, "Debug", "bTelemetry", ";Publish live playback stats every frame to po3_MainMenuVideo.stats next to the log, for tools/StatsReader or QA scripts");
+	if (telemetryEnabled) {
+		telemetry.Open();
+	}
+}
+
+bool VideoPlayer::OpenCapture(const std::string& path)
+{
+	const auto             acceleration = softwareDecode.load(std::memory_order_relaxed) ? cv::VIDEO_ACCELERATION_NONE : cv::VIDEO_ACCELERATION_ANY;
+	const std::vector<int> params{ cv::CAP_PROP_HW_ACCELERATION, acceleration };
+
+	// archived videos are demuxed straight from a mapped view of the archive
+	if (const auto reader = Archive::CreateStreamReader(path)) {
+		return cap.open(reader, cv::CAP_MSMF, params);
+	}
+	return cap.open(path, cv::CAP_MSMF, params);
+}
+
+bool VideoPlayer::LoadDecoderFallback(const std::string& path) const
+{
+	const auto stamp = Cache::GetStamp(path);
+	const auto cachePath = Cache::GetPath(path, ".swdecode"sv);
+	return watchdog.IsEnabled() && stamp && cachePath && Cache::Read(*cachePath, fallbackMagic, *stamp);
+}
+
+void VideoPlayer::SaveDecoderFallback(const std::string& path)
+{
+	const auto stamp = Cache::GetStamp(path);
+	const auto cachePath = Cache::GetPath(path, ".swdecode"sv);
+	if (stamp && cachePath) {
+		Cache::Write(*cachePath, fallbackMagic, *stamp, {});
+	}
+}
+
+void VideoPlayer::FallBackToSoftwareDecode(duration a_position)
+{
+	logger::warn("Hardware decoding of {} keeps missing its frame budget, reopening at {:.2f}s with software decoding", currentVideo, a_position.count());
+
+	softwareDecode.store(true, std::memory_order_relaxed);
+	SaveDecoderFallback(currentVideo);
+
+	cap.release();
+	if (OpenCapture(currentVideo) && a_position > duration(0.0)) {
+		SeekVideo(a_position);
+	}
+	watchdog.Start(frameDuration);
+}
+
+bool VideoPlayer::OpenBakedVideo(const std::string& path)
+{
+	if (!bakeLoops || playbackMode != PLAYBACK_MODE::kLoop) {
+		return false;
+	}
+
+	const auto stamp = Cache::GetStamp(path);
+	const auto cachePath = Cache::GetPath(path, ".bc1"sv);
+	return stamp && cachePath && bakedVideo.Open(*cachePath, *stamp);
+}
+
+void VideoPlayer::BeginBake()
+{
+	if (!bakeLoops || playbackMode != PLAYBACK_MODE::kLoop || bakedVideo.IsOpen() || frameCount == 0) {
+		return;
+	}
+
+	const auto size = BakedVideo::GetSize(videoWidth, videoHeight, frameCount);
+	if (size > std::uint64_t(maxBakeSizeMB) * 1024 * 1024) {
+		logger::info("\tNot baking, {} MB exceeds iMaxBakeSizeMB", size / (1024 * 1024));
+		return;
+	}
+
+	// the encoder needs room for at least a couple of queued frames
+	if (!Memory::Tracker::GetSingleton()->CanAllocate(std::int64_t(videoWidth) * videoHeight * 4 * 2)) {
+		logger::info("\tNot baking, memory budget is exhausted");
+		return;
+	}
+
+	const auto stamp = Cache::GetStamp(currentVideo);
+	const auto cachePath = Cache::GetPath(currentVideo, ".bc1"sv);
+	if (!stamp || !cachePath) {
+		return;
+	}
+
+	bakeWriter = std::make_unique<BakedVideo::Writer>();
+	if (!bakeWriter->Begin(*cachePath, *stamp, videoWidth, videoHeight, targetFPS)) {
+		bakeWriter.reset();
+	}
+}
+
+void VideoPlayer::LoadKeyframeIndex(const std::string& path)
+{
+	if (auto index = KeyframeIndex::Load(path)) {
+		keyframeIndex.store(std::make_shared<const KeyframeIndex>(std::move(*index)), std::memory_order_release);
+		return;
+	}
+
+	// demuxing a long video takes a while, don't hold up the first frame for it
+	indexThread = std::jthread([this, path](std::stop_token st) {
+		SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN);
+		if (auto index = KeyframeIndex::Build(path, st)) {
+			keyframeIndex.store(std::make_shared<const KeyframeIndex>(std::move(*index)), std::memory_order_release);
 		}
-		context->Unmap(texture.Get(), 0);
+		SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END);
+	});
+}
+
+VideoPlayer::duration VideoPlayer::GetRandomStartOffset() const
+{
+	if (!randomStart) {
+		return duration(0.0);
+	}
+
+	// every baked or sequence frame can be jumped to
+	if (bakedVideo.IsOpen() || sequence.IsOpen()) {
+		const auto lastFrame = static_cast<std::uint32_t>(frameCount * randomStartMaxFraction);
+		return frameDuration * clib_util::RNG().generate<std::uint32_t>(0, lastFrame);
+	}
+
+	const auto index = keyframeIndex.load(std::memory_order_acquire);
+	if (!index) {
+		return duration(0.0);  // still being built
 	}
+
+	const auto lastKeyframe = index->FindBefore(index->GetDuration() * randomStartMaxFraction);
+	return index->GetTime(clib_util::RNG().generate<std::size_t>(0, lastKeyframe));
+}
+
+bool VideoPlayer::SeekVideo(duration a_position)
+{
+	const auto seekStart = std::chrono::steady_clock::now();
+
+	// land on the keyframe at or before the target, then decode forward to it
+	auto keyframe = a_position;
+	if (const auto index = keyframeIndex.load(std::memory_order_acquire); index && index->GetCount() > 0) {
+		keyframe = std::min(index->GetTime(index->FindBefore(a_position)), a_position);
+	}
+
+	const bool seeked = cap.set(cv::CAP_PROP_POS_MSEC, keyframe.count() * 1000.0);
+	if (seeked) {
+		for (auto position = keyframe; position + frameDuration <= a_position && cap.grab(); position += frameDuration) {}
+	}
+	const auto seekTime = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - seekStart).count();
+
+	lastSeekTime.store(seekTime, std::memory_order_relaxed);
+	logger::info("\tSeek to {:.2f}s took {:.1f} ms{}", a_position.count(), seekTime, seeked ? "" : " (failed)");
+
+	return seeked;
+}
+
+void VideoPlayer::SeekAudio(duration a_position)
+{
+	if (cachedAudio.IsOpen()) {
+		cachedAudioStart = a_position;
+		return;
+	}
+	if (!audioReader) {
+		return;
+	}
+
+	if (audioCacheWriter && a_position > duration(0.0)) {
+		audioCacheWriter->Abort("playback didn't start at the beginning"sv);
+	}
+
+	PROPVARIANT position;
+	if (SUCCEEDED(InitPropVariantFromInt64(static_cast<LONGLONG>(a_position.count() * 1e7), &position))) {
+		audioReader->SetCurrentPosition(GUID_NULL, position);
+		PropVariantClear(&position);
+	}
+}
+
+bool VideoPlayer::LoadPoster()
+{
+	if (!usePosterCache) {
+		return false;
+	}
+
+	const auto stamp = Cache::GetStamp(currentVideo);
+	const auto path = Cache::GetPath(currentVideo, ".qoi"sv);
+	if (!stamp || !path) {
+		return false;
+	}
+
+	const auto data = Cache::Read(*path, posterMagic, *stamp);
+	if (!data) {
+		return false;
+	}
+
+	QOI::Image image;
+	if (!QOI::Decode(*data, image) || image.width != videoWidth || image.height != videoHeight) {
+		return false;
+	}
+
+	Memory::Usage imageMemory(Memory::Category::kCache);
+	imageMemory.Set(static_cast<std::int64_t>(image.pixels.size()));
+
+	cv::Mat poster(static_cast<int>(image.height), static_cast<int>(image.width), CV_8UC4, image.pixels.data());
+	{
+		WriteLocker lock(videoFrameLock);
+		videoFrame = poster.clone();
+		frameMemory.Set(get_frame_bytes({ &videoFrame }));
+	}
+	videoFrameSerial.fetch_add(1, std::memory_order_release);
+
+	return true;
+}
+
+void VideoPlayer::SavePoster()
+{
+	const auto stamp = Cache::GetStamp(currentVideo);
+	const auto path = Cache::GetPath(currentVideo, ".qoi"sv);
+	if (!stamp || !path) {
+		return;
+	}
+
+	// posters are kept as 8-bit BGRA, whatever the texture takes
+	cv::Mat poster;
+	{
+		ReadLocker lock(videoFrameLock);
+		if (!FrameFormat::ToBGRA8(videoFrame, videoWidth, videoHeight, poster)) {
+			return;
+		}
+	}
+
+	// encoding a full frame takes a few ms, keep it off the decode loop
+	std::jthread([path = *path, stamp = *stamp, poster = std::move(poster)]() {
+		Memory::Usage posterMemory(Memory::Category::kCache);
+		posterMemory.Set(get_frame_bytes({ &poster }));
+
+		const auto data = QOI::Encode(poster.data, static_cast<std::uint32_t>(poster.cols), static_cast<std::uint32_t>(poster.rows), poster.step);
+		if (data.empty() || !Cache::Write(path, posterMagic, stamp, data)) {
+			logger::warn("Couldn't save poster frame {}", path.string());
+		}
+	}).detach();
 }
 
 // https://stackoverflow.com/a/54946067
 // convert video to use MF? later
 bool VideoPlayer::LoadAudio(const std::string& path)
 {
-	HRESULT hr = MFCreateSourceReaderFromURL(stl::utf8_to_utf16(path)->c_str(), nullptr, &audioReader);
+	if ((cachedAudio.IsOpen() || OpenAudioCache(path)) && LoadCachedAudio()) {
+		return true;
+	}
+	cachedAudio.Close();
+
+	HRESULT hr = Archive::CreateSourceReader(path, nullptr, &audioReader);
 	if (SUCCEEDED(hr)) {  // Select only the audio stream
 		hr = audioReader->SetStreamSelection((DWORD)MF_SOURCE_READER_ALL_STREAMS, FALSE);
 		if (SUCCEEDED(hr)) {
@@ -79,27 +438,9 @@ bool VideoPlayer::LoadAudio(const std::string& path)
 									hr = audioReader->SetCurrentMediaType((DWORD)MF_SOURCE_READER_FIRST_AUDIO_STREAM, NULL, inputType.Get());
 									if (SUCCEEDED(hr)) {
 										hr = typeHandler->SetCurrentMediaType(inputType.Get());
-										ComPtr<IMFAttributes> sinkWriterAttributes;
-										hr = MFCreateAttributes(&sinkWriterAttributes, 1);
-										if (SUCCEEDED(hr)) {
-											hr = sinkWriterAttributes->SetUINT32(MF_READWRITE_ENABLE_HARDWARE_TRANSFORMS, 1);
-											if (SUCCEEDED(hr)) {
-												hr = MFCreateSinkWriterFromMediaSink(mediaSink.Get(), sinkWriterAttributes.Get(), &audioWriter);
-												if (SUCCEEDED(hr)) {
-													hr = audioWriter->SetInputMediaType(0, inputType.Get(), nullptr);
-													if (SUCCEEDED(hr)) {
-														ComPtr<IMFGetService> service;
-														hr = mediaSink.As(&service);
-														if (SUCCEEDED(hr)) {
-															service->GetService(MR_POLICY_VOLUME_SERVICE, IID_PPV_ARGS(&audioVolume));
-														}
-														if (audioVolume) {
-															audioVolume->SetMasterVolume(volume.load(std::memory_order_relaxed));
-														}
-														return true;
-													}
-												}
-											}
+										if (CreateAudioWriter(inputType.Get())) {
+											BeginAudioCache(path, inputType.Get());
+											return true;
 										}
 									}
 								}
@@ -116,6 +457,140 @@ bool VideoPlayer::LoadAudio(const std::string& path)
 	return false;
 }
 
+bool VideoPlayer::CreateAudioWriter(IMFMediaType* a_inputType)
+{
+	ComPtr<IMFAttributes> sinkWriterAttributes;
+	HRESULT               hr = MFCreateAttributes(&sinkWriterAttributes, 1);
+	if (SUCCEEDED(hr)) {
+		hr = sinkWriterAttributes->SetUINT32(MF_READWRITE_ENABLE_HARDWARE_TRANSFORMS, 1);
+		if (SUCCEEDED(hr)) {
+			hr = MFCreateSinkWriterFromMediaSink(mediaSink.Get(), sinkWriterAttributes.Get(), &audioWriter);
+			if (SUCCEEDED(hr)) {
+				hr = audioWriter->SetInputMediaType(0, a_inputType, nullptr);
+				if (SUCCEEDED(hr)) {
+					ComPtr<IMFGetService>        service;
+					ComPtr<IMFSimpleAudioVolume> newVolume;
+					hr = mediaSink.As(&service);
+					if (SUCCEEDED(hr)) {
+						service->GetService(MR_POLICY_VOLUME_SERVICE, IID_PPV_ARGS(&newVolume));
+					}
+					if (newVolume) {
+						newVolume->SetMasterVolume(volume.load(std::memory_order_relaxed));
+					}
+					SetAudioVolume(std::move(newVolume));
+					return true;
+				}
+			}
+		}
+	}
+	return false;
+}
+
+bool VideoPlayer::OpenAudioCache(const std::string& path)
+{
+	if (!useAudioCache) {
+		return false;
+	}
+
+	const auto stamp = Cache::GetStamp(path);
+	const auto cachePath = Cache::GetPath(path, ".pcm"sv);
+	return stamp && cachePath && cachedAudio.Open(*cachePath, *stamp);
+}
+
+// same sink as LoadAudio, but the input type comes from the cache instead of a source reader
+bool VideoPlayer::LoadCachedAudio()
+{
+	ComPtr<IMFMediaType> inputType;
+	HRESULT              hr = MFCreateMediaType(&inputType);
+	if (SUCCEEDED(hr)) {
+		hr = MFInitMediaTypeFromWaveFormatEx(inputType.Get(), cachedAudio.GetFormat(), cachedAudio.GetFormatSize());
+		if (SUCCEEDED(hr)) {
+			hr = MFCreateAudioRenderer(nullptr, &mediaSink);
+			if (SUCCEEDED(hr)) {
+				ComPtr<IMFStreamSink> streamSink;
+				hr = mediaSink->GetStreamSinkByIndex(0, &streamSink);
+				if (SUCCEEDED(hr)) {
+					ComPtr<IMFMediaTypeHandler> typeHandler;
+					hr = streamSink->GetMediaTypeHandler(&typeHandler);
+					// the output device may have changed since the cache was written
+					if (SUCCEEDED(hr) && SUCCEEDED(typeHandler->IsMediaTypeSupported(inputType.Get(), nullptr))) {
+						hr = typeHandler->SetCurrentMediaType(inputType.Get());
+						if (SUCCEEDED(hr) && CreateAudioWriter(inputType.Get())) {
+							cachedAudioStart = duration(0.0);
+							return true;
+						}
+					}
+				}
+			}
+		}
+	}
+
+	ResetAudio();
+
+	return false;
+}
+
+void VideoPlayer::BeginAudioCache(const std::string& path, IMFMediaType* a_inputType)
+{
+	if (!useAudioCache) {
+		return;
+	}
+
+	const auto stamp = Cache::GetStamp(path);
+	const auto cachePath = Cache::GetPath(path, ".pcm"sv);
+	if (!stamp || !cachePath) {
+		return;
+	}
+
+	WAVEFORMATEX* format = nullptr;
+	UINT32        formatSize = 0;
+	if (FAILED(MFCreateWaveFormatExFromMFMediaType(a_inputType, &format, &formatSize))) {
+		return;
+	}
+
+	audioCacheWriter = std::make_unique<AudioCache::Writer>();
+	if (!audioCacheWriter->Begin(*cachePath, *stamp, format, formatSize, std::uint64_t(maxAudioCacheMB) * 1024 * 1024)) {
+		audioCacheWriter.reset();
+	}
+	CoTaskMemFree(format);
+}
+
+void VideoPlayer::PlayCachedAudio(std::stop_token a_st)
+{
+	const auto* format = cachedAudio.GetFormat();
+	const auto  data = cachedAudio.GetData();
+
+	// 100 ms per sample, whole frames only
+	const std::size_t chunkBytes = std::max<std::size_t>(format->nAvgBytesPerSec / 10 / format->nBlockAlign, 1) * format->nBlockAlign;
+	const double      bytesPerTick = format->nAvgBytesPerSec / 1e7;
+
+	std::size_t offset = static_cast<std::size_t>(cachedAudioStart.count() * format->nAvgBytesPerSec) / format->nBlockAlign * format->nBlockAlign;
+	while (offset < data.size() && !a_st.stop_requested()) {
+		const auto bytes = std::min(chunkBytes, data.size() - offset);
+
+		ComPtr<IMFMediaBuffer> buffer;
+		ComPtr<IMFSample>      sample;
+		BYTE*                  dst = nullptr;
+		if (FAILED(MFCreateMemoryBuffer(static_cast<DWORD>(bytes), &buffer)) || FAILED(buffer->Lock(&dst, nullptr, nullptr))) {
+			break;
+		}
+		std::memcpy(dst, data.data() + offset, bytes);
+		buffer->Unlock();
+		buffer->SetCurrentLength(static_cast<DWORD>(bytes));
+
+		if (FAILED(MFCreateSample(&sample)) || FAILED(sample->AddBuffer(buffer.Get()))) {
+			break;
+		}
+		sample->SetSampleTime(static_cast<LONGLONG>(offset / bytesPerTick));
+		sample->SetSampleDuration(static_cast<LONGLONG>(bytes / bytesPerTick));
+
+		if (FAILED(audioWriter->WriteSample(0, sample.Get()))) {
+			break;
+		}
+		offset += bytes;
+	}
+}
+
 void VideoPlayer::CreateVideoThread()
 {
 	if (videoThread.joinable()) {
@@ -131,40 +606,275 @@ void VideoPlayer::CreateVideoThread()
 
 		playbackState.store(PLAYBACK_STATE::kPlaying, std::memory_order_release);
 
-		time_point frameStartTime = clock::now();
-		time_point playbackStart = frameStartTime;
-		time_point debugUpdateInfoTime = frameStartTime;
+		// frames are due at playbackStart + their own timestamp, a random start counts as already elapsed
+		time_point playbackStart = playbackClock->now() - startOffset;
+		time_point measureStart = playbackClock->now();
+		time_point debugUpdateInfoTime = measureStart;
+		time_point realPlaybackStart = std::chrono::steady_clock::now();
+
+		cv::Mat       frame;
+		bool          firstFrame = true;
+		std::uint32_t frameIndex = 0;
+		const bool    baked = bakedVideo.IsOpen();
+		const bool    sequenced = sequence.IsOpen();
+		std::uint32_t bakedFrameIndex = static_cast<std::uint32_t>(startOffset / frameDuration);
+		bool          rewound = false;
+
+		// per-frame timestamps, baked and sequence frames are evenly spaced
+		FrameTimeline timeline(frameDuration, !baked && !sequenced, startOffset);
+		std::uint32_t presentedFrames = 0;
+
+		// what the history keeps of each playthrough
+		std::vector<float> decodeTimes;  // ms
+		std::uint32_t      lateFrames = 0;
+		std::uint32_t      skippedFrames = 0;
+
+		// the last frame that made it to the screen, decoded into alternating buffers so it never has to be copied
+		cv::Mat       previousFrame;
+		std::uint64_t previousFingerprint = 0;
+		duration      compareTime{ 0.0 };
+
+		Telemetry::Stats telemetryStats{};
+		telemetryStats.width = videoWidth;
+		telemetryStats.height = videoHeight;
+		currentVideo.copy(telemetryStats.video, sizeof(telemetryStats.video) - 1);
+
+		// decode on this thread, conversion and publishing on the stage's; baked frames and unpacked sequences need no conversion
+		const bool   packed = frameFormat == DXGI_FORMAT_B5G6R5_UNORM;
+		const auto   output = packed ? (ditherFrames ? ConvertStage::Output::kB5G6R5Dithered : ConvertStage::Output::kB5G6R5) :
+		                       frameFormat == DXGI_FORMAT_R10G10B10A2_UNORM ? ConvertStage::Output::kR10G10B10A2 : ConvertStage::Output::kBGRA;
+		const auto   stripeThreads = baked || (sequenced && !packed) ? 0u : convertThreads > 0 ? convertThreads : std::clamp(std::thread::hardware_concurrency() / 4, 1u, 3u);
+		ConvertStage convertStage(pipelinedConversion, stripeThreads, output, [this](cv::Mat& a_frame) { PublishFrame(a_frame); });
+		convertStripeThreads.store(convertStage.GetStripeThreadCount(), std::memory_order_relaxed);
+
+		// how busy each stage is, over the overlay's update window and over the whole playthrough
+		auto          pipelineWindowStart = std::chrono::steady_clock::now();
+		duration      windowDecodeTime{ 0.0 };
+		duration      totalPipelineTime{ 0.0 };
+		duration      totalDecodeTime{ 0.0 };
+		duration      totalConvertTime{ 0.0 };
+		duration      totalStallTime{ 0.0 };
+		std::uint32_t totalConvertedFrames = 0;
+
+		auto sample_pipeline = [&]() {
+			const auto now = std::chrono::steady_clock::now();
+			const auto window = duration(now - pipelineWindowStart);
+			const auto stats = convertStage.TakeStats();
+			if (window > duration(0.0)) {
+				decodeOccupancy.store(static_cast<float>(windowDecodeTime / window), std::memory_order_relaxed);
+				convertOccupancy.store(static_cast<float>(duration(stats.busy) / window), std::memory_order_relaxed);
+			}
+			totalPipelineTime += window;
+			totalDecodeTime += windowDecodeTime;
+			totalConvertTime += stats.busy;
+			totalStallTime += stats.stalled;
+			totalConvertedFrames += stats.frames;
+			windowDecodeTime = duration(0.0);
+			pipelineWindowStart = now;
+		};
 
-		cv::Mat frame;
-		cv::Mat processedFrame;
+		// the stage pushes published frames to the bake, so it has to be idle before the bake is touched from here
+		auto abort_bake = [&](std::string_view a_reason) {
+			if (bakeWriter && bakeWriter->IsActive()) {
+				convertStage.Drain();
+				bakeWriter->Abort(a_reason);
+			}
+		};
+
+		readFrameCount.store(bakedFrameIndex, std::memory_order_relaxed);
+		variableFrameRate.store(false, std::memory_order_relaxed);
 
 		auto restart_loop = [&]() {
 			readFrameCount.store(0, std::memory_order_relaxed);
-			cap.release();
-			cap.open(currentVideo, cv::CAP_MSMF, { cv::CAP_PROP_HW_ACCELERATION, cv::VIDEO_ACCELERATION_ANY });
+			ReleasePrerolledFrames();
+			if (baked) {
+				bakedFrameIndex = 0;
+			} else if (sequenced) {
+				sequence.Seek(0);
+			} else if (rewound || !SeekVideo(duration(0.0))) {
+				// the rewind didn't take (or gave no frames), reopening always works
+				cap.release();
+				OpenCapture(currentVideo);
+				rewound = false;
+			} else {
+				rewound = true;
+			}
 			RestartAudioThread();
 			if (audioLoaded.load(std::memory_order_relaxed)) {
 				startBarrier.arrive_and_wait();
 			}
 			// Reset timing for new loop
-			frameStartTime = clock::now();
-			playbackStart = frameStartTime;
-			debugUpdateInfoTime = frameStartTime;
+			playbackStart = playbackClock->now();
+			measureStart = playbackStart;
+			debugUpdateInfoTime = playbackStart;
+			realPlaybackStart = std::chrono::steady_clock::now();
+			timeline.Restart(duration(0.0));
+			presentedFrames = 0;
+			decodeTimes.clear();
+			lateFrames = skippedFrames = 0;
+			watchdog.Start(frameDuration);
 		};
 
-		while (!st.stop_requested()) {
-			const auto now = clock::now();
-			const auto elapsed = now - frameStartTime;
+		// once a frame, everything it needs is at hand here or in atomics
+		auto publish_stats = [&](Telemetry::State a_state) {
+			if (!telemetry.IsOpen()) {
+				return;
+			}
+			const auto measuredFPS = contentFPS.load(std::memory_order_relaxed);
+			telemetryStats.state = a_state;
+			telemetryStats.elapsed = duration(playbackClock->now() - playbackStart).count();
+			telemetryStats.cpuTime = get_thread_cpu_time();
+			telemetryStats.queuedFrames = sequenced ? sequence.GetQueuedFrames() : static_cast<std::uint32_t>(prerolledFrames.size());
+			telemetryStats.qualityLevel = qualityController.GetLevel();
+			telemetryStats.targetFPS = measuredFPS > 0.0f ? measuredFPS : targetFPS;
+			telemetryStats.actualFPS = actualFPS.load(std::memory_order_relaxed);
+			telemetryStats.uploadTime = uploadCost.load(std::memory_order_relaxed);
+			telemetryStats.decodeOccupancy = decodeOccupancy.load(std::memory_order_relaxed);
+			telemetryStats.convertOccupancy = convertOccupancy.load(std::memory_order_relaxed);
+			telemetry.Publish(telemetryStats);
+		};
 
-			if (elapsed < frameDuration) {
-				const auto sleepDuration = frameDuration - elapsed;
-				if (sleepDuration > std::chrono::milliseconds(0)) {
-					std::this_thread::sleep_for(sleepDuration);
+		// once per loop and at teardown; a virtual clock says nothing about how this machine keeps up
+		auto record_history = [&]() {
+			if (!history || simulateTime) {
+				return;
+			}
+			const auto       measuredFPS = contentFPS.load(std::memory_order_relaxed);
+			const auto       elapsed = duration(playbackClock->now() - measureStart).count();
+			History::Session session;
+			session.targetFPS = measuredFPS > 0.0f ? measuredFPS : targetFPS;
+			session.achievedFPS = static_cast<float>(presentedFrames / std::max(elapsed, 1e-6));
+			session.decodeTime = History::Percentile(decodeTimes, 0.95f);
+			session.frames = presentedFrames;
+			session.droppedFrames = skippedFrames + lateFrames;
+			session.firstPixelTime = firstPixelTime.exchange(0.0f, std::memory_order_relaxed);
+			if (history->Add(currentVideo, session) && !history->Save()) {
+				logger::warn("Unable to save the play history");
+			}
+		};
+
+		// sleeps in slices so a long gap between timestamps can't hold up teardown
+		auto wait_until = [&](time_point a_due) {
+			while (!st.stop_requested()) {
+				const auto remaining = duration(a_due - playbackClock->now());
+				if (remaining <= duration(0.0)) {
+					break;
+				}
+				playbackClock->sleep_for(std::min(remaining, maxSleepSlice));
+			}
+		};
+
+		while (!st.stop_requested()) {
+			if (visibility && !visibility->IsVisible()) {
+				publish_stats(Telemetry::State::kSuspended);
+				const auto suspendStart = playbackClock->now();
+				WaitUntilVisible(st);
+				const auto resume = Suspension::GetResume(suspendStart, playbackClock->now(), playbackStart, IsPlayingAudio() && audioThread.joinable());
+
+				if (resume.seek) {
+					// audio kept playing, catch the video up to it without reopening
+					const auto position = resume.position;
+					if (baked) {
+						bakedFrameIndex = static_cast<std::uint32_t>(position / frameDuration);
+					} else if (sequenced) {
+						sequence.Seek(static_cast<std::uint32_t>(position / frameDuration));
+					} else {
+						ReleasePrerolledFrames();
+						SeekVideo(position);
+						watchdog.Start(frameDuration);
+					}
+					readFrameCount.store(static_cast<std::uint32_t>(position / frameDuration), std::memory_order_relaxed);
+					timeline.Restart(position);
+				} else {
+					// nothing else moved on, pick up exactly where we stopped
+					playbackStart += resume.suspendedFor;
+					debugUpdateInfoTime += resume.suspendedFor;
 				}
+				measureStart += resume.suspendedFor;
+				pipelineWindowStart = std::chrono::steady_clock::now();
+
+				abort_bake("playback was suspended"sv);
 				continue;
 			}
 
-			if (!cap.read(frame) || frame.empty()) {
+			// grab() still decodes, but skips the retrieve/convert/upload half of the frame
+			const auto skipInterval = qualityController.GetLevel() + 1;
+			const bool skipFrame = !firstFrame && frameIndex++ % skipInterval != 0;
+
+			const auto decodeStart = std::chrono::steady_clock::now();
+			bool       decoded;
+			duration   timestamp;
+			if (baked) {
+				decoded = bakedFrameIndex < bakedVideo.GetHeader().frameCount;
+				if (decoded && !skipFrame) {
+					frame = bakedVideo.GetFrame(bakedFrameIndex);
+				}
+				timestamp = frameDuration * bakedFrameIndex;
+				bakedFrameIndex++;
+			} else if (sequenced) {
+				// frames are decoded ahead by the pool, a skipped one is simply not published
+				timestamp = frameDuration * sequence.GetPosition();
+				decoded = sequence.Read(frame, st);
+			} else if (!prerolledFrames.empty()) {
+				// decoded by the warm start while the game was still loading
+				auto& [prerolled, prerolledTimestamp] = prerolledFrames.front();
+				timestamp = timeline.GetTimestamp(prerolledTimestamp);
+				prerollMemory.Set(prerollMemory.Get() - static_cast<std::int64_t>(prerolled.total() * prerolled.elemSize()));
+				frame = std::move(prerolled);
+				prerolledFrames.pop_front();
+				decoded = true;
+			} else {
+				watchdog.BeginRead(std::chrono::steady_clock::now());
+				decoded = skipFrame ? cap.grab() : (cap.read(frame) && !frame.empty());
+				// a read that outlived the hang threshold is reason enough on its own
+				const bool fallBack = watchdog.EndRead(std::chrono::steady_clock::now()) || decoderHung.exchange(false, std::memory_order_relaxed);
+
+				timestamp = timeline.GetTimestamp(decoded && timeline.UsesTimestamps() ? std::optional(duration(cap.get(cv::CAP_PROP_POS_MSEC) / 1000.0)) : std::nullopt);
+
+				if (fallBack && decoded && !softwareDecode.load(std::memory_order_relaxed)) {
+					FallBackToSoftwareDecode(timestamp + frameDuration);
+					timeline.Restart(timestamp + frameDuration);
+					abort_bake("the decoder was replaced mid-loop"sv);
+				}
+			}
+			const auto decodeTime = duration(std::chrono::steady_clock::now() - decodeStart);
+			windowDecodeTime += decodeTime;
+			telemetryStats.decodeTime = static_cast<float>(decodeTime.count() * 1000.0);
+
+			if (decoded) {
+				rewound = false;
+				decodeTimes.push_back(telemetryStats.decodeTime);
+			} else {
+				// a read that failed because teardown started mustn't restart the loop
+				if (st.stop_requested()) {
+					break;
+				}
+				convertStage.Drain();
+				if (bakeWriter && bakeWriter->IsActive()) {
+					bakeWriter->Finish();
+				}
+				if (simulateTime) {
+					const auto simulated = duration(playbackClock->now() - playbackStart).count();
+					const auto real = duration(std::chrono::steady_clock::now() - realPlaybackStart).count();
+					logger::info("Simulated {:.1f}s of playback in {:.1f}s ({:.1f}x realtime)", simulated, real, simulated / std::max(real, 1e-6));
+				}
+				if (const auto duplicateFrames = timeline.TakeDuplicates(); duplicateFrames > 0) {
+					logger::info("\tDropped {} frames with duplicate timestamps", duplicateFrames);
+				}
+				if (const auto compared = comparedFrames.load(std::memory_order_relaxed); compared > 0) {
+					logger::info("\tSkipped {} of {} frames as repeats ({:.1f} us/frame to compare)", repeatedFrames.exchange(0, std::memory_order_relaxed), compared, compareTime.count() * 1e6 / compared);
+					comparedFrames.store(0, std::memory_order_relaxed);
+					compareTime = duration(0.0);
+				}
+				sample_pipeline();
+				if (totalConvertedFrames > 0 && totalPipelineTime > duration(0.0)) {
+					logger::info("\tPipeline: decode {:.0f}% busy, convert {:.0f}% busy ({:.2f} ms/frame to {}) on {} stripe threads, {:.2f} ms/frame waiting on conversion",
+						totalDecodeTime / totalPipelineTime * 100.0, totalConvertTime / totalPipelineTime * 100.0, totalConvertTime.count() * 1000.0 / totalConvertedFrames, get_format_name(frameFormat),
+						convertStage.GetStripeThreadCount(), totalStallTime.count() * 1000.0 / totalConvertedFrames);
+				}
+				totalPipelineTime = totalDecodeTime = totalConvertTime = totalStallTime = duration(0.0);
+				totalConvertedFrames = 0;
+				record_history();
 				switch (playbackMode) {
 				case PLAYBACK_MODE::kPlayOnce:
 					Reset();
@@ -180,51 +890,282 @@ void VideoPlayer::CreateVideoThread()
 				}
 			}
 
-			const auto channels = frame.channels();
-			if (channels == 3) {
-				cv::cvtColor(frame, processedFrame, cv::COLOR_BGR2BGRA);
-			} else if (channels == 4) {
-				processedFrame = frame;
-			} else {
-				frameStartTime += frameDuration;
+			const auto interval = timestamp - timeline.GetLastTimestamp();
+			switch (timeline.Add(timestamp)) {
+			case FrameTimeline::Verdict::kTimestampsLost:
+				logger::warn("\tBackend isn't reporting frame timestamps, falling back to {:.1f} FPS", targetFPS);
+				[[fallthrough]];
+			case FrameTimeline::Verdict::kDuplicate:
+				telemetryStats.droppedFrames++;
+				abort_bake("frames were dropped for their timestamps"sv);
+				continue;
+			case FrameTimeline::Verdict::kFirstIrregular:
+				// gaps are just held longer, but the bake's fixed rate can't represent them
+				variableFrameRate.store(true, std::memory_order_relaxed);
+				logger::info("\tVariable frame rate detected ({:.1f} ms frame after {:.2f}s)", interval.count() * 1000.0, timestamp.count());
+				abort_bake("the video has a variable frame rate"sv);
+				break;
+			default:
+				break;
+			}
+
+			wait_until(playbackStart + timestamp);
+
+			if (skipFrame) {
+				telemetryStats.droppedFrames++;
+				skippedFrames++;
+				abort_bake("frames were skipped by adaptive quality"sv);
+				readFrameCount.fetch_add(1, std::memory_order_relaxed);
 				continue;
 			}
 
-			{
-				WriteLocker lock(videoFrameLock);
-				cv::swap(processedFrame, videoFrame);
+			// a held frame is already on screen, so it skips conversion and upload
+			bool repeated = false;
+			if (skipRepeatedFrames && !baked) {
+				const auto compareStart = std::chrono::steady_clock::now();
+				const auto fingerprint = FrameHash::Fingerprint(frame);
+				repeated = fingerprint == previousFingerprint && FrameHash::Equal(frame, previousFrame);
+				previousFingerprint = fingerprint;
+				compareTime += std::chrono::steady_clock::now() - compareStart;
+
+				comparedFrames.fetch_add(1, std::memory_order_relaxed);
+				if (repeated) {
+					repeatedFrames.fetch_add(1, std::memory_order_relaxed);
+					telemetryStats.repeatedFrames++;
+				}
+			}
+
+			if (!repeated) {
+				// baked frames are BC1 blocks, uploaded as-is
+				const auto channels = frame.channels();
+				if (!baked && channels != 3 && channels != 4) {
+					continue;
+				}
+				if (!convertStage.Submit(frame, !baked, st)) {
+					break;
+				}
+
+				// the stage is still reading the frame and the next read mustn't overwrite it, nor what that one is compared
+				// against: 3 channel frames alternate between two buffers, 4 channel ones can be published as-is, so the next
+				// read gets a buffer of its own
+				if (!baked) {
+					if (channels == 3) {
+						cv::swap(frame, previousFrame);
+					} else {
+						previousFrame = frame;
+						frame.release();
+					}
+				}
+			} else if (bakeWriter && bakeWriter->IsActive()) {
+				// the bake still needs a frame for this slot
+				convertStage.Drain();
+				PushBakeFrame();
+			}
+
+			// how late the frame was handed on, waiting for a busy stage included
+			const auto drift = duration(playbackClock->now() - (playbackStart + timestamp));
+			telemetryStats.drift = static_cast<float>(drift.count() * 1000.0);
+			if (drift > frameDuration) {
+				lateFrames++;
 			}
 
+			// baked frames live in the mapped file, not on the heap; published ones are accounted for by PublishFrame
+			frameMemory.Set(baked ? 0 : get_frame_bytes({ &frame, previousFrame.channels() == 3 || packed ? &previousFrame : &frame }));
+
 			readFrameCount.fetch_add(1, std::memory_order_relaxed);
-			frameStartTime += frameDuration;
+			presentedFrames++;
+			telemetryStats.frames++;
+
+			if (firstFrame) {
+				firstFrame = false;
+				convertStage.Drain();
+				logger::info("\tTime to first frame: {:.1f} ms", std::chrono::duration<double, std::milli>(playbackClock->now() - loadStartTime).count());
+				// a baked video's first frame is BC1 and its poster was saved by the plays before the bake
+				if (usePosterCache && !posterLoaded && !baked && startOffset == duration(0.0)) {
+					SavePoster();
+				}
+			}
 
+			const auto now = playbackClock->now();
 			if (now - debugUpdateInfoTime >= debugUpdateInterval) {
-				const auto totalElapsed = duration(now - playbackStart).count();
-				const auto frameCount = readFrameCount.load(std::memory_order_relaxed);
-				elapsedTime.store(static_cast<float>(totalElapsed), std::memory_order_relaxed);
-				actualFPS.store(static_cast<float>(frameCount / totalElapsed), std::memory_order_relaxed);
+				elapsedTime.store(static_cast<float>(duration(now - playbackStart).count()), std::memory_order_relaxed);
+				actualFPS.store(static_cast<float>(presentedFrames / std::max(duration(now - measureStart).count(), 1e-6)), std::memory_order_relaxed);
+				if (const auto measuredFPS = timeline.GetContentFPS(); measuredFPS > 0.0f) {
+					contentFPS.store(measuredFPS, std::memory_order_relaxed);
+				}
+				sample_pipeline();
 				debugUpdateInfoTime = now;
 			}
+			publish_stats(Telemetry::State::kPlaying);
 		}
+
+		// stopped or skipped partway, still a fair measure if it ran long enough
+		record_history();
 	});
 }
 
+void VideoPlayer::WaitUntilVisible(std::stop_token a_st)
+{
+	suspended.store(true, std::memory_order_relaxed);
+	logger::info("Game isn't visible, suspending video decode{}", IsPlayingAudio() ? " (audio continues)" : "");
+
+	const auto suspendStart = std::chrono::steady_clock::now();
+	Suspension::WaitUntilVisible(*visibility, a_st, std::chrono::milliseconds(50));
+
+	logger::info("Resuming video decode after {:.1f}s", duration(std::chrono::steady_clock::now() - suspendStart).count());
+	suspended.store(false, std::memory_order_relaxed);
+}
+
+void VideoPlayer::PublishFrame(cv::Mat& a_frame)
+{
+	{
+		WriteLocker lock(videoFrameLock);
+		if (blendActive.load(std::memory_order_relaxed)) {
+			// the frame on screen is kept to fade from, the stage gets the buffer of the one before it to write into
+			cv::swap(previousVideoFrame, videoFrame);
+		} else {
+			previousVideoFrame.release();
+		}
+		cv::swap(a_frame, videoFrame);
+		videoFramePublished = std::chrono::steady_clock::now();
+	}
+	videoFrameSerial.fetch_add(1, std::memory_order_release);
+
+	PushBakeFrame();
+
+	// this is the only thread replacing videoFrame during playback, so it can be read without the lock
+	publishMemory.Set(bakedVideo.IsOpen() ? 0 : get_frame_bytes({ &a_frame, &videoFrame, &previousVideoFrame }));
+}
+
+void VideoPlayer::PushBakeFrame()
+{
+	if (!bakeWriter || !bakeWriter->IsActive()) {
+		return;
+	}
+
+	// the bake wants 8-bit BGRA, BC1 endpoints are 16-bit anyway so little is lost going through B5G6R5
+	if (videoFrame.type() == CV_8UC4) {
+		bakeWriter->Push(videoFrame);
+	} else {
+		cv::Mat bgra;
+		if (FrameFormat::ToBGRA8(videoFrame, videoWidth, videoHeight, bgra)) {
+			bakeWriter->Push(bgra);
+		}
+	}
+}
+
 void VideoPlayer::Update(ID3D11DeviceContext* context)
 {
 	if (!texture) {
 		return;
 	}
 
-	cv::Mat localFrame;
+	if (qualityController.IsEnabled()) {
+		const auto now = std::chrono::steady_clock::now();
+		const auto presentGapMs = std::chrono::duration<float, std::milli>(now - lastPresentTime).count();
+		lastPresentTime = now;
+		// ignore the first present after a load and anything that's clearly a stall rather than a frame
+		if (presentGapMs < 1000.0f) {
+			if (const auto decision = qualityController.Sample(presentGapMs)) {
+				logger::info("Game frame time {:.1f} ms, video quality level {} -> {}", decision->medianFrameTime, decision->oldLevel, decision->newLevel);
+			}
+		}
+	}
+
+	// the decode thread can't report a read that never returns, so check it from here
+	if (watchdog.IsHung(std::chrono::steady_clock::now())) {
+		if (!decoderHung.exchange(true, std::memory_order_relaxed) && !softwareDecode.load(std::memory_order_relaxed)) {
+			logger::warn("Hardware decoder is stuck in a read on {}, later sessions will use software decoding", currentVideo);
+			std::jthread([path = currentVideo]() { SaveDecoderFallback(path); }).detach();
+		}
+	}
+
+	// measured here so it drops while nothing new is uploaded
+	if (const auto now = std::chrono::steady_clock::now(); now - uploadWindowStart >= std::chrono::seconds(1)) {
+		uploadRate.store(static_cast<float>(uploadWindowBytes / duration(now - uploadWindowStart).count()), std::memory_order_relaxed);
+		uploadCost.store(uploadWindowFrames > 0 ? static_cast<float>(uploadWindowTime.count() * 1000.0 / uploadWindowFrames) : 0.0f, std::memory_order_relaxed);
+		uploadWindowStart = now;
+		uploadWindowBytes = 0;
+		uploadWindowFrames = 0;
+		uploadWindowTime = duration(0.0);
+
+		if (blendWindowFrames > 0) {
+			const auto cost = static_cast<float>(blendWindowTime.count() * 1000.0 / blendWindowFrames);
+			blendCost.store(cost, std::memory_order_relaxed);
+			// a second over budget on average; the game's frame time matters more than smoother motion
+			if (cost > blendBudgetMs && blendActive.exchange(false, std::memory_order_relaxed)) {
+				logger::warn("Frame blending took {:.2f} ms per upload, over its {:.2f} ms budget, turning it off", cost, blendBudgetMs);
+			}
+		}
+		blendWindowFrames = 0;
+		blendWindowTime = duration(0.0);
+	}
+
+	// a fade needs a few presents per video frame to show, at the video's own rate it would only soften every frame
+	bool blending = false;
+	if (blendActive.load(std::memory_order_relaxed)) {
+		const auto now = std::chrono::steady_clock::now();
+		if (const auto interval = duration(now - lastBlendPresent); interval < std::chrono::seconds(1)) {
+			presentInterval = presentInterval > duration(0.0) ? presentInterval * 0.9 + interval * 0.1 : interval;
+		}
+		lastBlendPresent = now;
+		blending = presentInterval > duration(0.0) && presentInterval * 1.5 <= frameDuration;
+	}
+
+	// nothing new since the last upload (a held frame, or the game presenting faster than the video), and no fade in progress
+	const auto serial = videoFrameSerial.load(std::memory_order_acquire);
+	if (serial == uploadedFrameSerial && uploadedBlendWeight == Blend::fullWeight) {
+		return;
+	}
+
+	const auto uploadStart = std::chrono::steady_clock::now();
+	cv::Mat    localFrame;
+	cv::Mat    localPrevious;
 	{
 		ReadLocker lock(videoFrameLock);
 		if (videoFrame.empty()) {
 			return;
 		}
-		localFrame = videoFrame;
+
+		auto weight = Blend::fullWeight;
+		if (blending && previousVideoFrame.size() == videoFrame.size() && previousVideoFrame.type() == videoFrame.type()) {
+			weight = Blend::GetWeight(duration(uploadStart - videoFramePublished).count(), frameDuration.count());
+		}
+		if (serial == uploadedFrameSerial && weight == uploadedBlendWeight) {
+			return;
+		}
+		uploadedFrameSerial = serial;
+		uploadedBlendWeight = weight;
+
+		if (bakedVideo.IsOpen()) {
+			// baked frames point into the mapped file, hold the lock so it can't be unmapped mid-copy
+			uploadWindowBytes += texture->Update(context, videoFrame);
+		} else {
+			localFrame = videoFrame;
+			if (weight < Blend::fullWeight) {
+				localPrevious = previousVideoFrame;
+			}
+		}
+	}
+
+	if (!localPrevious.empty()) {
+		uploadWindowBytes += texture->Update(context, localPrevious, localFrame, uploadedBlendWeight);
+	} else if (!localFrame.empty()) {
+		uploadWindowBytes += texture->Update(context, localFrame);
+	}
+	const auto uploadTime = std::chrono::steady_clock::now() - uploadStart;
+	uploadWindowTime += uploadTime;
+	uploadWindowFrames++;
+	if (blending) {
+		blendWindowTime += uploadTime;
+		blendWindowFrames++;
 	}
 
-	texture->Update(context, localFrame);
+	if (firstPixelPending.exchange(false, std::memory_order_relaxed)) {
+		const auto firstPixel = std::chrono::duration<double, std::milli>(playbackClock->now() - loadStartTime).count();
+		logger::info("\tTime to first pixel: {:.1f} ms{}", firstPixel, posterLoaded ? " (poster)" : "");
+		firstPixelTime.store(static_cast<float>(firstPixel), std::memory_order_relaxed);
+	}
 }
 
 void VideoPlayer::CreateAudioThread()
@@ -239,6 +1180,11 @@ void VideoPlayer::CreateAudioThread()
 		startBarrier.arrive_and_wait();
 		audioWriter->BeginWriting();
 
+		if (cachedAudio.IsOpen()) {
+			PlayCachedAudio(st);
+			return;
+		}
+
 		ComPtr<IMFSample> sample;
 		DWORD             streamFlags = 0;
 		MFTIME            timestamp = 0;
@@ -249,15 +1195,29 @@ void VideoPlayer::CreateAudioThread()
 
 			HRESULT hr = audioReader->ReadSample(audioStreamIndex, 0, nullptr, &streamFlags, &timestamp, &sample);
 			if (FAILED(hr) || streamFlags & MF_SOURCE_READERF_ENDOFSTREAM) {
+				if (SUCCEEDED(hr) && audioCacheWriter) {
+					audioCacheWriter->Finish();
+				}
 				break;
 			}
 
 			if (streamFlags & MF_SOURCE_READERF_STREAMTICK) {
 				audioWriter->SendStreamTick(0, timestamp);
+				if (audioCacheWriter) {
+					audioCacheWriter->Abort("the track has gaps"sv);  // a flat PCM file can't represent them
+				}
 			}
 
 			if (sample) {
 				audioWriter->WriteSample(0, sample.Get());
+
+				ComPtr<IMFMediaBuffer> buffer;
+				BYTE*                  data = nullptr;
+				DWORD                  length = 0;
+				if (audioCacheWriter && audioCacheWriter->IsActive() && SUCCEEDED(sample->ConvertToContiguousBuffer(&buffer)) && SUCCEEDED(buffer->Lock(&data, nullptr, &length))) {
+					audioCacheWriter->Append({ data, length });
+					buffer->Unlock();
+				}
 			}
 		}
 	});
@@ -268,30 +1228,184 @@ void VideoPlayer::RestartAudioThread()
 	if (audioLoaded) {
 		audioThread = {};
 		ResetAudio();
-		audioLoaded.store(LoadAudio(currentVideo), std::memory_order_relaxed);
+		audioLoaded.store(LoadAudio(currentAudio), std::memory_order_relaxed);
 		CreateAudioThread();
 	}
 }
 
 bool VideoPlayer::LoadVideo(ID3D11Device* device, const std::string& path, bool playAudio)
 {
-	cap.open(path, cv::CAP_MSMF, { cv::CAP_PROP_HW_ACCELERATION, cv::VIDEO_ACCELERATION_ANY });
-	if (!cap.isOpened()) {
-		currentVideo.clear();
-		logger::warn("Couldn't load {}", path);
+	// the first boot's video may already be open, the loading screen only waits for whatever preparation is left
+	if (warmThread.joinable()) {
+		warmThread.join();
+	}
+	switch (warmStart.Take(path)) {
+	case WarmStart::Claim::kWarm:
+		loadStartTime = playbackClock->now();
+		logger::info("Playing {} (warm start, {} frames pre-rolled)", path, prerolledFrames.size());
+		if (!warmStart.IsBound()) {
+			if (!BindTexture(device)) {
+				ReleaseResources(false);
+				return false;
+			}
+			warmStart.MarkBound();
+		}
+		StartPlayback();
+		return true;
+	case WarmStart::Claim::kDiscarded:
+		logger::info("Discarding warm started video, {} was picked instead", path);
+		indexThread = {};
+		keyframeIndex.store(nullptr, std::memory_order_release);
+		ReleaseResources(false);
+		break;
+	default:
+		break;
+	}
+
+	FinishBackgroundTeardown();
+
+	loadStartTime = playbackClock->now();
+
+	if (!OpenVideo(path, playAudio)) {
+		return false;
+	}
+	if (!BindTexture(device)) {
+		ReleaseResources(false);
 		return false;
 	}
+	StartPlayback();
 
-	currentVideo = path;
+	return true;
+}
+
+bool VideoPlayer::Prepare(const std::string& path, bool playAudio)
+{
+	if (!warmStartEnabled || !warmStart.Begin(path)) {
+		return false;
+	}
 
-	videoWidth = static_cast<std::uint32_t>(cap.get(cv::CAP_PROP_FRAME_WIDTH));
-	videoHeight = static_cast<std::uint32_t>(cap.get(cv::CAP_PROP_FRAME_HEIGHT));
-	frameCount = static_cast<std::uint32_t>(cap.get(cv::CAP_PROP_FRAME_COUNT));
-	targetFPS = static_cast<float>(cap.get(cv::CAP_PROP_FPS));
+	FinishBackgroundTeardown();
+
+	warmThread = std::jthread([this, path, playAudio](std::stop_token st) {
+		SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+		// the capture and audio renderer are COM objects, normally created on the game's main thread
+		const bool comInitialized = SUCCEEDED(CoInitializeEx(nullptr, COINIT_MULTITHREADED));
+
+		const auto prepareStart = std::chrono::steady_clock::now();
+		const bool opened = OpenVideo(path, playAudio);
+		if (opened) {
+			Preroll(st);
+		}
+		logger::info("Warm start: prepared {} in {:.0f} ms ({} frames pre-rolled)", path, std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - prepareStart).count(), prerolledFrames.size());
+
+		// from here on the main thread may bind the texture
+		warmStart.Finish(opened && !st.stop_requested());
+
+		if (comInitialized) {
+			CoUninitialize();
+		}
+	});
+
+	return true;
+}
+
+void VideoPlayer::OnDeviceReady(ID3D11Device* device)
+{
+	if (!warmStart.OnDeviceReady()) {
+		return;
+	}
+	if (BindTexture(device)) {
+		warmStart.MarkBound();
+	} else {
+		logger::warn("Warm start: couldn't create the texture, it'll be retried when playback starts");
+	}
+}
+
+bool VideoPlayer::OpenVideo(const std::string& path, bool playAudio)
+{
+	if (OpenBakedVideo(path)) {
+		const auto& header = bakedVideo.GetHeader();
+		videoWidth = header.width;
+		videoHeight = header.height;
+		frameCount = header.frameCount;
+		targetFPS = header.fps;
+	} else if (ImageSequence::IsSequence(path)) {
+		// 16-bit frames would have to be reduced again for a 16-bit texture
+		if (!sequence.Open(path, !use16BitFrames)) {
+			currentVideo.clear();
+			logger::warn("Couldn't load image sequence {}", path);
+			return false;
+		}
+
+		videoWidth = sequence.GetWidth();
+		videoHeight = sequence.GetHeight();
+		frameCount = sequence.GetFrameCount();
+		targetFPS = sequence.GetFPS();
+	} else {
+		// a file that stalled the hardware decoder before goes straight to software
+		softwareDecode.store(LoadDecoderFallback(path), std::memory_order_relaxed);
+		if (!OpenCapture(path)) {
+			currentVideo.clear();
+			logger::warn("Couldn't load {}", path);
+			return false;
+		}
+
+		videoWidth = static_cast<std::uint32_t>(cap.get(cv::CAP_PROP_FRAME_WIDTH));
+		videoHeight = static_cast<std::uint32_t>(cap.get(cv::CAP_PROP_FRAME_HEIGHT));
+		frameCount = static_cast<std::uint32_t>(cap.get(cv::CAP_PROP_FRAME_COUNT));
+		targetFPS = static_cast<float>(cap.get(cv::CAP_PROP_FPS));
+	}
+
+	currentVideo = path;
+	if (!sequence.IsOpen()) {
+		currentAudio = path;
+	} else if (const auto& audio = sequence.GetAudioPath()) {
+		currentAudio = audio->string();
+	} else {
+		currentAudio.clear();
+	}
 	frameDuration = targetFPS > 0.0f ? duration(1.0f / targetFPS) : duration(0.0333);
 
-	logger::info("Loading {} ({}x{}|{} FPS|{} frames)", path, videoWidth, videoHeight, targetFPS, frameCount);
+	logger::info("Loading {} ({}x{}|{} FPS|{} frames){}", path, videoWidth, videoHeight, targetFPS, frameCount, bakedVideo.IsOpen() ? " [baked]" : sequence.IsOpen() ? " [image sequence]" : "");
+
+	watchdog.Start(frameDuration);
+	decoderHung.store(false, std::memory_order_relaxed);
+
+	if (randomStart && !bakedVideo.IsOpen() && !sequence.IsOpen()) {
+		LoadKeyframeIndex(path);
+	}
 
+	startOffset = GetRandomStartOffset();
+	if (startOffset > duration(0.0)) {
+		logger::info("\tStarting at {:.2f}s", startOffset.count());
+		if (sequence.IsOpen()) {
+			sequence.Seek(static_cast<std::uint32_t>(startOffset / frameDuration));
+		} else if (!bakedVideo.IsOpen() && !SeekVideo(startOffset)) {
+			startOffset = duration(0.0);
+		}
+	}
+
+	// shown until the decoder delivers its first frame (baked frames are available immediately)
+	posterLoaded = startOffset == duration(0.0) && !bakedVideo.IsOpen() && LoadPoster();
+	firstPixelTime.store(0.0f, std::memory_order_relaxed);
+	firstPixelPending.store(true, std::memory_order_relaxed);
+
+	// a bake has to see the video from its first frame
+	if (startOffset == duration(0.0)) {
+		BeginBake();
+	}
+
+	// audio can't follow a virtual clock
+	audioLoaded.store(playAudio && !simulateTime && !currentAudio.empty() ? LoadAudio(currentAudio) : false, std::memory_order_relaxed);
+	if (audioLoaded.load(std::memory_order_relaxed) && startOffset > duration(0.0)) {
+		SeekAudio(startOffset);
+	}
+
+	return true;
+}
+
+bool VideoPlayer::BindTexture(ID3D11Device* device)
+{
 	const auto screenSize = RE::BSGraphics::Renderer::GetScreenSize();
 	if (screenSize.width != videoWidth || screenSize.height != videoHeight) {
 		const float scaleX = static_cast<float>(screenSize.width) / videoWidth;
@@ -306,24 +1420,110 @@ bool VideoPlayer::LoadVideo(ID3D11Device* device, const std::string& path, bool
 		displaySize = { static_cast<float>(videoWidth), static_cast<float>(videoHeight) };
 	}
 
-	texture = std::make_unique<ImGui::Texture>(device, videoWidth, videoHeight);
+	frameFormat = DXGI_FORMAT_B8G8R8A8_UNORM;
+	if (bakedVideo.IsOpen()) {
+		frameFormat = DXGI_FORMAT_BC1_UNORM;
+	} else if (sequence.IsOpen() && sequence.IsHighBitDepth()) {
+		UINT           support = 0;
+		constexpr UINT required = D3D11_FORMAT_SUPPORT_TEXTURE2D | D3D11_FORMAT_SUPPORT_SHADER_SAMPLE;
+		if (SUCCEEDED(device->CheckFormatSupport(DXGI_FORMAT_R10G10B10A2_UNORM, &support)) && (support & required) == required) {
+			frameFormat = DXGI_FORMAT_R10G10B10A2_UNORM;
+		} else {
+			logger::warn("\tThe GPU can't sample 10-bit R10G10B10A2 textures, reducing frames to 8 bits");
+		}
+	} else if (use16BitFrames) {
+		// optional before feature level 11, and only guaranteed on Windows 8 and later
+		UINT           support = 0;
+		constexpr UINT required = D3D11_FORMAT_SUPPORT_TEXTURE2D | D3D11_FORMAT_SUPPORT_SHADER_SAMPLE;
+		if (SUCCEEDED(device->CheckFormatSupport(DXGI_FORMAT_B5G6R5_UNORM, &support)) && (support & required) == required) {
+			frameFormat = DXGI_FORMAT_B5G6R5_UNORM;
+		} else {
+			logger::warn("\tThe GPU can't sample 16-bit B5G6R5 textures, using 32-bit frames");
+		}
+	}
+
+	// fades are mixed while copying 8-bit rows, BC1 blocks and packed 16-bit or 10-bit pixels would need unpacking first
+	blendActive.store(false, std::memory_order_relaxed);
+	if (blendFrames && !simulateTime) {
+		if (frameFormat == DXGI_FORMAT_B8G8R8A8_UNORM) {
+			blendActive.store(true, std::memory_order_relaxed);
+			logger::info("\tFrame blending: on ({:.1f} ms budget)", blendBudgetMs);
+		} else {
+			logger::info("\tFrame blending: off, {} frames can't be blended", get_format_name(frameFormat));
+		}
+	}
+
+	texture = std::make_unique<ImGui::Texture>(device, videoWidth, videoHeight, frameFormat);
 	if (!texture || !texture->texture || !texture->srView) {
-		cap.release();
+		texture.reset();
+		textureMemory.Set(0);
 		return false;
 	}
 
-	audioLoaded.store(playAudio ? LoadAudio(path) : false, std::memory_order_relaxed);
+	const auto frameBytes = bakedVideo.IsOpen() ? std::int64_t(bakedVideo.GetHeader().frameBytes) : std::int64_t(videoWidth) * videoHeight * (frameFormat == DXGI_FORMAT_B5G6R5_UNORM ? 2 : 4);
+	textureMemory.Set(frameBytes);
+	logger::info("\tTexture: {} ({:.1f} MB per frame, {:.0f} MB/s at {:.1f} FPS)", get_format_name(frameFormat),
+		frameBytes / (1024.0 * 1024.0), frameBytes * targetFPS / (1024.0 * 1024.0), targetFPS);
+
+	// a poster loaded before the format was known has to match it
+	if (frameFormat == DXGI_FORMAT_B5G6R5_UNORM || frameFormat == DXGI_FORMAT_R10G10B10A2_UNORM) {
+		WriteLocker lock(videoFrameLock);
+		if (!videoFrame.empty() && videoFrame.type() == CV_8UC4) {
+			cv::Mat poster;
+			if (frameFormat == DXGI_FORMAT_B5G6R5_UNORM) {
+				B5G6R5::Pack(videoFrame, poster, ditherFrames);
+			} else {
+				videoFrame.convertTo(poster, CV_16U, 257.0);
+			}
+			videoFrame = std::move(poster);
+			frameMemory.Set(get_frame_bytes({ &videoFrame }));
+		}
+	}
+
+	return true;
+}
+
+void VideoPlayer::StartPlayback()
+{
+	qualityController.Reset();
+	lastPresentTime = {};
+	lastBlendPresent = {};
+	presentInterval = duration(0.0);
+	uploadedBlendWeight = Blend::fullWeight;
 
 	CreateAudioThread();
 	CreateVideoThread();
+}
 
-	return true;
+void VideoPlayer::ReleasePrerolledFrames()
+{
+	prerolledFrames.clear();
+	prerollMemory.Set(0);
+}
+
+void VideoPlayer::Preroll(std::stop_token a_st)
+{
+	// baked frames are mapped and sequences decode ahead on their own
+	if (!cap.isOpened()) {
+		return;
+	}
+
+	while (prerolledFrames.size() < prerollFrameCount && !a_st.stop_requested()) {
+		cv::Mat frame;
+		if (!cap.read(frame) || frame.empty()) {
+			break;
+		}
+		const auto timestamp = duration(cap.get(cv::CAP_PROP_POS_MSEC) / 1000.0);
+		prerollMemory.Set(prerollMemory.Get() + static_cast<std::int64_t>(frame.total() * frame.elemSize()));
+		prerolledFrames.push_back({ std::move(frame), timestamp });
+	}
 }
 
 void VideoPlayer::ResetAudio()
 {
+	audioCacheWriter.reset();  // abandons a track that didn't play to the end
 	audioReader = nullptr;
-	audioVolume = nullptr;
+	SetAudioVolume(nullptr);
 	if (audioWriter) {
 		audioWriter->Flush(0);
 		audioWriter->Finalize();
@@ -335,36 +1535,112 @@ void VideoPlayer::ResetAudio()
 	}
 }
 
-void VideoPlayer::ResetImpl(bool playNextVideo)
+void VideoPlayer::ReleaseResources(bool playNextVideo)
 {
-	if (videoThread.joinable()) {
-		videoThread.request_stop();
-		videoThread.join();
-	}
-	if (audioThread.joinable()) {
-		audioThread.request_stop();
-		audioThread.join();
-	}
-
-	readFrameCount.store(0, std ::memory_order_relaxed);
-	elapsedTime.store(0, std::memory_order_relaxed);
-
 	{
 		WriteLocker lock(videoFrameLock);
 		videoFrame.release();
+		previousVideoFrame.release();
+		frameMemory.Set(0);
+		publishMemory.Set(0);
 	}
 
-	if (audioLoaded.load(std::memory_order_relaxed)) {
-		ResetAudio();
-		if (!playNextVideo) {
-			audioLoaded.store(false, std::memory_order_relaxed);
-		}
-	}
+	bakedVideo.Close();
+	bakeWriter.reset();  // finishes a completed bake, abandons a partial one
+	ReleasePrerolledFrames();
+
+	ResetAudio();
+	cachedAudio.Close();
 
 	if (!playNextVideo) {
 		texture.reset();
+		textureMemory.Set(0);
 	}
 	cap.release();
+	sequence.Close();
+
+	const auto tracker = Memory::Tracker::GetSingleton();
+	tracker->LogUsage("after reset");
+	if (!playNextVideo && (tracker->GetUsage(Memory::Category::kFrames) != 0 || tracker->GetUsage(Memory::Category::kTexture) != 0)) {
+		logger::warn("Memory: frames or textures still accounted for after stopping playback");
+	}
+	telemetry.Publish({});
+}
+
+ComPtr<IMFSimpleAudioVolume> VideoPlayer::GetAudioVolume() const
+{
+	Locker lock(audioVolumeLock);
+	return audioVolume;
+}
+
+void VideoPlayer::SetAudioVolume(ComPtr<IMFSimpleAudioVolume> a_volume)
+{
+	Locker lock(audioVolumeLock);
+	audioVolume = std::move(a_volume);
+}
+
+void VideoPlayer::FinishBackgroundTeardown()
+{
+	// a previous stop may have left a blocked decoder to clean up on its own, it still owns the capture
+	if (cleanupThread.joinable()) {
+		const auto waitStart = std::chrono::steady_clock::now();
+		cleanupThread.join();
+		logger::info("Waited {:.0f} ms for the previous video to finish tearing down", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStart).count());
+	}
+}
+
+void VideoPlayer::ResetImpl(bool playNextVideo)
+{
+	const auto teardownStart = std::chrono::steady_clock::now();
+
+	// the threads below may be the ones a previous background teardown is still joining
+	FinishBackgroundTeardown();
+
+	videoThread.request_stop();
+	audioThread.request_stop();
+	indexThread.request_stop();
+
+	// a thread stuck in a read won't notice the stop for a while, don't let it keep playing audio meanwhile.
+	// the audio thread may be restarting and releasing the volume control, so work on a copy
+	if (const auto currentVolume = GetAudioVolume()) {
+		currentVolume->SetMasterVolume(0.0f);
+	}
+
+	// the next video reuses the capture and audio objects, so switching always has to wait
+	const auto deadline = playNextVideo ? std::chrono::steady_clock::time_point::max() : teardownStart + std::chrono::milliseconds(teardownTimeoutMs);
+	const bool videoStopped = join_before(videoThread, deadline);
+	const bool audioStopped = join_before(audioThread, deadline);
+	const bool indexStopped = join_before(indexThread, deadline);
+
+	keyframeIndex.store(nullptr, std::memory_order_release);
+	startOffset = duration(0.0);
+	readFrameCount.store(0, std ::memory_order_relaxed);
+	elapsedTime.store(0, std::memory_order_relaxed);
+	contentFPS.store(0.0f, std::memory_order_relaxed);
+	repeatedFrames.store(0, std::memory_order_relaxed);
+	comparedFrames.store(0, std::memory_order_relaxed);
+	decodeOccupancy.store(0.0f, std::memory_order_relaxed);
+	convertOccupancy.store(0.0f, std::memory_order_relaxed);
+	if (!playNextVideo) {
+		audioLoaded.store(false, std::memory_order_relaxed);
+	}
+
+	if (videoStopped && audioStopped && indexStopped) {
+		ReleaseResources(playNextVideo);
+	} else {
+		logger::warn("Teardown: {} still blocked after {} ms, finishing in the background", !videoStopped ? "video decode" : !audioStopped ? "audio read" : "keyframe indexing", teardownTimeoutMs);
+		cleanupThread = std::jthread([this, teardownStart]() {
+			for (auto* thread : { &videoThread, &audioThread, &indexThread }) {
+				if (thread->joinable()) {
+					thread->join();
+				}
+			}
+			ReleaseResources(false);
+			logger::info("Background teardown finished after {:.0f} ms", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - teardownStart).count());
+		});
+	}
+
+	logger::info("Teardown took {:.1f} ms", std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - teardownStart).count());
 
 	if (playNextVideo) {
 		if (!Manager::GetSingleton()->LoadNextVideo()) {
@@ -433,12 +1709,35 @@ void VideoPlayer::ShowDebugInfo()
 		return;
 	}
 
-	ImGui::Text("%s", currentVideo.c_str());
+	ImGui::Text("%s%s", currentVideo.c_str(), suspended.load(std::memory_order_relaxed) ? " (SUSPENDED)" : "");
 	ImGui::Text("\tElapsed Time: %.1f seconds", elapsedTime.load(std::memory_order_relaxed));
 	ImGui::Text("\tFrames Processed: %u/%u", readFrameCount.load(std::memory_order_relaxed), frameCount);
-	ImGui::Text("\tTarget FPS: %.1f", targetFPS);
+	const auto measuredFPS = contentFPS.load(std::memory_order_relaxed);
+	ImGui::Text("\tTarget FPS: %.1f%s", measuredFPS > 0.0f ? measuredFPS : targetFPS, variableFrameRate.load(std::memory_order_relaxed) ? " (variable)" : "");
 	ImGui::Text("\tActual FPS: %.1f", actualFPS.load(std::memory_order_relaxed));
+	if (qualityController.IsEnabled()) {
+		ImGui::Text("\tQuality Level: %u", qualityController.GetLevel());
+	}
+	if (sequence.IsOpen()) {
+		ImGui::Text("\tDecoder: image sequence (%u threads%s)", sequence.GetThreadCount(), sequence.IsHighBitDepth() ? ", 16-bit" : "");
+	} else if (!bakedVideo.IsOpen()) {
+		ImGui::Text("\tDecoder: %s (%u misses)%s", softwareDecode.load(std::memory_order_relaxed) ? "software" : "hardware", watchdog.GetMisses(), decoderHung.load(std::memory_order_relaxed) ? " STALLED" : "");
+	}
+	ImGui::Text("\tUpload: %.1f MB/s, %.2f ms/frame (%s)", uploadRate.load(std::memory_order_relaxed) / (1024.0f * 1024.0f), uploadCost.load(std::memory_order_relaxed), get_format_name(frameFormat).data());
+	if (blendFrames) {
+		ImGui::Text("\tFrame Blending: %s, %.2f ms/upload", blendActive.load(std::memory_order_relaxed) ? "on" : "off", blendCost.load(std::memory_order_relaxed));
+	}
+	if (pipelinedConversion && !bakedVideo.IsOpen() && !sequence.IsOpen()) {
+		ImGui::Text("\tPipeline: decode %.0f%%, convert %.0f%% busy (%u stripe threads)", decodeOccupancy.load(std::memory_order_relaxed) * 100.0f, convertOccupancy.load(std::memory_order_relaxed) * 100.0f, convertStripeThreads.load(std::memory_order_relaxed));
+	}
+	if (const auto compared = comparedFrames.load(std::memory_order_relaxed); compared > 0) {
+		ImGui::Text("\tRepeated Frames: %u/%u skipped", repeatedFrames.load(std::memory_order_relaxed), compared);
+	}
+	if (const auto index = keyframeIndex.load(std::memory_order_acquire)) {
+		ImGui::Text("\tKeyframes: %zu (last seek %.1f ms)", index->GetCount(), lastSeekTime.load(std::memory_order_relaxed));
+	}
 	ImGui::Text("\tVolume: %.0f%%", volume.load(std::memory_order_relaxed) * 100.0f);
+	Memory::Tracker::GetSingleton()->ShowDebugInfo();
 }
 
 void VideoPlayer::OnVolumeUpdate()
@@ -472,11 +1771,28 @@ void VideoPlayer::SetPlaybackMode(PLAYBACK_MODE a_mode)
 	playbackMode = a_mode;
 }
 
+void VideoPlayer::SetVisibilitySource(const Visibility::Source* a_source)
+{
+	visibility = a_source;
+}
+
+void VideoPlayer::SetClock(std::unique_ptr<Clock> a_clock)
+{
+	if (playbackState.load(std::memory_order_acquire) == PLAYBACK_STATE::kIdle && a_clock) {
+		playbackClock = std::move(a_clock);
+	}
+}
+
+void VideoPlayer::SetHistory(History::Store* a_history)
+{
+	history = a_history;
+}
+
 void VideoPlayer::IncrementVolume(float a_delta)
 {
-	if (audioVolume) {
+	if (const auto currentVolume = GetAudioVolume()) {
 		auto tempVolume = std::clamp(volume.load(std::memory_order_relaxed) + a_delta, 0.0f, 1.0f);
-		audioVolume->SetMasterVolume(tempVolume);
+		currentVolume->SetMasterVolume(tempVolume);
 		volume.store(tempVolume, std::memory_order_relaxed);
 		volumeDisplayStart = std::chrono::steady_clock::now();
 	}
@@ -1,14 +1,33 @@
 #pragma once
 
+#include "AudioCache.h"
+#include "BakedVideo.h"
+#include "Blend.h"
+#include "Clock.h"
+#include "DecodeWatchdog.h"
+#include "FrameTimeline.h"
+#include "History.h"
+#include "ImageSequence.h"
+#include "KeyframeIndex.h"
+#include "Memory.h"
+#include "QualityController.h"
+#include "Suspension.h"
+#include "Telemetry.h"
+#include "Visibility.h"
+#include "WarmStart.h"
+
 namespace ImGui
 {
 	struct Texture
 	{
 		Texture() = default;
-		Texture(ID3D11Device* device, std::uint32_t a_width, std::uint32_t a_height);
+		Texture(ID3D11Device* device, std::uint32_t a_width, std::uint32_t a_height, DXGI_FORMAT a_format = DXGI_FORMAT_B8G8R8A8_UNORM);
 		~Texture() = default;
 
-		void Update(ID3D11DeviceContext* context, const cv::Mat& frame) const;
+		// 16-bit BGRA frames are packed to the 10-bit texture on the way in; returns the bytes written
+		std::size_t Update(ID3D11DeviceContext* context, const cv::Mat& frame) const;
+		// 8-bit BGRA frames mixed on the way in, weight as in Blend::LerpRow
+		std::size_t Update(ID3D11DeviceContext* context, const cv::Mat& from, const cv::Mat& to, std::uint32_t weight) const;
 
 		// members
 		ComPtr<ID3D11Texture2D>          texture{ nullptr };
@@ -37,6 +56,11 @@ public:
 	VideoPlayer() = default;
 	~VideoPlayer()
 	{
+		if (warmThread.joinable()) {
+			warmThread.request_stop();
+			warmThread.join();
+		}
+
 		auto expected = PLAYBACK_STATE::kPlaying;
 		if (playbackState.compare_exchange_strong(expected, PLAYBACK_STATE::kStopping,
 				std::memory_order_acq_rel,
@@ -48,9 +72,18 @@ public:
 				resetThread.join();
 			}
 		}
+		// a decoder that missed the teardown deadline is still cleaning up after itself
+		if (cleanupThread.joinable()) {
+			cleanupThread.join();
+		}
 	}
 
+	void LoadSettings(CSimpleIniA& a_ini);
+
 	bool LoadVideo(ID3D11Device* device, const std::string& path, bool playAudio);
+	// opens and pre-rolls a video before the renderer exists, LoadVideo with the same path then only has to start it
+	bool Prepare(const std::string& path, bool playAudio);
+	void OnDeviceReady(ID3D11Device* device);
 	void Update(ID3D11DeviceContext* context);
 	void Reset(bool playNextVideo = false);
 
@@ -70,53 +103,182 @@ public:
 
 	void IncrementVolume(float a_delta);
 
+	void SetVisibilitySource(const Visibility::Source* a_source);
+	void SetClock(std::unique_ptr<Clock> a_clock);
+	void SetHistory(History::Store* a_history);
+
 private:
-	using clock = std::chrono::steady_clock;
-	using duration = std::chrono::duration<double>;
-	using time_point = std::chrono::time_point<clock, duration>;
+	using duration = Clock::duration;
+	using time_point = Clock::time_point;
 
 	using Lock = std::shared_mutex;
 	using ReadLocker = std::shared_lock<Lock>;
 	using WriteLocker = std::unique_lock<Lock>;
+	using Locker = std::lock_guard<std::mutex>;
+
+	using KeyframeIndexPtr = std::shared_ptr<const KeyframeIndex>;
+
+	struct PrerolledFrame
+	{
+		cv::Mat  frame;
+		duration timestamp;
+	};
+
+	bool OpenVideo(const std::string& path, bool playAudio);
+	bool BindTexture(ID3D11Device* device);
+	void StartPlayback();
+	void Preroll(std::stop_token a_st);
+	void ReleasePrerolledFrames();
 
 	void CreateVideoThread();
+	void WaitUntilVisible(std::stop_token a_st);
+	void PublishFrame(cv::Mat& a_frame);
+	void PushBakeFrame();
 	void CreateAudioThread();
 	void RestartAudioThread();
 
 	bool LoadAudio(const std::string& path);
+	bool CreateAudioWriter(IMFMediaType* a_inputType);
+
+	bool OpenAudioCache(const std::string& path);
+	bool LoadCachedAudio();
+	void BeginAudioCache(const std::string& path, IMFMediaType* a_inputType);
+	void PlayCachedAudio(std::stop_token a_st);
+
+	bool LoadPoster();
+	void SavePoster();
+
+	bool OpenCapture(const std::string& path);
+	bool LoadDecoderFallback(const std::string& path) const;
+	static void SaveDecoderFallback(const std::string& path);
+	void FallBackToSoftwareDecode(duration a_position);
 
-	void ResetAudio();
+	bool OpenBakedVideo(const std::string& path);
+	void BeginBake();
+
+	void     LoadKeyframeIndex(const std::string& path);
+	duration GetRandomStartOffset() const;
+	bool     SeekVideo(duration a_position);
+	void     SeekAudio(duration a_position);
+
+	void                         ResetAudio();
+	ComPtr<IMFSimpleAudioVolume> GetAudioVolume() const;
+	void                         SetAudioVolume(ComPtr<IMFSimpleAudioVolume> a_volume);
+
+	void FinishBackgroundTeardown();
+	void ReleaseResources(bool playNextVideo);
 	void ResetImpl(bool playNextVideo = false);
 
 	// members
-	std::string                     currentVideo;
-	cv::VideoCapture                cap;
-	std::unique_ptr<ImGui::Texture> texture;
-	ImVec2                          displaySize{ 0.0f, 0.0f };
-	PLAYBACK_MODE                   playbackMode{ PLAYBACK_MODE::kLoop };
-	std::uint32_t                   videoWidth{ 0 };
-	std::uint32_t                   videoHeight{ 0 };
-	float                           targetFPS{ 30.0f };
-	std::atomic<float>              actualFPS{ 0.0f };
-	std::uint32_t                   frameCount{ 0 };
-	duration                        frameDuration{ 0.0 };
-	std::atomic<std::uint32_t>      readFrameCount{ 0 };
-	std::atomic<float>              elapsedTime{ 0.0f };
-	duration                        debugUpdateInterval{ 0.1 };
-	cv::Mat                         videoFrame;
-	mutable Lock                    videoFrameLock;
-	ComPtr<IMFSourceReader>         audioReader{};
-	ComPtr<IMFSinkWriter>           audioWriter{};
-	ComPtr<IMFMediaSink>            mediaSink{};
-	ComPtr<IMFSimpleAudioVolume>    audioVolume{};
-	std::atomic<float>              volume{ 1.0f };
-	time_point                      volumeDisplayStart{};
-	std::jthread                    audioThread;
-	std::jthread                    videoThread;
-	std::jthread                    resetThread;
-	std::barrier<>                  startBarrier{ 2 };
-	std::atomic<bool>               audioLoaded{ false };
-	std::atomic<PLAYBACK_STATE>     playbackState{ PLAYBACK_STATE::kIdle };
-
-	static constexpr duration volumeDisplayDuration{ 1.5 };
+	std::string                         currentVideo;
+	std::string                         currentAudio;  // the video itself, or a sequence's soundtrack
+	std::unique_ptr<Clock>              playbackClock{ std::make_unique<SteadyClock>() };
+	bool                                simulateTime{ false };
+	cv::VideoCapture                    cap;
+	bool                                warmStartEnabled{ true };
+	WarmStart                           warmStart;
+	std::jthread                        warmThread;
+	std::deque<PrerolledFrame>          prerolledFrames;
+	Memory::Usage                       prerollMemory{ Memory::Category::kFrames };
+	std::atomic<bool>                   softwareDecode{ false };
+	DecodeWatchdog                      watchdog;
+	std::atomic<bool>                   decoderHung{ false };
+	ImageSequence                       sequence;
+	std::unique_ptr<ImGui::Texture>     texture;
+	ImVec2                              displaySize{ 0.0f, 0.0f };
+	PLAYBACK_MODE                       playbackMode{ PLAYBACK_MODE::kLoop };
+	std::uint32_t                       videoWidth{ 0 };
+	std::uint32_t                       videoHeight{ 0 };
+	float                               targetFPS{ 30.0f };
+	std::atomic<float>                  actualFPS{ 0.0f };
+	std::atomic<float>                  contentFPS{ 0.0f };  // measured from frame timestamps
+	std::atomic<bool>                   variableFrameRate{ false };
+	std::uint32_t                       frameCount{ 0 };
+	duration                            frameDuration{ 0.0 };
+	std::atomic<std::uint32_t>          readFrameCount{ 0 };
+	bool                                pipelinedConversion{ true };
+	std::uint32_t                       convertThreads{ 0 };  // stripe helpers, 0 = automatic
+	std::atomic<std::uint32_t>          convertStripeThreads{ 0 };
+	std::atomic<float>                  decodeOccupancy{ 0.0f };  // share of the last overlay update spent in each stage
+	std::atomic<float>                  convertOccupancy{ 0.0f };
+	bool                                use16BitFrames{ false };
+	bool                                ditherFrames{ true };
+	DXGI_FORMAT                         frameFormat{ DXGI_FORMAT_B8G8R8A8_UNORM };  // of the texture, decided once the device is known
+	bool                                skipRepeatedFrames{ true };
+	std::atomic<std::uint32_t>          repeatedFrames{ 0 };  // identical to the frame on screen, neither converted nor uploaded
+	std::atomic<std::uint32_t>          comparedFrames{ 0 };
+	bool                                randomStart{ false };
+	duration                            startOffset{ 0.0 };
+	std::atomic<KeyframeIndexPtr>       keyframeIndex;
+	std::jthread                        indexThread;
+	std::atomic<float>                  lastSeekTime{ 0.0f };
+	std::atomic<float>                  elapsedTime{ 0.0f };
+	duration                            debugUpdateInterval{ 0.1 };
+	time_point                          loadStartTime{};
+	QualityController                   qualityController;
+	time_point                          lastPresentTime{};
+	bool                                usePosterCache{ true };
+	bool                                posterLoaded{ false };
+	bool                                bakeLoops{ false };
+	std::uint32_t                       maxBakeSizeMB{ 2048 };
+	BakedVideo::Reader                  bakedVideo;
+	std::unique_ptr<BakedVideo::Writer> bakeWriter;
+	std::atomic<bool>                   firstPixelPending{ false };
+	std::atomic<float>                  firstPixelTime{ 0.0f };  // ms, until the playthrough is added to the history
+	History::Store*                     history{ nullptr };
+	const Visibility::Source*           visibility{ nullptr };
+	std::atomic<bool>                   suspended{ false };
+	cv::Mat                             videoFrame;
+	mutable Lock                        videoFrameLock;
+	std::atomic<std::uint64_t>          videoFrameSerial{ 0 };  // bumped whenever videoFrame changes
+	std::uint64_t                       uploadedFrameSerial{ 0 };
+	time_point                          uploadWindowStart{};
+	std::uint64_t                       uploadWindowBytes{ 0 };
+	std::uint32_t                       uploadWindowFrames{ 0 };
+	duration                            uploadWindowTime{ 0.0 };
+	std::atomic<float>                  uploadRate{ 0.0f };  // bytes per second over the last second of uploads
+	std::atomic<float>                  uploadCost{ 0.0f };  // ms per frame
+	bool                                blendFrames{ false };
+	float                               blendBudgetMs{ 3.0f };
+	std::atomic<bool>                   blendActive{ false };  // blendFrames, for BGRA textures, until it goes over budget
+	cv::Mat                             previousVideoFrame;    // the frame videoFrame replaced, faded out while blending
+	time_point                          videoFramePublished{};
+	std::uint32_t                       uploadedBlendWeight{ Blend::fullWeight };
+	time_point                          lastBlendPresent{};
+	duration                            presentInterval{ 0.0 };  // smoothed, while blending
+	std::uint32_t                       blendWindowFrames{ 0 };
+	duration                            blendWindowTime{ 0.0 };
+	std::atomic<float>                  blendCost{ 0.0f };  // ms per blended upload
+	Memory::Usage                       frameMemory{ Memory::Category::kFrames };
+	Memory::Usage                       publishMemory{ Memory::Category::kFrames };  // the published frame and the one it replaced
+	Memory::Usage                       textureMemory{ Memory::Category::kTexture };
+	ComPtr<IMFSourceReader>             audioReader{};
+	ComPtr<IMFSinkWriter>               audioWriter{};
+	ComPtr<IMFMediaSink>                mediaSink{};
+	ComPtr<IMFSimpleAudioVolume>        audioVolume{};  // also read by the reset thread, only through GetAudioVolume
+	mutable std::mutex                  audioVolumeLock;
+	bool                                useAudioCache{ true };
+	std::uint32_t                       maxAudioCacheMB{ 128 };
+	AudioCache::Reader                  cachedAudio;
+	duration                            cachedAudioStart{ 0.0 };
+	std::unique_ptr<AudioCache::Writer> audioCacheWriter;
+	std::atomic<float>                  volume{ 1.0f };
+	time_point                          volumeDisplayStart{};
+	std::jthread                        audioThread;
+	std::jthread                        videoThread;
+	std::jthread                        resetThread;
+	std::jthread                        cleanupThread;
+	std::uint32_t                       teardownTimeoutMs{ 250 };
+	std::barrier<>                      startBarrier{ 2 };
+	std::atomic<bool>                   audioLoaded{ false };
+	std::atomic<PLAYBACK_STATE>         playbackState{ PLAYBACK_STATE::kIdle };
+	bool                                telemetryEnabled{ false };
+	Telemetry::Writer                   telemetry;
+
+	static constexpr duration      volumeDisplayDuration{ 1.5 };
+	static constexpr duration      maxSleepSlice{ 0.05 };
+	static constexpr std::size_t   prerollFrameCount{ 8 };
+	static constexpr std::uint32_t posterMagic{ 0x50564D4D };       // MMVP
+	static constexpr std::uint32_t fallbackMagic{ 0x46564D4D };     // MMVF
+	static constexpr double        randomStartMaxFraction{ 0.75 };  // leave most of the video ahead of a random start
 };
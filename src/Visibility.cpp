@@ -0,0 +1,48 @@
+#include "Visibility.h"
+
+namespace Visibility
+{
+	void GameWindow::LoadSettings(CSimpleIniA& a_ini)
+	{
+		ini::get_value(a_ini, suspendWhenMinimized, "Background", "bSuspendWhenMinimized", ";Stop decoding video while the game is minimized or stops rendering (audio keeps playing)");
+		ini::get_value(a_ini, suspendWhenUnfocused, "Background", "bSuspendWhenUnfocused", ";Also stop decoding while another window has focus");
+	}
+
+	void GameWindow::OnPresent(HWND a_window)
+	{
+		window.store(a_window, std::memory_order_relaxed);
+		lastPresentTime.store(std::chrono::steady_clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+	}
+
+	bool GameWindow::IsVisible() const
+	{
+		if (!suspendWhenMinimized && !suspendWhenUnfocused) {
+			return true;
+		}
+
+		const auto lastPresent = lastPresentTime.load(std::memory_order_relaxed);
+		const auto hwnd = window.load(std::memory_order_relaxed);
+		if (lastPresent == 0 || !hwnd) {
+			return true;  // nothing presented yet, don't hold back the first frames
+		}
+
+		if (IsIconic(hwnd)) {
+			return false;
+		}
+
+		const auto sinceLastPresent = std::chrono::steady_clock::now().time_since_epoch() - std::chrono::steady_clock::duration(lastPresent);
+		if (sinceLastPresent > presentTimeout) {
+			return false;
+		}
+
+		if (suspendWhenUnfocused) {
+			DWORD foregroundProcess = 0;
+			GetWindowThreadProcessId(GetForegroundWindow(), &foregroundProcess);
+			if (foregroundProcess != GetCurrentProcessId()) {
+				return false;
+			}
+		}
+
+		return true;
+	}
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+namespace Visibility
+{
+	// what the player asks before decoding, so suspend/resume doesn't depend on a real window
+	class Source
+	{
+	public:
+		virtual ~Source() = default;
+
+		virtual bool IsVisible() const = 0;
+	};
+
+	// visible while the game window is restored (and optionally focused) and still presenting frames
+	class GameWindow : public Source
+	{
+	public:
+		void LoadSettings(CSimpleIniA& a_ini);
+
+		// called from the present hook
+		void OnPresent(HWND a_window);
+
+		bool IsVisible() const override;
+
+	private:
+		// members
+		bool                      suspendWhenMinimized{ true };
+		bool                      suspendWhenUnfocused{ false };
+		std::atomic<HWND>         window{ nullptr };
+		std::atomic<std::int64_t> lastPresentTime{ 0 };  // steady_clock ticks, 0 = no present seen yet
+
+		// the game stops presenting when it loses focus with bAlwaysActive off
+		static constexpr std::chrono::milliseconds presentTimeout{ 500 };
+	};
+}
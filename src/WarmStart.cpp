@@ -0,0 +1,65 @@
+#include "WarmStart.h"
+
+bool WarmStart::Begin(const std::string& a_path)
+{
+	Locker locker(lock);
+	if (state != State::kIdle) {
+		return false;
+	}
+	state = State::kPreparing;
+	path = a_path;
+	return true;
+}
+
+void WarmStart::Finish(bool a_opened)
+{
+	Locker locker(lock);
+	if (state == State::kPreparing) {
+		state = a_opened ? State::kPrepared : State::kFailed;
+	}
+}
+
+bool WarmStart::OnDeviceReady() const
+{
+	Locker locker(lock);
+	// still preparing, the texture is created when playback claims it instead
+	return state == State::kPrepared && !bound;
+}
+
+void WarmStart::MarkBound()
+{
+	Locker locker(lock);
+	bound = true;
+}
+
+WarmStart::Claim WarmStart::Take(const std::string& a_path)
+{
+	Locker locker(lock);
+	switch (state) {
+	case State::kPrepared:
+		// the screen height (and with it the chosen variant) may have changed since kPostLoad
+		if (path == a_path) {
+			state = State::kClaimed;
+			return Claim::kWarm;
+		}
+		state = State::kDiscarded;
+		return Claim::kDiscarded;
+	case State::kFailed:
+		state = State::kDiscarded;
+		return Claim::kDiscarded;
+	default:
+		return Claim::kCold;
+	}
+}
+
+WarmStart::State WarmStart::GetState() const
+{
+	Locker locker(lock);
+	return state;
+}
+
+bool WarmStart::IsBound() const
+{
+	Locker locker(lock);
+	return bound;
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+// Lifecycle of the first boot's video, which is opened and pre-rolled at kPostLoad instead of when the first loading screen opens.
+// The texture can only be created once the renderer exists, which may happen before or after preparation finishes.
+class WarmStart
+{
+public:
+	enum class State : std::uint8_t
+	{
+		kIdle,
+		kPreparing,  // opening and pre-rolling on a background thread
+		kPrepared,
+		kFailed,
+		kClaimed,   // handed to playback
+		kDiscarded  // a different video was loaded, the prepared one has to be released
+	};
+
+	enum class Claim : std::uint8_t
+	{
+		kCold,      // nothing usable was prepared, load normally
+		kWarm,      // play the prepared video
+		kDiscarded  // release the prepared video, then load normally
+	};
+
+	bool Begin(const std::string& a_path);
+	void Finish(bool a_opened);
+
+	// true if a prepared video is still waiting for its texture, MarkBound once the caller has created it
+	bool OnDeviceReady() const;
+	void MarkBound();
+
+	Claim Take(const std::string& a_path);
+
+	State GetState() const;
+	bool  IsBound() const;
+
+private:
+	using Lock = std::mutex;
+	using Locker = std::scoped_lock<Lock>;
+
+	// members
+	mutable Lock lock;
+	State        state{ State::kIdle };
+	std::string  path;
+	bool         bound{ false };
+};
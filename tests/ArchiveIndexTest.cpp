@@ -0,0 +1,280 @@
+#include "ArchiveIndex.h"
+
+namespace
+{
+	struct Stored
+	{
+		std::string name;
+		std::string data;
+		bool        toggleCompression{ false };  // the per file bit that flips the archive's default
+	};
+
+	struct Folder
+	{
+		std::string         name;
+		std::vector<Stored> files;
+	};
+
+	template <class T>
+	void write(std::string& a_out, T a_value)
+	{
+		a_out.append(reinterpret_cast<const char*>(&a_value), sizeof(T));
+	}
+
+	// a BSA laid out the way Archive.exe writes one: header, folder records, folder names with their file records,
+	// file names, then the data (each file's path in front of it with embedded names)
+	std::string make_bsa(std::uint32_t a_version, std::uint32_t a_flags, const std::vector<Folder>& a_folders)
+	{
+		constexpr std::uint32_t headerSize = 36;
+		const std::uint32_t     folderRecordSize = a_version == 105 ? 24 : 16;
+		const bool              embeddedNames = (a_flags & 0x100) != 0;
+
+		std::uint32_t fileCount = 0;
+		std::uint32_t folderNamesLength = 0;
+		std::uint32_t fileNamesLength = 0;
+		for (const auto& folder : a_folders) {
+			fileCount += static_cast<std::uint32_t>(folder.files.size());
+			folderNamesLength += static_cast<std::uint32_t>(folder.name.size() + 1);
+			for (const auto& file : folder.files) {
+				fileNamesLength += static_cast<std::uint32_t>(file.name.size() + 1);
+			}
+		}
+
+		std::string archive("BSA\0"sv);
+		for (const auto value : { a_version, headerSize, a_flags, static_cast<std::uint32_t>(a_folders.size()), fileCount, folderNamesLength, fileNamesLength, 0u }) {
+			write(archive, value);
+		}
+
+		for (const auto& folder : a_folders) {
+			write(archive, std::uint64_t{ 0 });  // hash, unused
+			write(archive, static_cast<std::uint32_t>(folder.files.size()));
+			archive.append(folderRecordSize - 12, '\0');
+		}
+
+		// data offsets are only known once the tables are, so the file records are patched in below
+		std::vector<std::size_t> recordPositions;
+		for (const auto& folder : a_folders) {
+			write(archive, static_cast<std::uint8_t>(folder.name.size() + 1));
+			archive.append(folder.name);
+			archive.push_back('\0');
+			for (std::size_t i = 0; i < folder.files.size(); ++i) {
+				recordPositions.push_back(archive.size());
+				archive.append(16, '\0');
+			}
+		}
+
+		for (const auto& folder : a_folders) {
+			for (const auto& file : folder.files) {
+				archive.append(file.name);
+				archive.push_back('\0');
+			}
+		}
+
+		std::size_t record = 0;
+		for (const auto& folder : a_folders) {
+			for (const auto& file : folder.files) {
+				const auto offset = static_cast<std::uint32_t>(archive.size());
+				if (embeddedNames) {
+					const auto path = folder.name + '\\' + file.name;
+					write(archive, static_cast<std::uint8_t>(path.size()));
+					archive.append(path);
+				}
+				archive.append(file.data);
+
+				auto size = static_cast<std::uint32_t>(archive.size() - offset);
+				if (file.toggleCompression) {
+					size |= 1u << 30;
+				}
+				std::memcpy(archive.data() + recordPositions[record] + 8, &size, 4);
+				std::memcpy(archive.data() + recordPositions[record] + 12, &offset, 4);
+				record++;
+			}
+		}
+		return archive;
+	}
+
+	struct GeneralFile
+	{
+		std::string   path;
+		std::string   data;
+		std::uint32_t packedSize{ 0 };  // 0 for stored uncompressed
+	};
+
+	// a general BA2: header, 36 byte file records, the data, then the name table the header points at
+	std::string make_ba2(std::uint32_t a_version, std::string_view a_type, const std::vector<GeneralFile>& a_files)
+	{
+		std::string archive("BTDX"sv);
+		write(archive, a_version);
+		archive.append(a_type);
+		write(archive, static_cast<std::uint32_t>(a_files.size()));
+		const auto namesOffsetPosition = archive.size();
+		write(archive, std::uint64_t{ 0 });
+		if (a_version == 2 || a_version == 3) {
+			archive.append(a_version == 3 ? 12 : 8, '\0');
+		}
+
+		const auto recordsStart = archive.size();
+		archive.append(a_files.size() * 36, '\0');
+
+		for (std::size_t i = 0; i < a_files.size(); ++i) {
+			const auto& file = a_files[i];
+			const auto  offset = static_cast<std::uint64_t>(archive.size());
+			const auto  size = static_cast<std::uint32_t>(file.data.size());
+			const auto  position = recordsStart + i * 36;
+			std::memcpy(archive.data() + position + 16, &offset, 8);
+			std::memcpy(archive.data() + position + 24, &file.packedSize, 4);
+			std::memcpy(archive.data() + position + 28, &size, 4);
+			std::memcpy(archive.data() + position + 32, "\x0D\xF0\xAD\xBA", 4);
+			archive.append(file.data);
+		}
+
+		const auto namesOffset = static_cast<std::uint64_t>(archive.size());
+		std::memcpy(archive.data() + namesOffsetPosition, &namesOffset, 8);
+		for (const auto& file : a_files) {
+			write(archive, static_cast<std::uint16_t>(file.path.size()));
+			archive.append(file.path);
+		}
+		return archive;
+	}
+
+	std::optional<std::vector<ArchiveIndex::File>> read(const std::string& a_archive, std::string_view a_directory)
+	{
+		std::istringstream stream(a_archive, std::ios::binary);
+		return ArchiveIndex::Read(stream, a_directory);
+	}
+
+	std::string_view get_bytes(const std::string& a_archive, const ArchiveIndex::File& a_file)
+	{
+		return std::string_view(a_archive).substr(static_cast<std::size_t>(a_file.offset), static_cast<std::size_t>(a_file.size));
+	}
+
+	constexpr std::uint32_t directoryNames{ 1 << 0 };
+	constexpr std::uint32_t fileNames{ 1 << 1 };
+	constexpr std::uint32_t compressedDefault{ 1 << 2 };
+	constexpr std::uint32_t embeddedNames{ 1 << 8 };
+
+	const std::vector<Folder> folders{
+		{ "textures\\menus", { { "background.dds", "not a video" } } },
+		{ "MainMenuVideo", { { "Intro.mp4", "intro bytes" }, { "outro.webm", "outro" } } },
+		{ "mainmenuvideo\\old", { { "nested.mp4", "nested" } } }
+	};
+}
+
+TEST(ArchiveIndex, ReadsBSA104)
+{
+	const auto archive = make_bsa(104, directoryNames | fileNames, folders);
+	const auto files = read(archive, "MainMenuVideo"sv);
+	ASSERT_TRUE(files);
+	ASSERT_EQ(files->size(), 2u);
+
+	EXPECT_EQ((*files)[0].name, "mainmenuvideo\\intro.mp4");
+	EXPECT_EQ(get_bytes(archive, (*files)[0]), "intro bytes");
+	EXPECT_FALSE((*files)[0].compressed);
+	EXPECT_EQ((*files)[1].name, "mainmenuvideo\\outro.webm");
+	EXPECT_EQ(get_bytes(archive, (*files)[1]), "outro");
+}
+
+TEST(ArchiveIndex, ReadsBSA105)
+{
+	// 105 widened the folder records to 24 bytes
+	const auto archive = make_bsa(105, directoryNames | fileNames, folders);
+	const auto files = read(archive, "mainmenuvideo\\"sv);
+	ASSERT_TRUE(files);
+	ASSERT_EQ(files->size(), 2u);
+	EXPECT_EQ((*files)[0].name, "mainmenuvideo\\intro.mp4");
+	EXPECT_EQ(get_bytes(archive, (*files)[0]), "intro bytes");
+	EXPECT_EQ(get_bytes(archive, (*files)[1]), "outro");
+}
+
+TEST(ArchiveIndex, EmbeddedNamesAreSkipped)
+{
+	for (const std::uint32_t version : { 104u, 105u }) {
+		const auto archive = make_bsa(version, directoryNames | fileNames | embeddedNames, folders);
+		const auto files = read(archive, "MainMenuVideo"sv);
+		ASSERT_TRUE(files) << version;
+		ASSERT_EQ(files->size(), 2u) << version;
+		EXPECT_EQ(get_bytes(archive, (*files)[0]), "intro bytes") << version;
+		EXPECT_EQ(get_bytes(archive, (*files)[1]), "outro") << version;
+	}
+}
+
+TEST(ArchiveIndex, BSACompressedFlag)
+{
+	const std::vector<Folder> mixed{
+		{ "mainmenuvideo", { { "default.mp4", "aaaa" }, { "toggled.mp4", "bbbb", true } } }
+	};
+
+	// the archive's default applies unless a file's size carries the toggle bit, which isn't part of the size
+	const auto stored = make_bsa(105, directoryNames | fileNames, mixed);
+	const auto storedFiles = read(stored, "mainmenuvideo"sv);
+	ASSERT_TRUE(storedFiles);
+	ASSERT_EQ(storedFiles->size(), 2u);
+	EXPECT_FALSE((*storedFiles)[0].compressed);
+	EXPECT_TRUE((*storedFiles)[1].compressed);
+	EXPECT_EQ((*storedFiles)[1].size, 4u);
+
+	const auto compressed = make_bsa(104, directoryNames | fileNames | compressedDefault, mixed);
+	const auto compressedFiles = read(compressed, "mainmenuvideo"sv);
+	ASSERT_TRUE(compressedFiles);
+	ASSERT_EQ(compressedFiles->size(), 2u);
+	EXPECT_TRUE((*compressedFiles)[0].compressed);
+	EXPECT_FALSE((*compressedFiles)[1].compressed);
+	EXPECT_EQ(get_bytes(compressed, (*compressedFiles)[1]), "bbbb");
+}
+
+TEST(ArchiveIndex, BSAWithoutNamesHasNothingToFind)
+{
+	const auto files = read(make_bsa(105, 0, folders), "MainMenuVideo"sv);
+	ASSERT_TRUE(files);
+	EXPECT_TRUE(files->empty());
+}
+
+TEST(ArchiveIndex, ReadsGeneralBA2)
+{
+	const std::vector<GeneralFile> general{
+		{ "Textures/menus/background.dds", "not a video" },
+		{ "MainMenuVideo\\Intro.mp4", "intro bytes" },
+		{ "mainmenuvideo/old/nested.mp4", "nested" },
+		{ "mainmenuvideo\\outro.webm", "outro" }
+	};
+
+	for (const std::uint32_t version : { 1u, 2u, 3u }) {
+		const auto archive = make_ba2(version, "GNRL"sv, general);
+		const auto files = read(archive, "MainMenuVideo"sv);
+		ASSERT_TRUE(files) << version;
+		ASSERT_EQ(files->size(), 2u) << version;
+		EXPECT_EQ((*files)[0].name, "mainmenuvideo\\intro.mp4");
+		EXPECT_EQ(get_bytes(archive, (*files)[0]), "intro bytes");
+		EXPECT_FALSE((*files)[0].compressed);
+		EXPECT_EQ((*files)[1].name, "mainmenuvideo\\outro.webm");
+		EXPECT_EQ(get_bytes(archive, (*files)[1]), "outro");
+	}
+
+	const auto everything = read(make_ba2(1, "GNRL"sv, general), ""sv);
+	ASSERT_TRUE(everything);
+	EXPECT_EQ(everything->size(), general.size());
+}
+
+TEST(ArchiveIndex, BA2CompressedFlag)
+{
+	// a packed size means the data is zlib, and that's what a reader would have to take out of the archive
+	const auto files = read(make_ba2(1, "GNRL"sv, { { "mainmenuvideo\\packed.mp4", "zlib", 4 }, { "mainmenuvideo\\stored.mp4", "raw bytes" } }), "mainmenuvideo"sv);
+	ASSERT_TRUE(files);
+	ASSERT_EQ(files->size(), 2u);
+	EXPECT_TRUE((*files)[0].compressed);
+	EXPECT_EQ((*files)[0].size, 4u);
+	EXPECT_FALSE((*files)[1].compressed);
+	EXPECT_EQ((*files)[1].size, 9u);
+}
+
+TEST(ArchiveIndex, OtherFilesAreNotArchives)
+{
+	EXPECT_FALSE(read(make_ba2(1, "DX10"sv, { { "mainmenuvideo\\intro.mp4", "intro" } }), "mainmenuvideo"sv));
+	EXPECT_FALSE(read(make_bsa(106, directoryNames | fileNames, folders), "mainmenuvideo"sv));
+	EXPECT_FALSE(read("RIFF\x10\0\0\0WAVE"s, "mainmenuvideo"sv));
+	EXPECT_FALSE(read(""s, "mainmenuvideo"sv));
+
+	// cut short inside the tables
+	const auto archive = make_bsa(105, directoryNames | fileNames, folders);
+	EXPECT_FALSE(read(archive.substr(0, 60), "mainmenuvideo"sv));
+}
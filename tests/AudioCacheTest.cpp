@@ -0,0 +1,137 @@
+#include "AudioCacheFile.h"
+
+#include "TempFile.h"
+
+namespace
+{
+	constexpr Cache::Stamp  stamp{ 424242, 123456789 };
+	constexpr std::uint64_t maxBytes{ 1024 * 1024 };
+
+	// 48 kHz stereo 16 bit PCM, a frame is 4 bytes
+	constexpr WAVEFORMATEX format{ 1, 2, 48000, 48000 * 4, 4, 16, 0 };
+
+	// what the decoder hands the writer, a few buffers at a time
+	std::vector<std::uint8_t> make_samples(std::size_t a_size)
+	{
+		std::vector<std::uint8_t> samples(a_size);
+		for (std::size_t i = 0; i < a_size; i++) {
+			samples[i] = static_cast<std::uint8_t>(i * 31 + 7);
+		}
+		return samples;
+	}
+
+	std::vector<std::uint8_t> read_file(const std::filesystem::path& a_path)
+	{
+		std::ifstream file(a_path, std::ios::binary);
+		return { std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>() };
+	}
+
+	std::filesystem::path temp_path(const std::filesystem::path& a_path)
+	{
+		auto tempPath = a_path;
+		tempPath += ".tmp";
+		return tempPath;
+	}
+
+	void write(const std::filesystem::path& a_path, std::span<const std::uint8_t> a_samples, std::size_t a_bufferSize)
+	{
+		AudioCache::Writer writer;
+		ASSERT_TRUE(writer.Begin(a_path, stamp, &format, sizeof(format), maxBytes));
+		for (std::size_t offset = 0; offset < a_samples.size(); offset += a_bufferSize) {
+			ASSERT_TRUE(writer.Append(a_samples.subspan(offset, std::min(a_bufferSize, a_samples.size() - offset))));
+		}
+		writer.Finish();
+		EXPECT_FALSE(writer.IsActive());
+	}
+}
+
+TEST(AudioCache, RoundTrips)
+{
+	const TempFile file("mmv_audio_test.pcm");
+	const auto     samples = make_samples(4800 * 4);
+	write(file.path, samples, 1000 * 4);
+	EXPECT_FALSE(std::filesystem::exists(temp_path(file.path)));
+
+	const auto bytes = read_file(file.path);
+	const auto header = AudioCache::Validate(bytes, stamp);
+	ASSERT_TRUE(header);
+	EXPECT_EQ(header->formatBytes, sizeof(WAVEFORMATEX));
+	EXPECT_EQ(header->dataBytes, samples.size());
+
+	// the format the renderer accepted, then the samples exactly as decoded
+	const auto formatStart = bytes.begin() + sizeof(AudioCache::Header);
+	EXPECT_EQ(std::memcmp(&*formatStart, &format, sizeof(format)), 0);
+	EXPECT_TRUE(std::equal(samples.begin(), samples.end(), formatStart + header->formatBytes, bytes.end()));
+}
+
+TEST(AudioCache, ChangedSourceIsRejected)
+{
+	const TempFile file("mmv_audio_test.pcm");
+	write(file.path, make_samples(64), 64);
+
+	auto changed = stamp;
+	changed.writeTime++;
+	EXPECT_FALSE(AudioCache::Validate(read_file(file.path), changed));
+}
+
+TEST(AudioCache, TruncatedFileIsRejected)
+{
+	const TempFile file("mmv_audio_test.pcm");
+	write(file.path, make_samples(64), 64);
+
+	auto bytes = read_file(file.path);
+	ASSERT_TRUE(AudioCache::Validate(bytes, stamp));
+
+	bytes.resize(bytes.size() - 4);
+	EXPECT_FALSE(AudioCache::Validate(bytes, stamp));
+	EXPECT_FALSE(AudioCache::Validate(std::span(bytes).first(sizeof(AudioCache::Header) - 1), stamp));
+}
+
+TEST(AudioCache, PartialSampleFrameIsRejected)
+{
+	const TempFile file("mmv_audio_test.pcm");
+	write(file.path, make_samples(66), 66);  // half a frame at the end
+
+	EXPECT_FALSE(AudioCache::Validate(read_file(file.path), stamp));
+}
+
+TEST(AudioCache, OversizedTrackIsAbandoned)
+{
+	const TempFile     file("mmv_audio_test.pcm");
+	const auto         samples = make_samples(64);
+	AudioCache::Writer writer;
+	ASSERT_TRUE(writer.Begin(file.path, stamp, &format, sizeof(format), 48));
+
+	EXPECT_TRUE(writer.Append(std::span(samples).first(32)));
+	EXPECT_FALSE(writer.Append(std::span(samples).subspan(32)));
+	EXPECT_FALSE(writer.IsActive());
+
+	writer.Finish();
+	EXPECT_FALSE(std::filesystem::exists(file.path));
+	EXPECT_FALSE(std::filesystem::exists(temp_path(file.path)));
+}
+
+TEST(AudioCache, UnfinishedTrackLeavesNothing)
+{
+	const TempFile file("mmv_audio_test.pcm");
+	{
+		AudioCache::Writer writer;
+		ASSERT_TRUE(writer.Begin(file.path, stamp, &format, sizeof(format), maxBytes));
+		ASSERT_TRUE(writer.Append(make_samples(64)));
+		EXPECT_TRUE(std::filesystem::exists(temp_path(file.path)));
+	}
+	EXPECT_FALSE(std::filesystem::exists(file.path));
+	EXPECT_FALSE(std::filesystem::exists(temp_path(file.path)));
+}
+
+TEST(AudioCache, FormatWithoutFramesIsRefused)
+{
+	const TempFile     file("mmv_audio_test.pcm");
+	auto               broken = format;
+	AudioCache::Writer writer;
+
+	broken.nBlockAlign = 0;
+	EXPECT_FALSE(writer.Begin(file.path, stamp, &broken, sizeof(broken), maxBytes));
+	EXPECT_FALSE(writer.Begin(file.path, stamp, &format, sizeof(format) - 1, maxBytes));
+	EXPECT_FALSE(writer.IsActive());
+}
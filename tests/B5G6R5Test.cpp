@@ -0,0 +1,110 @@
+#include "B5G6R5.h"
+
+namespace
+{
+	// the packing written out per pixel, to check the SSE2 path against
+	std::uint16_t reference(const std::uint8_t* a_bgra, std::uint32_t a_x, std::uint32_t a_row, bool a_dither)
+	{
+		constexpr int bayer[4][4]{ { 0, 8, 2, 10 }, { 12, 4, 14, 6 }, { 3, 11, 1, 9 }, { 15, 7, 13, 5 } };
+
+		// a threshold of 8 of 16 is half a step, which rounds
+		const int  threshold = a_dither ? bayer[a_row % 4][a_x % 4] : 8;
+		const auto quantise = [&](int a_value, int a_bits) {
+			const int step = 256 >> a_bits;
+			return std::min(a_value + threshold * step / 16, 255) >> (8 - a_bits);
+		};
+
+		const int b = quantise(a_bgra[0], 5);
+		const int g = quantise(a_bgra[1], 6);
+		const int r = quantise(a_bgra[2], 5);
+		return static_cast<std::uint16_t>(r << 11 | g << 5 | b);
+	}
+
+	std::vector<std::uint8_t> make_row(std::uint32_t a_width, std::uint32_t a_seed)
+	{
+		std::vector<std::uint8_t> row(a_width * 4);
+		std::mt19937              rng(a_seed);
+		for (auto& value : row) {
+			value = static_cast<std::uint8_t>(rng());
+		}
+		return row;
+	}
+}
+
+TEST(B5G6R5, PackRowMatchesReference)
+{
+	// widths around the 8 pixel step, so the scalar tail is covered too
+	for (std::uint32_t width = 1; width <= 41; ++width) {
+		const auto                 bgra = make_row(width, width);
+		std::vector<std::uint16_t> packed(width);
+		for (std::uint32_t row = 0; row < 4; ++row) {
+			for (const bool dither : { false, true }) {
+				B5G6R5::PackRow(bgra.data(), packed.data(), width, row, dither);
+				for (std::uint32_t x = 0; x < width; ++x) {
+					ASSERT_EQ(packed[x], reference(bgra.data() + x * 4, x, row, dither)) << "width " << width << ", row " << row << ", x " << x << (dither ? ", dithered" : "");
+				}
+			}
+		}
+	}
+}
+
+TEST(B5G6R5, ExtremesSaturate)
+{
+	const std::vector<std::uint8_t> white(16 * 4, 255);
+	const std::vector<std::uint8_t> black(16 * 4, 0);
+	std::vector<std::uint16_t>      packed(16);
+
+	for (const bool dither : { false, true }) {
+		B5G6R5::PackRow(white.data(), packed.data(), 16, 3, dither);
+		EXPECT_TRUE(std::ranges::all_of(packed, [](std::uint16_t a_pixel) { return a_pixel == 0xFFFF; }));
+		B5G6R5::PackRow(black.data(), packed.data(), 16, 3, dither);
+		EXPECT_TRUE(std::ranges::all_of(packed, [](std::uint16_t a_pixel) { return a_pixel == 0; }));
+	}
+}
+
+TEST(B5G6R5, DitherKeepsTheAverageColour)
+{
+	// a flat colour between two 565 steps; rounding snaps it to one, the pattern mixes both
+	const cv::Mat flat(64, 64, CV_8UC4, cv::Scalar(99, 101, 203, 255));
+
+	for (const bool dither : { false, true }) {
+		cv::Mat packed;
+		cv::Mat unpacked;
+		B5G6R5::Pack(flat, packed, dither);
+		B5G6R5::Unpack(packed, unpacked);
+
+		for (int c = 0; c < 3; ++c) {
+			double sum = 0.0;
+			for (int y = 0; y < unpacked.rows; ++y) {
+				for (int x = 0; x < unpacked.cols; ++x) {
+					sum += unpacked.ptr<std::uint8_t>(y)[x * 4 + c];
+				}
+			}
+			const double mean = sum / static_cast<double>(unpacked.total());
+			const double original = flat.ptr<std::uint8_t>(0)[c];
+			EXPECT_NEAR(mean, original, dither ? 1.5 : 4.0) << "channel " << c << (dither ? ", dithered" : "");
+		}
+	}
+}
+
+TEST(B5G6R5, StripesContinueThePattern)
+{
+	cv::Mat frame(40, 37, CV_8UC4);
+	for (int y = 0; y < frame.rows; ++y) {
+		const auto row = make_row(37, static_cast<std::uint32_t>(100 + y));
+		std::memcpy(frame.ptr(y), row.data(), row.size());
+	}
+
+	cv::Mat whole;
+	B5G6R5::Pack(frame, whole, true);
+
+	// the second stripe starts on row 13, a_firstRow keeps it on the same line of the pattern
+	for (const auto& [begin, end] : { std::pair{ 0, 13 }, std::pair{ 13, 40 } }) {
+		const cv::Mat stripe(end - begin, frame.cols, CV_8UC4, frame.ptr(begin), frame.step);
+		cv::Mat       packed;
+		B5G6R5::Pack(stripe, packed, true, begin);
+		for (int y = 0; y < packed.rows; ++y) {
+			EXPECT_EQ(std::memcmp(packed.ptr(y), whole.ptr(begin + y), frame.cols * sizeof(std::uint16_t)), 0) << "row " << begin + y;
+		}
+	}
+}
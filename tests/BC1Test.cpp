@@ -0,0 +1,101 @@
+#include "BC1.h"
+#include "FrameFormat.h"
+#include "QOI.h"
+
+namespace
+{
+	// smooth gradients with a few hard edges, the kind of content menu loops have
+	cv::Mat make_frame(int a_width, int a_height)
+	{
+		cv::Mat frame(a_height, a_width, CV_8UC4);
+		for (int y = 0; y < a_height; ++y) {
+			auto* row = frame.ptr<std::uint8_t>(y);
+			for (int x = 0; x < a_width; ++x) {
+				row[x * 4 + 0] = static_cast<std::uint8_t>(128.0 + 100.0 * std::sin(x * 0.02));
+				row[x * 4 + 1] = static_cast<std::uint8_t>(y * 255 / a_height);
+				row[x * 4 + 2] = x < a_width / 2 ? static_cast<std::uint8_t>((x + y) / 4) : std::uint8_t(200);
+				row[x * 4 + 3] = 255;
+			}
+		}
+		return frame;
+	}
+
+	// BC1 is lossy, but gradients like these should come back well above what's visible at a glance
+	constexpr double minPSNR{ 32.0 };
+}
+
+TEST(BC1, BlockLayout)
+{
+	cv::Mat blocks;
+	BC1::Encode(make_frame(64, 32), blocks);
+	EXPECT_EQ(blocks.type(), CV_8UC1);
+	EXPECT_EQ(blocks.rows, 8);
+	EXPECT_EQ(blocks.cols, 16 * static_cast<int>(BC1::blockBytes));
+}
+
+TEST(BC1, QualityStaysAboveBound)
+{
+	const auto frame = make_frame(256, 144);
+
+	cv::Mat blocks, decoded;
+	BC1::Encode(frame, blocks);
+	BC1::Decode(blocks, 256, 144, decoded);
+	ASSERT_EQ(decoded.size(), frame.size());
+	EXPECT_GT(cv::PSNR(frame, decoded), minPSNR);
+}
+
+TEST(BC1, FlatBlocksAreExact)
+{
+	cv::Mat frame(8, 8, CV_8UC4, cv::Scalar(16, 134, 255, 255));  // every channel exactly on a 5:6:5 level
+
+	cv::Mat blocks, decoded;
+	BC1::Encode(frame, blocks);
+	BC1::Decode(blocks, 8, 8, decoded);
+	EXPECT_EQ(cv::norm(frame, decoded, cv::NORM_INF), 0.0);
+}
+
+TEST(BC1, PartialEdgeBlocks)
+{
+	const auto frame = make_frame(37, 19);
+
+	cv::Mat blocks, decoded;
+	BC1::Encode(frame, blocks);
+	EXPECT_EQ(blocks.rows, 5);
+	EXPECT_EQ(blocks.cols, 10 * static_cast<int>(BC1::blockBytes));
+	BC1::Decode(blocks, 37, 19, decoded);
+	ASSERT_EQ(decoded.size(), frame.size());
+	EXPECT_GT(cv::PSNR(frame, decoded), minPSNR);
+}
+
+// a baked video publishes blocks, a poster saved from one has to be decoded first
+TEST(BC1, BakedFrameMakesAPoster)
+{
+	const auto frame = make_frame(100, 60);
+	cv::Mat    blocks;
+	BC1::Encode(frame, blocks);
+
+	cv::Mat poster;
+	ASSERT_TRUE(FrameFormat::ToBGRA8(blocks, 100, 60, poster));
+	ASSERT_EQ(poster.type(), CV_8UC4);
+	ASSERT_EQ(poster.cols, 100);
+	ASSERT_EQ(poster.rows, 60);
+
+	const auto encoded = QOI::Encode(poster.data, static_cast<std::uint32_t>(poster.cols), static_cast<std::uint32_t>(poster.rows), poster.step);
+	QOI::Image image;
+	ASSERT_TRUE(QOI::Decode(encoded, image));
+	ASSERT_EQ(image.width, 100u);
+	ASSERT_EQ(image.height, 60u);
+
+	const cv::Mat decoded(60, 100, CV_8UC4, image.pixels.data());
+	EXPECT_GT(cv::PSNR(frame, decoded), minPSNR);
+}
+
+TEST(BC1, BlocksOfAnotherSizeAreNoFrame)
+{
+	cv::Mat blocks;
+	BC1::Encode(make_frame(64, 32), blocks);
+
+	cv::Mat poster;
+	EXPECT_FALSE(FrameFormat::ToBGRA8(blocks, 128, 32, poster));
+	EXPECT_FALSE(FrameFormat::ToBGRA8(blocks, 64, 64, poster));
+}
@@ -0,0 +1,101 @@
+#include "Blend.h"
+
+namespace
+{
+	// the rounding the scalar tail of LerpRow uses, written out per byte
+	std::uint8_t reference(std::uint8_t a_from, std::uint8_t a_to, std::uint32_t a_weight)
+	{
+		return static_cast<std::uint8_t>((a_from * (Blend::fullWeight - a_weight) + a_to * a_weight + 128) >> 8);
+	}
+
+	std::vector<std::uint8_t> make_row(std::size_t a_bytes, std::uint32_t a_seed)
+	{
+		std::vector<std::uint8_t> row(a_bytes);
+		std::mt19937              rng(a_seed);
+		for (auto& value : row) {
+			value = static_cast<std::uint8_t>(rng());
+		}
+		return row;
+	}
+}
+
+TEST(Blend, LerpRowMatchesReference)
+{
+	// lengths around the 16 byte step, so the scalar tail is covered too
+	for (const std::uint32_t weight : { 0u, 1u, 64u, 128u, 200u, 255u, 256u }) {
+		for (std::size_t bytes = 0; bytes <= 53; ++bytes) {
+			const auto                from = make_row(bytes, static_cast<std::uint32_t>(bytes));
+			const auto                to = make_row(bytes, static_cast<std::uint32_t>(bytes) + 1000);
+			std::vector<std::uint8_t> out(bytes);
+			Blend::LerpRow(from.data(), to.data(), out.data(), bytes, weight);
+			for (std::size_t i = 0; i < bytes; ++i) {
+				ASSERT_EQ(out[i], reference(from[i], to[i], weight)) << "weight " << weight << ", bytes " << bytes << ", i " << i;
+			}
+		}
+	}
+}
+
+TEST(Blend, EndWeightsAreExact)
+{
+	const auto                from = make_row(67, 1);
+	const auto                to = make_row(67, 2);
+	std::vector<std::uint8_t> out(67);
+
+	Blend::LerpRow(from.data(), to.data(), out.data(), out.size(), 0);
+	EXPECT_EQ(out, from);
+	Blend::LerpRow(from.data(), to.data(), out.data(), out.size(), Blend::fullWeight);
+	EXPECT_EQ(out, to);
+}
+
+TEST(Blend, ExtremesDontOverflow)
+{
+	// 255 on both sides is the largest sum a lane holds, it has to come back as 255 at every weight
+	const std::vector<std::uint8_t> white(32, 255);
+	const std::vector<std::uint8_t> black(32, 0);
+	std::vector<std::uint8_t>       out(32);
+	for (std::uint32_t weight = 0; weight <= Blend::fullWeight; ++weight) {
+		Blend::LerpRow(white.data(), white.data(), out.data(), out.size(), weight);
+		ASSERT_EQ(out, white) << weight;
+		Blend::LerpRow(black.data(), white.data(), out.data(), out.size(), weight);
+		ASSERT_EQ(out[0], reference(0, 255, weight)) << weight;
+	}
+}
+
+TEST(Blend, UnalignedRows)
+{
+	// rows start wherever the mapped texture pitch puts them
+	const auto                from = make_row(80, 3);
+	const auto                to = make_row(80, 4);
+	std::vector<std::uint8_t> out(80);
+	Blend::LerpRow(from.data() + 3, to.data() + 5, out.data() + 7, 64, 100);
+	for (std::size_t i = 0; i < 64; ++i) {
+		ASSERT_EQ(out[i + 7], reference(from[i + 3], to[i + 5], 100)) << i;
+	}
+}
+
+TEST(Blend, WeightFadesInOverTheInterval)
+{
+	constexpr double interval = 1.0 / 30.0;
+
+	EXPECT_EQ(Blend::GetWeight(0.0, interval), 0u);
+	EXPECT_EQ(Blend::GetWeight(-0.001, interval), 0u);
+	EXPECT_EQ(Blend::GetWeight(interval / 2.0, interval), Blend::fullWeight / 2);
+	EXPECT_EQ(Blend::GetWeight(interval / 4.0, interval), Blend::fullWeight / 4);
+	EXPECT_EQ(Blend::GetWeight(interval, interval), Blend::fullWeight);
+	EXPECT_EQ(Blend::GetWeight(interval * 3.0, interval), Blend::fullWeight);
+
+	std::uint32_t last = 0;
+	for (int step = 0; step <= 100; ++step) {
+		const auto weight = Blend::GetWeight(interval * step / 100.0, interval);
+		ASSERT_GE(weight, last) << step;
+		ASSERT_LE(weight, Blend::fullWeight) << step;
+		last = weight;
+	}
+}
+
+TEST(Blend, NoIntervalShowsTheNewFrame)
+{
+	// a frame without a known duration isn't faded into
+	EXPECT_EQ(Blend::GetWeight(0.0, 0.0), Blend::fullWeight);
+	EXPECT_EQ(Blend::GetWeight(0.5, -1.0), Blend::fullWeight);
+}
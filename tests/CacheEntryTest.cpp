@@ -0,0 +1,64 @@
+#include "CacheEntry.h"
+
+#include "TempFile.h"
+
+namespace
+{
+	constexpr std::uint32_t magic{ 0x54534554 };  // TEST
+	constexpr Cache::Stamp  stamp{ 123456, 987654321 };
+
+	const std::vector<std::uint8_t> payload{ 1, 2, 3, 4, 5, 250, 0, 7 };
+}
+
+TEST(CacheEntry, RoundTrips)
+{
+	const TempFile file("mmv_cache_test.bin");
+	ASSERT_TRUE(Cache::Write(file.path, magic, stamp, payload));
+
+	const auto read = Cache::Read(file.path, magic, stamp);
+	ASSERT_TRUE(read);
+	EXPECT_EQ(*read, payload);
+
+	auto tempPath = file.path;
+	tempPath += ".tmp";
+	EXPECT_FALSE(std::filesystem::exists(tempPath));
+}
+
+TEST(CacheEntry, EmptyPayloadIsAnEntry)
+{
+	const TempFile file("mmv_cache_test.bin");
+	ASSERT_TRUE(Cache::Write(file.path, magic, stamp, {}));
+
+	const auto read = Cache::Read(file.path, magic, stamp);
+	ASSERT_TRUE(read);
+	EXPECT_TRUE(read->empty());
+}
+
+TEST(CacheEntry, ChangedSourceDropsTheEntry)
+{
+	const TempFile file("mmv_cache_test.bin");
+
+	// a re-encode changes the size, a copy over the original changes the write time
+	for (const auto& changed : { Cache::Stamp{ stamp.fileSize + 1, stamp.writeTime }, Cache::Stamp{ stamp.fileSize, stamp.writeTime + 1 } }) {
+		ASSERT_TRUE(Cache::Write(file.path, magic, stamp, payload));
+		EXPECT_FALSE(Cache::Read(file.path, magic, changed));
+		EXPECT_FALSE(std::filesystem::exists(file.path));
+	}
+}
+
+TEST(CacheEntry, OtherKindOfEntryIsDropped)
+{
+	const TempFile file("mmv_cache_test.bin");
+	ASSERT_TRUE(Cache::Write(file.path, magic, stamp, payload));
+	EXPECT_FALSE(Cache::Read(file.path, magic + 1, stamp));
+	EXPECT_FALSE(std::filesystem::exists(file.path));
+}
+
+TEST(CacheEntry, MissingOrShortFileIsAMiss)
+{
+	const TempFile file("mmv_cache_test.bin");
+	EXPECT_FALSE(Cache::Read(file.path, magic, stamp));
+
+	std::ofstream(file.path, std::ios::binary) << "abc";
+	EXPECT_FALSE(Cache::Read(file.path, magic, stamp));
+}
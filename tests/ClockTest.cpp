@@ -0,0 +1,61 @@
+#include "Clock.h"
+
+TEST(VirtualClock, StartsAtZero)
+{
+	const VirtualClock clock;
+	EXPECT_DOUBLE_EQ(clock.now().time_since_epoch().count(), 0.0);
+}
+
+TEST(VirtualClock, MovesOnlyWhenSleeping)
+{
+	VirtualClock clock;
+	const auto   start = clock.now();
+	std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	EXPECT_EQ(clock.now(), start);
+
+	clock.sleep_for(Clock::duration(1.5));
+	clock.sleep_for(std::chrono::milliseconds(250));
+	EXPECT_DOUBLE_EQ(Clock::duration(clock.now() - start).count(), 1.75);
+}
+
+TEST(VirtualClock, SleepingReturnsAtOnce)
+{
+	VirtualClock clock;
+	const auto   realStart = std::chrono::steady_clock::now();
+	clock.sleep_for(std::chrono::hours(1));
+	EXPECT_LT(std::chrono::steady_clock::now() - realStart, std::chrono::seconds(1));
+	EXPECT_DOUBLE_EQ(clock.now().time_since_epoch().count(), 3600.0);
+}
+
+TEST(VirtualClock, NonPositiveSleepsAreIgnored)
+{
+	VirtualClock clock;
+	clock.sleep_for(Clock::duration(-2.0));
+	clock.sleep_for(Clock::duration(0.0));
+	EXPECT_DOUBLE_EQ(clock.now().time_since_epoch().count(), 0.0);
+}
+
+// the video and audio threads can both sleep on it
+TEST(VirtualClock, ConcurrentSleepsAllCount)
+{
+	VirtualClock clock;
+	{
+		std::vector<std::jthread> threads;
+		for (int i = 0; i < 4; ++i) {
+			threads.emplace_back([&clock] {
+				for (int j = 0; j < 1000; ++j) {
+					clock.sleep_for(Clock::duration(0.25));
+				}
+			});
+		}
+	}
+	EXPECT_DOUBLE_EQ(clock.now().time_since_epoch().count(), 1000.0);
+}
+
+TEST(SteadyClock, FollowsRealTime)
+{
+	SteadyClock clock;
+	const auto  start = clock.now();
+	clock.sleep_for(std::chrono::milliseconds(10));
+	EXPECT_GE(Clock::duration(clock.now() - start).count(), 0.009);
+}
@@ -0,0 +1,119 @@
+#include "DecodeWatchdog.h"
+
+namespace
+{
+	using duration = DecodeWatchdog::duration;
+	using time_point = DecodeWatchdog::time_point;
+
+	constexpr duration frameBudget{ 0.01 };
+
+	// a read counts as a miss past 20 ms, three net misses fall back, a read over 1 s is a hang
+	void configure(DecodeWatchdog& a_watchdog, bool a_enabled = true)
+	{
+		CSimpleIniA ini;
+		ini.Set("Watchdog", "bEnable", a_enabled ? "true" : "false");
+		ini.Set("Watchdog", "fMissFactor", "2");
+		ini.Set("Watchdog", "iMaxMisses", "3");
+		ini.Set("Watchdog", "fHangSeconds", "1");
+
+		a_watchdog.LoadSettings(ini);
+		a_watchdog.Start(frameBudget);
+	}
+
+	// one read taking a_latency seconds, ending at the returned time
+	bool read(DecodeWatchdog& a_watchdog, time_point& a_now, double a_latency)
+	{
+		a_watchdog.BeginRead(a_now);
+		a_now += duration(a_latency);
+		return a_watchdog.EndRead(a_now);
+	}
+
+	time_point start_time()
+	{
+		return time_point(duration(100.0));
+	}
+}
+
+TEST(DecodeWatchdog, FirstReadIsNotAMiss)
+{
+	DecodeWatchdog watchdog;
+	configure(watchdog);
+	auto now = start_time();
+	EXPECT_FALSE(read(watchdog, now, 0.5));
+	EXPECT_EQ(watchdog.GetMisses(), 0u);
+}
+
+TEST(DecodeWatchdog, SustainedSlowReadsFallBack)
+{
+	DecodeWatchdog watchdog;
+	configure(watchdog);
+	auto now = start_time();
+	read(watchdog, now, 0.001);
+	EXPECT_FALSE(read(watchdog, now, 0.05));
+	EXPECT_FALSE(read(watchdog, now, 0.05));
+	EXPECT_TRUE(read(watchdog, now, 0.05));
+}
+
+TEST(DecodeWatchdog, OnTimeReadsPayMissesBack)
+{
+	DecodeWatchdog watchdog;
+	configure(watchdog);
+	auto now = start_time();
+	read(watchdog, now, 0.001);
+	for (std::uint32_t i = 0; i < 10; ++i) {
+		EXPECT_FALSE(read(watchdog, now, i % 2 == 0 ? 0.05 : 0.001));
+	}
+	EXPECT_LE(watchdog.GetMisses(), 1u);
+}
+
+TEST(DecodeWatchdog, StartForgetsMisses)
+{
+	DecodeWatchdog watchdog;
+	configure(watchdog);
+	auto now = start_time();
+	read(watchdog, now, 0.001);
+	read(watchdog, now, 0.05);
+	read(watchdog, now, 0.05);
+	ASSERT_EQ(watchdog.GetMisses(), 2u);
+
+	watchdog.Start(frameBudget);
+	EXPECT_EQ(watchdog.GetMisses(), 0u);
+	EXPECT_FALSE(read(watchdog, now, 0.05));  // warming up again
+}
+
+TEST(DecodeWatchdog, FirstReadGetsTheSetupAllowance)
+{
+	DecodeWatchdog watchdog;
+	configure(watchdog);
+	const auto now = start_time();
+	watchdog.BeginRead(now);
+	EXPECT_FALSE(watchdog.IsHung(now + duration(5.0)));
+	EXPECT_TRUE(watchdog.IsHung(now + duration(11.0)));
+}
+
+TEST(DecodeWatchdog, LaterReadsHangAfterTheThreshold)
+{
+	DecodeWatchdog watchdog;
+	configure(watchdog);
+	auto now = start_time();
+	read(watchdog, now, 0.001);
+
+	watchdog.BeginRead(now);
+	EXPECT_FALSE(watchdog.IsHung(now + duration(0.5)));
+	EXPECT_TRUE(watchdog.IsHung(now + duration(1.5)));
+
+	watchdog.EndRead(now + duration(1.5));
+	EXPECT_FALSE(watchdog.IsHung(now + duration(5.0)));
+}
+
+TEST(DecodeWatchdog, DisabledNeverReports)
+{
+	DecodeWatchdog watchdog;
+	configure(watchdog, false);
+	auto now = start_time();
+	for (std::uint32_t i = 0; i < 10; ++i) {
+		EXPECT_FALSE(read(watchdog, now, 0.5));
+	}
+	watchdog.BeginRead(now);
+	EXPECT_FALSE(watchdog.IsHung(now + duration(60.0)));
+}
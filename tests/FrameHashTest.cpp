@@ -0,0 +1,86 @@
+#include "FrameHash.h"
+
+namespace
+{
+	// noise, so no two rows or frames agree by accident
+	cv::Mat make_frame(int a_width, int a_height, int a_type, std::uint32_t a_seed)
+	{
+		cv::Mat      frame(a_height, a_width, a_type);
+		std::mt19937 rng(a_seed);
+		for (int y = 0; y < a_height; ++y) {
+			auto* row = frame.ptr<std::uint8_t>(y);
+			for (std::size_t x = 0; x < a_width * frame.elemSize(); ++x) {
+				row[x] = static_cast<std::uint8_t>(rng());
+			}
+		}
+		return frame;
+	}
+}
+
+TEST(FrameHash, IdenticalFramesMatch)
+{
+	const auto frame = make_frame(1920, 1080, CV_8UC3, 1);
+	const auto copy = frame.clone();
+
+	EXPECT_EQ(FrameHash::Fingerprint(frame), FrameHash::Fingerprint(copy));
+	EXPECT_TRUE(FrameHash::Equal(frame, copy));
+}
+
+TEST(FrameHash, PaddedRowsAreIgnored)
+{
+	// a decoder's buffer with a wider stride holds the same picture
+	const auto                frame = make_frame(101, 37, CV_8UC4, 2);
+	const std::size_t         step = 101 * 4 + 60;
+	std::vector<std::uint8_t> buffer(step * 37, 0xCD);
+	for (int y = 0; y < 37; ++y) {
+		std::memcpy(buffer.data() + y * step, frame.ptr(y), 101 * 4);
+	}
+	const cv::Mat padded(37, 101, CV_8UC4, buffer.data(), step);
+
+	EXPECT_EQ(FrameHash::Fingerprint(frame), FrameHash::Fingerprint(padded));
+	EXPECT_TRUE(FrameHash::Equal(frame, padded));
+}
+
+TEST(FrameHash, ChangeInASampledRowChangesTheFingerprint)
+{
+	// odd widths leave bytes past the last full 32 byte step, those count too
+	const auto frame = make_frame(333, 64, CV_8UC3, 3);
+
+	// 64 rows, 32 sampled: every odd row
+	for (const auto offset : { std::size_t(0), std::size_t(500), std::size_t(333 * 3 - 1) }) {
+		auto changed = frame.clone();
+		changed.ptr(33)[offset] ^= 1;
+		EXPECT_NE(FrameHash::Fingerprint(frame), FrameHash::Fingerprint(changed)) << offset;
+		EXPECT_FALSE(FrameHash::Equal(frame, changed)) << offset;
+	}
+}
+
+TEST(FrameHash, ChangeBetweenSampledRowsIsCaughtByEqual)
+{
+	const auto frame = make_frame(320, 64, CV_8UC4, 4);
+	auto       changed = frame.clone();
+	changed.ptr(32)[100] ^= 0x80;
+
+	// the fingerprint only rules frames out, a match still has to be confirmed
+	EXPECT_EQ(FrameHash::Fingerprint(frame), FrameHash::Fingerprint(changed));
+	EXPECT_FALSE(FrameHash::Equal(frame, changed));
+}
+
+TEST(FrameHash, ShapeIsPartOfTheFingerprint)
+{
+	const cv::Mat wide(32, 64, CV_8UC4, cv::Scalar::all(0));
+	const cv::Mat tall(64, 32, CV_8UC4, cv::Scalar::all(0));
+	const cv::Mat threeChannel(32, 64, CV_8UC3, cv::Scalar::all(0));
+
+	EXPECT_NE(FrameHash::Fingerprint(wide), FrameHash::Fingerprint(tall));
+	EXPECT_NE(FrameHash::Fingerprint(wide), FrameHash::Fingerprint(threeChannel));
+	EXPECT_FALSE(FrameHash::Equal(wide, tall));
+	EXPECT_FALSE(FrameHash::Equal(wide, threeChannel));
+}
+
+TEST(FrameHash, EmptyFrameNeverMatches)
+{
+	const cv::Mat empty;
+	EXPECT_EQ(FrameHash::Fingerprint(empty), 0u);
+	EXPECT_FALSE(FrameHash::Equal(empty, empty));
+}
@@ -0,0 +1,134 @@
+#include "FrameTimeline.h"
+
+namespace
+{
+	using duration = FrameTimeline::duration;
+
+	constexpr duration frameDuration{ 1.0 / 30.0 };
+
+	// what the backend reports for a generated variable frame rate clip: a_counts frames at each of a_fps, back to back
+	std::vector<duration> generate(std::initializer_list<std::pair<std::uint32_t, double>> a_segments)
+	{
+		std::vector<duration> timestamps;
+		duration              position{ 0.0 };
+		for (const auto& [count, fps] : a_segments) {
+			for (std::uint32_t i = 0; i < count; i++) {
+				timestamps.push_back(position);
+				position += duration(1.0 / fps);
+			}
+		}
+		return timestamps;
+	}
+
+	// runs every frame through the timeline like the video loop, returns when each presented frame is due
+	std::vector<duration> schedule(FrameTimeline& a_timeline, const std::vector<duration>& a_reported, std::vector<FrameTimeline::Verdict>* a_verdicts = nullptr)
+	{
+		std::vector<duration> due;
+		for (const auto& reported : a_reported) {
+			const auto timestamp = a_timeline.GetTimestamp(reported);
+			const auto verdict = a_timeline.Add(timestamp);
+			if (a_verdicts) {
+				a_verdicts->push_back(verdict);
+			}
+			if (verdict == FrameTimeline::Verdict::kPresent || verdict == FrameTimeline::Verdict::kFirstIrregular) {
+				due.push_back(timestamp);
+			}
+		}
+		return due;
+	}
+}
+
+TEST(FrameTimeline, ConstantRateIsNotVariable)
+{
+	const auto reported = generate({ { 90, 30.0 } });
+
+	FrameTimeline timeline(frameDuration, true, duration(0.0));
+	EXPECT_EQ(schedule(timeline, reported), reported);
+	EXPECT_FALSE(timeline.IsVariable());
+	EXPECT_NEAR(timeline.GetContentFPS(), 30.0f, 0.01f);
+}
+
+TEST(FrameTimeline, VariableRateFollowsTimestamps)
+{
+	// nominally 30 FPS, but the middle second was recorded at 60
+	const auto reported = generate({ { 30, 30.0 }, { 60, 60.0 }, { 30, 30.0 } });
+
+	FrameTimeline                       timeline(frameDuration, true, duration(0.0));
+	std::vector<FrameTimeline::Verdict> verdicts;
+	EXPECT_EQ(schedule(timeline, reported, &verdicts), reported);
+
+	// reported once, on the first frame that came after a 60 FPS interval
+	EXPECT_EQ(std::ranges::count(verdicts, FrameTimeline::Verdict::kFirstIrregular), 1);
+	EXPECT_EQ(verdicts[31], FrameTimeline::Verdict::kFirstIrregular);
+	EXPECT_TRUE(timeline.IsVariable());
+
+	// 119 intervals over 3 seconds, less the last 30 FPS frame's own duration
+	EXPECT_NEAR(timeline.GetContentFPS(), 119.0 / (3.0 - 1.0 / 30.0), 0.01);
+}
+
+TEST(FrameTimeline, GapsAreHeld)
+{
+	// a screen capture that recorded nothing for a second
+	auto reported = generate({ { 10, 30.0 } });
+	reported.push_back(reported.back() + duration(1.0));
+
+	FrameTimeline timeline(frameDuration, true, duration(0.0));
+	const auto    due = schedule(timeline, reported);
+	ASSERT_EQ(due.size(), reported.size());
+	EXPECT_DOUBLE_EQ((due[10] - due[9]).count(), 1.0);
+	EXPECT_TRUE(timeline.IsVariable());
+}
+
+TEST(FrameTimeline, DuplicatesAreDropped)
+{
+	auto reported = generate({ { 10, 30.0 } });
+	reported.insert(reported.begin() + 5, reported[4]);  // repeated
+	reported.insert(reported.begin() + 8, reported[2]);  // backwards
+
+	FrameTimeline timeline(frameDuration, true, duration(0.0));
+	EXPECT_EQ(schedule(timeline, reported), generate({ { 10, 30.0 } }));
+	EXPECT_FALSE(timeline.IsVariable());
+	EXPECT_EQ(timeline.TakeDuplicates(), 2u);
+	EXPECT_EQ(timeline.TakeDuplicates(), 0u);
+}
+
+TEST(FrameTimeline, RepeatedTimestampsFallBackToNominalSpacing)
+{
+	// a backend that reports nothing useful
+	const std::vector<duration> reported(20, duration(0.0));
+
+	FrameTimeline                       timeline(frameDuration, true, duration(0.0));
+	std::vector<FrameTimeline::Verdict> verdicts;
+	const auto                          due = schedule(timeline, reported, &verdicts);
+
+	ASSERT_EQ(std::ranges::find(verdicts, FrameTimeline::Verdict::kTimestampsLost) - verdicts.begin(), 8);
+	EXPECT_FALSE(timeline.UsesTimestamps());
+
+	// the first frame, then every one after the backend was given up on
+	ASSERT_EQ(due.size(), 1u + 11u);
+	for (std::size_t i = 1; i < due.size(); i++) {
+		EXPECT_NEAR((due[i] - due[i - 1]).count(), frameDuration.count(), 1e-9);
+	}
+}
+
+TEST(FrameTimeline, UnreportedFramesUseNominalSpacing)
+{
+	// baked and sequence frames have no timestamps of their own
+	FrameTimeline timeline(frameDuration, false, duration(2.0));
+	EXPECT_EQ(timeline.GetTimestamp(duration(5.0)), duration(2.0));
+	timeline.Add(timeline.GetTimestamp(std::nullopt));
+	EXPECT_DOUBLE_EQ(timeline.GetTimestamp(duration(5.0)).count(), 2.0 + frameDuration.count());
+}
+
+TEST(FrameTimeline, RestartAnchorsTheNextFrame)
+{
+	FrameTimeline timeline(frameDuration, true, duration(0.0));
+	schedule(timeline, generate({ { 30, 30.0 } }));
+
+	// a loop restart or a seek back, the earlier timestamp isn't a duplicate
+	timeline.Restart(duration(0.5));
+	EXPECT_EQ(timeline.GetTimestamp(std::nullopt), duration(0.5));
+	EXPECT_EQ(timeline.Add(duration(0.5)), FrameTimeline::Verdict::kPresent);
+	EXPECT_EQ(timeline.TakeDuplicates(), 0u);
+	EXPECT_EQ(timeline.GetContentFPS(), 0.0f);
+}
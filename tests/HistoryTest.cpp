@@ -0,0 +1,170 @@
+#include "History.h"
+
+#include "TempFile.h"
+
+namespace
+{
+	History::Session make_session(float a_achievedFPS, float a_decodeTime = 5.0f, std::uint32_t a_droppedFrames = 0, float a_firstPixelTime = 0.0f)
+	{
+		return { 60.0f, a_achievedFPS, a_decodeTime, 600, a_droppedFrames, a_firstPixelTime };
+	}
+
+	History::Record make_record(const History::Session& a_session, std::uint32_t a_plays = 2)
+	{
+		History::Record record;
+		for (std::uint32_t i = 0; i < a_plays; ++i) {
+			record.Add(a_session);
+		}
+		return record;
+	}
+}
+
+TEST(History, FirstPlaySetsTheRecord)
+{
+	History::Record record;
+	record.Add(make_session(50.0f, 8.0f, 60, 400.0f));
+	EXPECT_EQ(record.plays, 1u);
+	EXPECT_FLOAT_EQ(record.achievedFPS, 50.0f);
+	EXPECT_FLOAT_EQ(record.decodeTime, 8.0f);
+	EXPECT_FLOAT_EQ(record.dropRate, 60.0f / 660.0f);
+	EXPECT_FLOAT_EQ(record.firstPixelTime, 400.0f);
+}
+
+TEST(History, LaterPlaysMoveTheRecordPartway)
+{
+	History::Record record;
+	record.Add(make_session(30.0f));
+	record.Add(make_session(60.0f));
+	EXPECT_GT(record.achievedFPS, 30.0f);
+	EXPECT_LT(record.achievedFPS, 45.0f);
+}
+
+TEST(History, LoopsKeepTheFirstPixelTime)
+{
+	History::Record record;
+	record.Add(make_session(60.0f, 5.0f, 0, 400.0f));
+	record.Add(make_session(60.0f));
+	EXPECT_FLOAT_EQ(record.firstPixelTime, 400.0f);
+}
+
+TEST(History, PlayingClearsSkips)
+{
+	History::Record record;
+	record.skips = 4;
+	record.Add(make_session(60.0f));
+	EXPECT_EQ(record.skips, 0u);
+}
+
+TEST(History, TooFewPlaysAlwaysPlay)
+{
+	const History::Policy policy;
+	EXPECT_EQ(History::Assess({}, policy), History::Verdict::kPlay);
+	EXPECT_EQ(History::Assess(make_record(make_session(10.0f), 1), policy), History::Verdict::kPlay);
+}
+
+TEST(History, KeepingUpPlays)
+{
+	EXPECT_EQ(History::Assess(make_record(make_session(59.0f)), {}), History::Verdict::kPlay);
+}
+
+TEST(History, FallingBehindDownscales)
+{
+	const History::Policy policy;
+	EXPECT_EQ(History::Assess(make_record(make_session(50.0f)), policy), History::Verdict::kDownscale);
+	EXPECT_EQ(History::Assess(make_record(make_session(60.0f, 5.0f, 60)), policy), History::Verdict::kDownscale);
+	// decoding alone takes longer than the 16.7 ms a frame has
+	EXPECT_EQ(History::Assess(make_record(make_session(60.0f, 20.0f)), policy), History::Verdict::kDownscale);
+}
+
+TEST(History, FarBehindSkips)
+{
+	EXPECT_EQ(History::Assess(make_record(make_session(30.0f)), {}), History::Verdict::kSkip);
+}
+
+TEST(History, SlowToShowSkipsOnlyWhenAsked)
+{
+	const auto record = make_record(make_session(60.0f, 5.0f, 0, 5000.0f));
+	History::Policy policy;
+	EXPECT_EQ(History::Assess(record, policy), History::Verdict::kPlay);
+	policy.maxFirstPixelTime = 2000.0f;
+	EXPECT_EQ(History::Assess(record, policy), History::Verdict::kSkip);
+}
+
+TEST(History, PassedOverVideosGetAnotherChance)
+{
+	auto            record = make_record(make_session(30.0f));
+	History::Policy policy;
+	record.skips = policy.retryAfter;
+	EXPECT_EQ(History::Assess(record, policy), History::Verdict::kPlay);
+
+	policy.retryAfter = 0;
+	EXPECT_EQ(History::Assess(record, policy), History::Verdict::kSkip);
+}
+
+TEST(History, Percentile)
+{
+	std::vector<float> samples;
+	for (std::uint32_t i = 100; i > 0; --i) {
+		samples.push_back(static_cast<float>(i));
+	}
+	EXPECT_FLOAT_EQ(History::Percentile(samples, 0.95f), 96.0f);
+
+	std::vector<float> empty;
+	EXPECT_FLOAT_EQ(History::Percentile(empty, 0.95f), 0.0f);
+}
+
+TEST(History, ShortSessionsAreIgnored)
+{
+	History::Store store;
+	EXPECT_FALSE(store.Add("intro.mp4", { 60.0f, 60.0f, 5.0f, 60, 0, 0.0f }));
+	EXPECT_FALSE(store.Find("intro.mp4"));
+}
+
+TEST(History, StoreRoundTrips)
+{
+	const TempFile file("mmv_history_test.tsv");
+
+	History::Store store;
+	EXPECT_FALSE(store.Load(file.path));
+	ASSERT_TRUE(store.Add("Data\\MainMenuVideo\\Intro.mp4", make_session(50.0f, 8.0f, 6, 812.5f)));
+	ASSERT_TRUE(store.Add("Data\\Foo.bsa\\mainmenuvideo\\with space.mp4", make_session(60.0f)));
+	store.Skip("data\\mainmenuvideo\\INTRO.mp4");
+	store.Skip("not played.mp4");
+	ASSERT_TRUE(store.Save());
+
+	History::Store loaded;
+	ASSERT_TRUE(loaded.Load(file.path));
+	EXPECT_EQ(loaded.GetRecords().size(), 2u);
+	EXPECT_FALSE(loaded.Find("not played.mp4"));
+
+	const auto record = loaded.Find("DATA\\MAINMENUVIDEO\\intro.mp4");
+	ASSERT_TRUE(record);
+	EXPECT_EQ(record->plays, 1u);
+	EXPECT_EQ(record->skips, 1u);
+	EXPECT_NEAR(record->achievedFPS, 50.0f, 1e-3f);
+	EXPECT_NEAR(record->dropRate, 6.0f / 606.0f, 1e-4f);
+	EXPECT_FLOAT_EQ(record->firstPixelTime, 812.5f);
+}
+
+TEST(History, StoreDropsOtherVersionsAndBadLines)
+{
+	const TempFile file("mmv_history_test.tsv");
+	{
+		std::ofstream out(file.path);
+		out << "# some other file\n1\t0\t60\t60\t5\t0\t0\tintro.mp4\n";
+	}
+	History::Store store;
+	EXPECT_FALSE(store.Load(file.path));
+	EXPECT_TRUE(store.GetRecords().empty());
+
+	{
+		std::ofstream out(file.path);
+		out << "# MainMenuVideo play history v1\n"
+			   "1\tx\t60\t60\t5\t0\t0\tbad.mp4\n"
+			   "1\t0\t60\t60\t5\t0\n"
+			   "2\t0\t60\t60\t5\t0\t0\tgood.mp4\n";
+	}
+	ASSERT_TRUE(store.Load(file.path));
+	EXPECT_EQ(store.GetRecords().size(), 1u);
+	EXPECT_TRUE(store.Find("good.mp4"));
+}
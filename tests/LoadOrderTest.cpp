@@ -0,0 +1,71 @@
+#include "LoadOrder.h"
+
+namespace
+{
+	std::vector<std::string> read_plugins(std::string_view a_text, bool a_activeOnly)
+	{
+		std::istringstream stream{ std::string(a_text) };
+		return LoadOrder::ReadPlugins(stream, a_activeOnly);
+	}
+
+	std::vector<std::string> get_archives(const std::vector<std::string>& a_plugins, const std::vector<std::filesystem::path>& a_archives)
+	{
+		std::vector<std::string> names;
+		for (const auto& archive : LoadOrder::GetArchives(a_plugins, a_archives)) {
+			names.push_back(archive.filename().string());
+		}
+		return names;
+	}
+}
+
+TEST(LoadOrder, PluginsTxtKeepsActivePlugins)
+{
+	const auto plugins = read_plugins("# This file is used by Skyrim to keep track of your downloaded content.\r\n"
+									  "*Unofficial Skyrim Special Edition Patch.esp\r\n"
+									  "Disabled.esp\r\n"
+									  "\r\n"
+									  "*MyMod.esp\r\n"sv,
+		true);
+	EXPECT_EQ(plugins, (std::vector<std::string>{ "Unofficial Skyrim Special Edition Patch.esp", "MyMod.esp" }));
+}
+
+TEST(LoadOrder, CccListsEveryLine)
+{
+	const auto plugins = read_plugins("ccBGSSSE001-Fish.esm\nccQDRSSE001-SurvivalMode.esl\n"sv, false);
+	EXPECT_EQ(plugins, (std::vector<std::string>{ "ccBGSSSE001-Fish.esm", "ccQDRSSE001-SurvivalMode.esl" }));
+}
+
+TEST(LoadOrder, ArchivesFollowPlugins)
+{
+	const std::vector<std::filesystem::path> archives{ "Data/Alpha.bsa", "Data/Zulu.bsa", "Data/Zulu - Textures.bsa", "Data/Skyrim - Textures0.bsa", "Data/Mid.ba2" };
+
+	// alphabetically Zulu would come last and win, in load order it comes first
+	EXPECT_EQ(get_archives({ "Zulu.esp", "Mid.esm", "Alpha.esp" }, archives), (std::vector<std::string>{ "Zulu.bsa", "Zulu - Textures.bsa", "Mid.ba2", "Alpha.bsa" }));
+}
+
+TEST(LoadOrder, ArchivesWithoutALoadedPluginAreSkipped)
+{
+	const std::vector<std::filesystem::path> archives{ "Data/Orphan.bsa", "Data/MyMod.bsa", "Data/MyModded.bsa" };
+	EXPECT_EQ(get_archives({ "MyMod.esp" }, archives), (std::vector<std::string>{ "MyMod.bsa" }));
+	EXPECT_TRUE(get_archives({}, archives).empty());
+}
+
+TEST(LoadOrder, NamesAreCaseInsensitive)
+{
+	const std::vector<std::filesystem::path> archives{ "Data/mymod.BSA", "Data/MYMOD - textures.bsa" };
+	EXPECT_EQ(get_archives({ "MyMod.ESP" }, archives), (std::vector<std::string>{ "mymod.BSA", "MYMOD - textures.bsa" }));
+}
+
+TEST(LoadOrder, LongestPluginNameOwnsAnArchive)
+{
+	// "A - B - Textures.bsa" belongs to A - B.esp, not A.esp, each archive is listed once
+	const std::vector<std::filesystem::path> archives{ "Data/A.bsa", "Data/A - B.bsa", "Data/A - B - Textures.bsa", "Data/A - Textures.bsa" };
+	EXPECT_EQ(get_archives({ "A - B.esp", "A.esm" }, archives), (std::vector<std::string>{ "A - B.bsa", "A - B - Textures.bsa", "A.bsa", "A - Textures.bsa" }));
+}
+
+TEST(LoadOrder, PluginsListedTwiceLoadOnce)
+{
+	// Plugins.txt can list an implicit master again
+	const std::vector<std::filesystem::path> archives{ "Data/Update.bsa", "Data/MyMod.bsa" };
+	EXPECT_EQ(get_archives({ "Update.esm", "MyMod.esp", "Update.esm" }, archives), (std::vector<std::string>{ "Update.bsa", "MyMod.bsa" }));
+}
@@ -0,0 +1,103 @@
+#include "Memory.h"
+
+namespace
+{
+	// the tracker is process wide, so everything is measured from where the test found it
+	struct Baseline
+	{
+		Baseline() :
+			total(tracker->GetTotalUsage()),
+			frames(tracker->GetUsage(Memory::Category::kFrames)),
+			cache(tracker->GetUsage(Memory::Category::kCache))
+		{}
+
+		// members
+		Memory::Tracker* tracker{ Memory::Tracker::GetSingleton() };
+		std::int64_t     total;
+		std::int64_t     frames;
+		std::int64_t     cache;
+	};
+
+	void set_budget(std::uint32_t a_megabytes)
+	{
+		CSimpleIniA ini;
+		ini.Set("Memory", "iBudgetMB", std::to_string(a_megabytes));
+		Memory::Tracker::GetSingleton()->LoadSettings(ini);
+	}
+
+	constexpr std::int64_t mb{ 1024 * 1024 };
+}
+
+TEST(Memory, UsageCountsPerCategory)
+{
+	const Baseline before;
+	{
+		Memory::Usage frames(Memory::Category::kFrames);
+		Memory::Usage cache(Memory::Category::kCache);
+		frames.Set(3 * mb);
+		cache.Set(mb);
+
+		EXPECT_EQ(before.tracker->GetUsage(Memory::Category::kFrames) - before.frames, 3 * mb);
+		EXPECT_EQ(before.tracker->GetUsage(Memory::Category::kCache) - before.cache, mb);
+		EXPECT_EQ(before.tracker->GetTotalUsage() - before.total, 4 * mb);
+	}
+	EXPECT_EQ(before.tracker->GetTotalUsage(), before.total);
+}
+
+TEST(Memory, ResizingOnlyCountsTheDifference)
+{
+	const Baseline before;
+
+	Memory::Usage frames(Memory::Category::kFrames);
+	frames.Set(2 * mb);
+	frames.Set(5 * mb);
+	EXPECT_EQ(frames.Get(), 5 * mb);
+	EXPECT_EQ(before.tracker->GetUsage(Memory::Category::kFrames) - before.frames, 5 * mb);
+
+	frames.Set(mb);
+	EXPECT_EQ(before.tracker->GetTotalUsage() - before.total, mb);
+}
+
+// what ResetImpl logs on the way to the loading screen: nothing held, the peak kept for the log
+TEST(Memory, PeakOutlivesTheRelease)
+{
+	const Baseline before;
+	{
+		Memory::Usage frames(Memory::Category::kFrames);
+		frames.Set(before.tracker->GetPeakUsage() - before.total + 64 * mb);
+	}
+	EXPECT_EQ(before.tracker->GetTotalUsage(), before.total);
+	EXPECT_GE(before.tracker->GetPeakUsage(), before.total + 64 * mb);
+}
+
+TEST(Memory, BudgetLimitsOptionalBuffering)
+{
+	const Baseline before;
+	set_budget(static_cast<std::uint32_t>(before.total / mb) + 8);
+
+	Memory::Usage frames(Memory::Category::kFrames);
+	frames.Set(6 * mb);
+	EXPECT_TRUE(before.tracker->CanAllocate(mb));
+	EXPECT_FALSE(before.tracker->CanAllocate(3 * mb));
+
+	set_budget(0);  // unlimited
+	EXPECT_TRUE(before.tracker->CanAllocate(1024 * mb));
+}
+
+TEST(Memory, ConcurrentUsageAddsUp)
+{
+	const Baseline before;
+	{
+		std::vector<std::jthread> threads;
+		for (int i = 0; i < 4; ++i) {
+			threads.emplace_back([] {
+				for (int j = 0; j < 1000; ++j) {
+					Memory::Usage usage(Memory::Category::kFrames);
+					usage.Set(mb);
+				}
+			});
+		}
+	}
+	EXPECT_EQ(before.tracker->GetTotalUsage(), before.total);
+	EXPECT_EQ(before.tracker->GetUsage(Memory::Category::kFrames), before.frames);
+}
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <condition_variable>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <random>
+#include <span>
+#include <sstream>
+#include <stop_token>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <gtest/gtest.h>
+
+#ifdef MMV_TESTS_OPENCV
+#	include <opencv2/core.hpp>
+#	include <opencv2/imgproc.hpp>
+#endif
+
+using namespace std::literals;
+
+// The plugin reads its settings through SimpleIni and ClibUtil and gets its singletons from CommonLib, which only come
+// with the game build. Only the pieces the tested classes touch stand in for them here: values the tests set, handed
+// over by LoadSettings as the real ini would.
+class CSimpleIniA
+{
+public:
+	void Set(const std::string& a_section, const std::string& a_key, const std::string& a_value)
+	{
+		values[{ a_section, a_key }] = a_value;
+	}
+
+	const std::string* Find(const std::string& a_section, const std::string& a_key) const
+	{
+		const auto it = values.find({ a_section, a_key });
+		return it != values.end() ? &it->second : nullptr;
+	}
+
+private:
+	// members
+	std::map<std::pair<std::string, std::string>, std::string> values;
+};
+
+namespace REX
+{
+	template <class T>
+	class Singleton
+	{
+	public:
+		static T* GetSingleton()
+		{
+			static T singleton;
+			return &singleton;
+		}
+	};
+}
+
+// Visibility::GameWindow is declared next to the Source interface the tests fake, only its declaration names this
+using HWND = void*;
+
+// the audio cache stores the renderer's format as-is, laid out like mmreg.h's
+#pragma pack(push, 1)
+struct WAVEFORMATEX
+{
+	std::uint16_t wFormatTag;
+	std::uint16_t nChannels;
+	std::uint32_t nSamplesPerSec;
+	std::uint32_t nAvgBytesPerSec;
+	std::uint16_t nBlockAlign;
+	std::uint16_t wBitsPerSample;
+	std::uint16_t cbSize;
+};
+#pragma pack(pop)
+
+// what the tested classes log goes nowhere, the tests check what they return instead
+namespace logger
+{
+	template <class... Args>
+	void info(Args&&...)
+	{}
+
+	template <class... Args>
+	void warn(Args&&...)
+	{}
+}
+
+namespace ini
+{
+	// leaves a_value as it is when the key isn't set, like a missing key in a real ini
+	template <class T>
+	T get_value(CSimpleIniA& a_ini, T& a_value, const char* a_section, const char* a_key, const char*)
+	{
+		const auto value = a_ini.Find(a_section, a_key);
+		if (!value) {
+			return a_value;
+		}
+		if constexpr (std::is_same_v<T, bool>) {
+			a_value = *value == "true" || *value == "1";
+		} else if constexpr (std::is_enum_v<T>) {
+			std::underlying_type_t<T> number{};
+			std::from_chars(value->data(), value->data() + value->size(), number);
+			a_value = static_cast<T>(number);
+		} else {
+			std::from_chars(value->data(), value->data() + value->size(), a_value);
+		}
+		return a_value;
+	}
+}
+
+namespace clib_util::string
+{
+	inline std::string tolower(std::string a_string)
+	{
+		std::ranges::transform(a_string, a_string.begin(), [](char a_char) { return static_cast<char>(std::tolower(static_cast<unsigned char>(a_char))); });
+		return a_string;
+	}
+}
@@ -0,0 +1,78 @@
+#include "QOI.h"
+
+namespace
+{
+	// BGRA rows a_stride bytes apart, the padding filled with junk the encoder mustn't pick up
+	std::vector<std::uint8_t> make_image(std::uint32_t a_width, std::uint32_t a_height, std::size_t a_stride, std::uint32_t a_seed)
+	{
+		std::mt19937              rng(a_seed);
+		std::vector<std::uint8_t> image(a_stride * a_height, 0xCD);
+		for (std::uint32_t y = 0; y < a_height; ++y) {
+			auto row = image.data() + y * a_stride;
+			for (std::uint32_t x = 0; x < a_width; ++x) {
+				// runs, small differences, repeats and noise, so every chunk type shows up
+				const auto noise = static_cast<std::uint8_t>(rng());
+				const auto value = x < a_width / 4 ? std::uint8_t(0x40) : x < a_width / 2 ? static_cast<std::uint8_t>(x + y) : noise;
+				row[x * 4 + 0] = value;
+				row[x * 4 + 1] = static_cast<std::uint8_t>(value ^ (x % 7 == 0 ? 0x80 : 0));
+				row[x * 4 + 2] = static_cast<std::uint8_t>(value + y);
+				row[x * 4 + 3] = x % 11 == 0 ? static_cast<std::uint8_t>(noise | 1) : 0xFF;
+			}
+		}
+		return image;
+	}
+
+	void expect_round_trip(std::uint32_t a_width, std::uint32_t a_height, std::size_t a_stride, std::uint32_t a_seed)
+	{
+		const auto image = make_image(a_width, a_height, a_stride, a_seed);
+		const auto encoded = QOI::Encode(image.data(), a_width, a_height, a_stride);
+
+		QOI::Image decoded;
+		ASSERT_TRUE(QOI::Decode(encoded, decoded));
+		ASSERT_EQ(decoded.width, a_width);
+		ASSERT_EQ(decoded.height, a_height);
+		ASSERT_EQ(decoded.pixels.size(), std::size_t(a_width) * a_height * 4);
+		for (std::uint32_t y = 0; y < a_height; ++y) {
+			ASSERT_EQ(std::memcmp(decoded.pixels.data() + std::size_t(y) * a_width * 4, image.data() + y * a_stride, a_width * 4), 0) << "row " << y;
+		}
+	}
+}
+
+TEST(QOI, RoundTripsTightRows)
+{
+	expect_round_trip(64, 32, 64 * 4, 1);
+}
+
+TEST(QOI, RoundTripsPaddedRows)
+{
+	expect_round_trip(37, 19, 40 * 4, 2);
+}
+
+TEST(QOI, RoundTripsASinglePixel)
+{
+	expect_round_trip(1, 1, 4, 3);
+}
+
+TEST(QOI, KeepsTheSpecsHeaderAndEnd)
+{
+	const auto image = make_image(8, 4, 8 * 4, 4);
+	const auto encoded = QOI::Encode(image.data(), 8, 4, 8 * 4);
+	ASSERT_GE(encoded.size(), 14u + 8u);
+	EXPECT_EQ(std::memcmp(encoded.data(), "qoif", 4), 0);
+	EXPECT_EQ(encoded[4 + 3], 8);   // width, big endian
+	EXPECT_EQ(encoded[8 + 3], 4);   // height
+	EXPECT_EQ(encoded[12], 4);      // channels
+	constexpr std::array<std::uint8_t, 8> end{ 0, 0, 0, 0, 0, 0, 0, 1 };
+	EXPECT_TRUE(std::equal(end.begin(), end.end(), encoded.end() - 8));
+}
+
+TEST(QOI, RejectsTruncatedData)
+{
+	const auto image = make_image(16, 16, 16 * 4, 5);
+	auto       encoded = QOI::Encode(image.data(), 16, 16, 16 * 4);
+
+	QOI::Image decoded;
+	EXPECT_FALSE(QOI::Decode(std::span(encoded).first(10), decoded));
+	encoded.resize(encoded.size() / 2);
+	EXPECT_FALSE(QOI::Decode(encoded, decoded));
+}
@@ -0,0 +1,129 @@
+#include "QualityController.h"
+
+namespace
+{
+	// 10 ms target, windows of 4 presents, two slow windows to downgrade, two fast ones to upgrade
+	void configure(QualityController& a_controller, bool a_enabled = true)
+	{
+		CSimpleIniA ini;
+		ini.Set("AdaptiveQuality", "bEnable", a_enabled ? "true" : "false");
+		ini.Set("AdaptiveQuality", "fTargetFrameTime", "10");
+		ini.Set("AdaptiveQuality", "iMaxLevel", "2");
+		ini.Set("AdaptiveQuality", "iWindowFrames", "4");
+		ini.Set("AdaptiveQuality", "iDowngradeWindows", "2");
+		ini.Set("AdaptiveQuality", "iUpgradeWindows", "2");
+
+		a_controller.LoadSettings(ini);
+	}
+
+	constexpr float slow{ 20.0f };  // past the downgrade threshold
+	constexpr float fast{ 5.0f };   // under the upgrade threshold
+	constexpr float borderline{ 11.0f };  // between the two
+
+	// feeds a_windows whole windows of a_frameTime, returns the last decision
+	std::optional<QualityController::Decision> feed(QualityController& a_controller, float a_frameTime, std::uint32_t a_windows)
+	{
+		std::optional<QualityController::Decision> decision;
+		for (std::uint32_t i = 0; i < a_windows * 4; ++i) {
+			if (auto result = a_controller.Sample(a_frameTime)) {
+				decision = result;
+			}
+		}
+		return decision;
+	}
+}
+
+TEST(QualityController, DisabledNeverDecides)
+{
+	QualityController controller;
+	configure(controller, false);
+	EXPECT_FALSE(feed(controller, slow, 10));
+	EXPECT_EQ(controller.GetLevel(), 0u);
+}
+
+TEST(QualityController, DowngradesAfterConsecutiveSlowWindows)
+{
+	QualityController controller;
+	configure(controller);
+	EXPECT_FALSE(feed(controller, slow, 1));
+	const auto decision = feed(controller, slow, 1);
+	ASSERT_TRUE(decision);
+	EXPECT_EQ(decision->oldLevel, 0u);
+	EXPECT_EQ(decision->newLevel, 1u);
+	EXPECT_FLOAT_EQ(decision->medianFrameTime, slow);
+}
+
+TEST(QualityController, StopsAtMaxLevel)
+{
+	QualityController controller;
+	configure(controller);
+	feed(controller, slow, 20);
+	EXPECT_EQ(controller.GetLevel(), 2u);
+}
+
+TEST(QualityController, OneSlowPresentDoesNotCountAsASlowWindow)
+{
+	QualityController controller;
+	configure(controller);
+	for (std::uint32_t i = 0; i < 8; ++i) {
+		controller.Sample(i % 4 == 0 ? 500.0f : fast);
+	}
+	EXPECT_EQ(controller.GetLevel(), 0u);
+}
+
+TEST(QualityController, DeadBandBreaksARun)
+{
+	QualityController controller;
+	configure(controller);
+	feed(controller, slow, 1);
+	feed(controller, borderline, 1);
+	feed(controller, slow, 1);
+	EXPECT_EQ(controller.GetLevel(), 0u);
+}
+
+TEST(QualityController, UpgradesAfterConsecutiveFastWindows)
+{
+	QualityController controller;
+	configure(controller);
+	feed(controller, slow, 2);
+	ASSERT_EQ(controller.GetLevel(), 1u);
+
+	EXPECT_FALSE(feed(controller, fast, 1));
+	const auto decision = feed(controller, fast, 1);
+	ASSERT_TRUE(decision);
+	EXPECT_EQ(decision->newLevel, 0u);
+}
+
+TEST(QualityController, FlappingDoublesTheWindowsNeededToUpgrade)
+{
+	QualityController controller;
+	configure(controller);
+	feed(controller, slow, 2);
+	feed(controller, fast, 2);
+	ASSERT_EQ(controller.GetLevel(), 0u);
+
+	// straight back down after an upgrade
+	feed(controller, slow, 2);
+	ASSERT_EQ(controller.GetLevel(), 1u);
+
+	EXPECT_FALSE(feed(controller, fast, 3));
+	EXPECT_EQ(controller.GetLevel(), 1u);
+	EXPECT_TRUE(feed(controller, fast, 1));
+	EXPECT_EQ(controller.GetLevel(), 0u);
+}
+
+TEST(QualityController, ResetStartsAtFullQuality)
+{
+	QualityController controller;
+	configure(controller);
+	feed(controller, slow, 4);
+	ASSERT_EQ(controller.GetLevel(), 2u);
+
+	controller.Reset();
+	EXPECT_EQ(controller.GetLevel(), 0u);
+
+	// the backoff went with it, two fast windows upgrade again
+	feed(controller, slow, 2);
+	EXPECT_TRUE(feed(controller, fast, 2));
+	EXPECT_EQ(controller.GetLevel(), 0u);
+}
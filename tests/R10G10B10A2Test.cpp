@@ -0,0 +1,74 @@
+#include "R10G10B10A2.h"
+
+namespace
+{
+	// v * 1023 / 65536 rounded, the same scale the kernel uses
+	std::uint32_t to_10bit(std::uint16_t a_value)
+	{
+		return std::min((a_value * 1023u + 32768u) >> 16, 1023u);
+	}
+
+	// DXGI_FORMAT_R10G10B10A2_UNORM written out per pixel: red in the low bits, the top two bits of 10-bit alpha on top
+	std::uint32_t reference(const std::uint16_t* a_bgra)
+	{
+		return to_10bit(a_bgra[2]) | to_10bit(a_bgra[1]) << 10 | to_10bit(a_bgra[0]) << 20 | (to_10bit(a_bgra[3]) >> 8) << 30;
+	}
+
+	std::vector<std::uint16_t> make_row(std::uint32_t a_width, std::uint32_t a_seed)
+	{
+		std::vector<std::uint16_t> row(a_width * 4);
+		std::mt19937               rng(a_seed);
+		for (auto& value : row) {
+			value = static_cast<std::uint16_t>(rng());
+		}
+		return row;
+	}
+}
+
+TEST(R10G10B10A2, PackRowMatchesReference)
+{
+	// widths around the 4 pixel step, so the scalar tail is covered too
+	for (std::uint32_t width = 1; width <= 23; ++width) {
+		const auto                 bgra = make_row(width, width);
+		std::vector<std::uint32_t> packed(width);
+		R10G10B10A2::PackRow(bgra.data(), packed.data(), width);
+		for (std::uint32_t x = 0; x < width; ++x) {
+			ASSERT_EQ(packed[x], reference(bgra.data() + x * 4)) << "width " << width << ", x " << x;
+		}
+	}
+}
+
+TEST(R10G10B10A2, TenBitLevelsSurvive)
+{
+	// 10-bit content widened to 16 bits by replicating its top bits, as PNG encoders and decoders do
+	std::vector<std::uint16_t> bgra(1024 * 4);
+	for (std::uint16_t level = 0; level < 1024; ++level) {
+		const auto widened = static_cast<std::uint16_t>(level << 6 | level >> 4);
+		bgra[level * 4 + 0] = widened;
+		bgra[level * 4 + 1] = widened;
+		bgra[level * 4 + 2] = widened;
+		bgra[level * 4 + 3] = 0xFFFF;
+	}
+
+	std::vector<std::uint32_t> packed(1024);
+	R10G10B10A2::PackRow(bgra.data(), packed.data(), 1024);
+	for (std::uint32_t level = 0; level < 1024; ++level) {
+		ASSERT_EQ(packed[level], level | level << 10 | level << 20 | 3u << 30) << level;
+	}
+}
+
+TEST(R10G10B10A2, EveryValueRoundsToANeighbouringLevel)
+{
+	// all of 16-bit red, four pixels at a time; within a hair of half a level of the exact value
+	std::vector<std::uint16_t> bgra(65536 * 4, 0);
+	for (std::uint32_t value = 0; value < 65536; ++value) {
+		bgra[value * 4 + 2] = static_cast<std::uint16_t>(value);
+	}
+
+	std::vector<std::uint32_t> packed(65536);
+	R10G10B10A2::PackRow(bgra.data(), packed.data(), 65536);
+	for (std::uint32_t value = 0; value < 65536; ++value) {
+		const double exact = value * 1023.0 / 65535.0;
+		ASSERT_LE(std::abs(static_cast<double>(packed[value] & 0x3FF) - exact), 0.52) << value;
+	}
+}
@@ -0,0 +1,111 @@
+#include "StripePool.h"
+
+namespace
+{
+	struct Stripe
+	{
+		int             begin;
+		int             end;
+		std::thread::id thread;
+	};
+
+	// every stripe a run handed out, in the order they finished
+	std::vector<Stripe> run(StripePool& a_pool, int a_rows, int a_minRows)
+	{
+		std::mutex          lock;
+		std::vector<Stripe> stripes;
+		a_pool.Run(a_rows, a_minRows, [&](int a_begin, int a_end) {
+			std::scoped_lock locker(lock);
+			stripes.push_back({ a_begin, a_end, std::this_thread::get_id() });
+		});
+		std::ranges::sort(stripes, {}, &Stripe::begin);
+		return stripes;
+	}
+
+	// contiguous, in order, and nothing outside [0, a_rows)
+	void expect_covers(const std::vector<Stripe>& a_stripes, int a_rows)
+	{
+		int next = 0;
+		for (const auto& stripe : a_stripes) {
+			EXPECT_EQ(stripe.begin, next);
+			EXPECT_LT(stripe.begin, stripe.end);
+			next = stripe.end;
+		}
+		EXPECT_EQ(next, a_rows);
+	}
+}
+
+TEST(StripePool, CoversEveryRowOnce)
+{
+	StripePool pool(3);
+	EXPECT_EQ(pool.GetThreadCount(), 3u);
+
+	for (const int rows : { 1, 63, 64, 720, 1080, 1081, 2160 }) {
+		SCOPED_TRACE(rows);
+		const auto stripes = run(pool, rows, 64);
+		expect_covers(stripes, rows);
+
+		// two stripes per thread at most, none shorter than asked for except the remainder
+		EXPECT_LE(stripes.size(), 8u);
+		for (std::size_t i = 0; i + 1 < stripes.size(); ++i) {
+			EXPECT_GE(stripes[i].end - stripes[i].begin, 64);
+		}
+	}
+}
+
+TEST(StripePool, SmallJobsAreOneStripe)
+{
+	// whichever thread gets to it first runs it
+	StripePool pool(3);
+	const auto stripes = run(pool, 100, 64);
+	ASSERT_EQ(stripes.size(), 1u);
+	expect_covers(stripes, 100);
+}
+
+TEST(StripePool, NoHelpersRunsEverythingInline)
+{
+	StripePool pool(0);
+	const auto stripes = run(pool, 1080, 64);
+	expect_covers(stripes, 1080);
+	for (const auto& stripe : stripes) {
+		EXPECT_EQ(stripe.thread, std::this_thread::get_id());
+	}
+}
+
+TEST(StripePool, HelpersShareTheWork)
+{
+	// a stripe that waits for the others can only finish if they run on other threads
+	StripePool       pool(3);
+	std::atomic<int> started{ 0 };
+	std::atomic<int> maxConcurrent{ 0 };
+	pool.Run(4 * 64, 64, [&](int, int) {
+		const auto now = ++started;
+		maxConcurrent = std::max(maxConcurrent.load(), now);
+		const auto deadline = std::chrono::steady_clock::now() + 2s;
+		while (started.load() < 2 && std::chrono::steady_clock::now() < deadline) {
+			std::this_thread::yield();
+		}
+	});
+	EXPECT_GE(maxConcurrent.load(), 2);
+}
+
+TEST(StripePool, RunsBackToBack)
+{
+	// helpers that wake late must not pick up stripes of a run that already finished
+	StripePool                pool(3);
+	std::vector<std::uint8_t> rows(1080);
+	for (int pass = 1; pass <= 200; ++pass) {
+		pool.Run(static_cast<int>(rows.size()), 16, [&](int a_begin, int a_end) {
+			for (int y = a_begin; y < a_end; ++y) {
+				rows[y]++;
+			}
+		});
+		ASSERT_TRUE(std::ranges::all_of(rows, [&](std::uint8_t a_count) { return a_count == static_cast<std::uint8_t>(pass); })) << pass;
+	}
+}
+
+TEST(StripePool, EmptyJobDoesNothing)
+{
+	StripePool pool(2);
+	EXPECT_TRUE(run(pool, 0, 64).empty());
+}
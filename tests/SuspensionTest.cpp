@@ -0,0 +1,84 @@
+#include "Suspension.h"
+
+namespace
+{
+	// what the present hook and window state feed in the game, set by the test instead
+	class FakeSource : public Visibility::Source
+	{
+	public:
+		bool IsVisible() const override
+		{
+			polls.fetch_add(1, std::memory_order_relaxed);
+			return visible.load(std::memory_order_relaxed);
+		}
+
+		// members
+		std::atomic<bool>                  visible{ true };
+		mutable std::atomic<std::uint32_t> polls{ 0 };
+	};
+
+	constexpr std::chrono::milliseconds pollInterval{ 1 };
+
+	Clock::time_point at(double a_seconds)
+	{
+		return Clock::time_point(Clock::duration(a_seconds));
+	}
+}
+
+TEST(Suspension, VisibleDoesNotWait)
+{
+	FakeSource source;
+	EXPECT_TRUE(Suspension::WaitUntilVisible(source, {}, pollInterval));
+	EXPECT_EQ(source.polls.load(), 1u);
+}
+
+TEST(Suspension, WaitsUntilVisibleAgain)
+{
+	FakeSource source;
+	source.visible = false;
+
+	std::jthread restore([&] {
+		while (source.polls.load() < 3) {
+			std::this_thread::yield();
+		}
+		source.visible = true;
+	});
+
+	EXPECT_TRUE(Suspension::WaitUntilVisible(source, {}, pollInterval));
+	EXPECT_GE(source.polls.load(), 3u);
+}
+
+TEST(Suspension, StopEndsTheWait)
+{
+	FakeSource source;
+	source.visible = false;
+
+	std::stop_source stop;
+
+	std::jthread stopper([&] {
+		while (source.polls.load() < 2) {
+			std::this_thread::yield();
+		}
+		stop.request_stop();
+	});
+
+	EXPECT_FALSE(Suspension::WaitUntilVisible(source, stop.get_token(), pollInterval));
+	EXPECT_FALSE(source.visible.load());
+}
+
+TEST(Suspension, WithoutAudioPicksUpWherePlaybackStopped)
+{
+	// 10s into the video when it was hidden for 5s
+	const auto resume = Suspension::GetResume(at(110.0), at(115.0), at(100.0), false);
+	EXPECT_FALSE(resume.seek);
+	EXPECT_DOUBLE_EQ(resume.suspendedFor.count(), 5.0);
+	EXPECT_DOUBLE_EQ(resume.position.count(), 10.0);
+}
+
+TEST(Suspension, WithAudioCatchesUpToIt)
+{
+	const auto resume = Suspension::GetResume(at(110.0), at(115.0), at(100.0), true);
+	EXPECT_TRUE(resume.seek);
+	EXPECT_DOUBLE_EQ(resume.suspendedFor.count(), 5.0);
+	EXPECT_DOUBLE_EQ(resume.position.count(), 15.0);
+}
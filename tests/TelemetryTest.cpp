@@ -0,0 +1,119 @@
+#include "TelemetryBlock.h"
+
+namespace
+{
+	// what the writer does once when it maps the file
+	void init(Telemetry::Block& a_block)
+	{
+		a_block.magic = Telemetry::magic;
+		a_block.version = Telemetry::version;
+		a_block.statsSize = sizeof(Telemetry::Stats);
+	}
+
+	// every field follows from a_serial, so a reader can tell a torn copy from a whole one
+	Telemetry::Stats make_stats(std::uint64_t a_serial)
+	{
+		Telemetry::Stats stats;
+		stats.frames = a_serial;
+		stats.droppedFrames = a_serial * 3;
+		stats.memoryBytes = static_cast<std::int64_t>(a_serial * 7);
+		stats.elapsed = static_cast<double>(a_serial) * 0.5;
+		stats.width = static_cast<std::uint32_t>(a_serial);
+		stats.drift = static_cast<float>(a_serial % 1000);
+		const auto name = std::to_string(a_serial);
+		std::ranges::copy(name, stats.video);
+		return stats;
+	}
+
+	bool is_whole(const Telemetry::Stats& a_stats)
+	{
+		const auto expected = make_stats(a_stats.frames);
+		return std::memcmp(&a_stats, &expected, sizeof(Telemetry::Stats)) == 0;
+	}
+}
+
+TEST(Telemetry, NothingBeforeTheFirstStore)
+{
+	Telemetry::Block block{};
+	init(block);
+
+	Telemetry::Stats stats;
+	EXPECT_FALSE(Telemetry::Load(block, stats));
+}
+
+TEST(Telemetry, RoundTrips)
+{
+	Telemetry::Block block{};
+	init(block);
+
+	for (std::uint64_t serial = 1; serial <= 3; ++serial) {
+		Telemetry::Store(block, make_stats(serial));
+
+		Telemetry::Stats stats;
+		ASSERT_TRUE(Telemetry::Load(block, stats));
+		EXPECT_EQ(stats.frames, serial);
+		EXPECT_TRUE(is_whole(stats));
+		EXPECT_EQ(block.sequence.load(), serial * 2);  // even, an update in progress is odd
+	}
+}
+
+TEST(Telemetry, OtherLayoutsAreRejected)
+{
+	Telemetry::Block block{};
+	init(block);
+	Telemetry::Store(block, make_stats(1));
+
+	Telemetry::Stats stats;
+	block.version = Telemetry::version + 1;
+	EXPECT_FALSE(Telemetry::Load(block, stats));
+
+	init(block);
+	block.statsSize = sizeof(Telemetry::Stats) - 8;
+	EXPECT_FALSE(Telemetry::Load(block, stats));
+
+	init(block);
+	block.magic = 0;
+	EXPECT_FALSE(Telemetry::Load(block, stats));
+}
+
+TEST(Telemetry, UpdateInProgressIsNotRead)
+{
+	Telemetry::Block block{};
+	init(block);
+	Telemetry::Store(block, make_stats(1));
+
+	// a writer that died halfway through an update
+	block.sequence.fetch_add(1);
+
+	Telemetry::Stats stats;
+	EXPECT_FALSE(Telemetry::Load(block, stats));
+}
+
+TEST(Telemetry, ReadersNeverSeeATornUpdate)
+{
+	Telemetry::Block block{};
+	init(block);
+	Telemetry::Store(block, make_stats(1));
+
+	constexpr std::uint64_t updates{ 200000 };
+
+	std::jthread writer([&] {
+		for (std::uint64_t serial = 2; serial <= updates; ++serial) {
+			Telemetry::Store(block, make_stats(serial));
+		}
+	});
+
+	std::uint64_t reads = 0;
+	std::uint64_t last = 0;
+	while (last < updates) {
+		Telemetry::Stats stats;
+		if (!Telemetry::Load(block, stats)) {
+			continue;  // raced every attempt, the reader just tries again later
+		}
+		ASSERT_TRUE(is_whole(stats)) << "torn read at " << stats.frames;
+		ASSERT_GE(stats.frames, last);  // never goes back
+		last = stats.frames;
+		reads++;
+	}
+	EXPECT_GT(reads, 0u);
+}
@@ -0,0 +1,23 @@
+#pragma once
+
+// a file in the temp directory, removed before and after the test that uses it
+struct TempFile
+{
+	explicit TempFile(std::string_view a_name) :
+		path(std::filesystem::temp_directory_path() / a_name)
+	{
+		std::error_code ec;
+		std::filesystem::remove(path, ec);
+	}
+	TempFile(const TempFile&) = delete;
+	~TempFile()
+	{
+		std::error_code ec;
+		std::filesystem::remove(path, ec);
+	}
+
+	TempFile& operator=(const TempFile&) = delete;
+
+	// members
+	std::filesystem::path path;
+};
@@ -0,0 +1,55 @@
+#include "VideoList.h"
+
+namespace
+{
+	std::vector<std::filesystem::path> make_paths(std::initializer_list<std::string_view> a_paths)
+	{
+		std::vector<std::filesystem::path> paths;
+		for (const auto path : a_paths) {
+			paths.emplace_back(path);
+		}
+		return paths;
+	}
+}
+
+TEST(VideoList, GroupsVariantsByHeight)
+{
+	const auto videos = VideoList::Group(make_paths({ "videos/intro.2160.mp4", "videos/intro.mp4", "videos/intro.1080p.mp4", "videos/outro.mp4" }));
+	ASSERT_EQ(videos.size(), 2u);
+
+	const auto& intro = videos[0];
+	ASSERT_EQ(intro.variants.size(), 3u);
+	EXPECT_EQ(intro.variants[0].height, 1080u);
+	EXPECT_EQ(intro.variants[1].height, 2160u);
+	EXPECT_EQ(intro.variants[2].height, VideoList::originalHeight);
+	EXPECT_EQ(videos[1].variants.size(), 1u);
+}
+
+TEST(VideoList, ImplausibleHeightsArePartOfTheName)
+{
+	const auto videos = VideoList::Group(make_paths({ "videos/episode.2.mp4", "videos/episode.mp4", "videos/.1080.mp4" }));
+	EXPECT_EQ(videos.size(), 3u);
+}
+
+TEST(VideoList, FoldersKeepVideosApart)
+{
+	const auto videos = VideoList::Group(make_paths({ "a/intro.1080.mp4", "b/intro.mp4" }));
+	EXPECT_EQ(videos.size(), 2u);
+}
+
+TEST(VideoList, NamesIgnoreCase)
+{
+	const auto videos = VideoList::Group(make_paths({ "videos/Intro.1080.mp4", "videos/intro.mp4" }));
+	ASSERT_EQ(videos.size(), 1u);
+	EXPECT_EQ(videos[0].variants.size(), 2u);
+}
+
+TEST(VideoList, SelectsTheSmallestCoveringVariant)
+{
+	const auto  videos = VideoList::Group(make_paths({ "intro.720.mp4", "intro.1080.mp4", "intro.2160.mp4" }));
+	const auto& intro = videos[0];
+	EXPECT_EQ(intro.Select(720), "intro.720.mp4");
+	EXPECT_EQ(intro.Select(1000), "intro.1080.mp4");
+	EXPECT_EQ(intro.Select(1440), "intro.2160.mp4");
+	EXPECT_EQ(intro.Select(4320), "intro.2160.mp4");  // nothing covers it, the largest one
+}
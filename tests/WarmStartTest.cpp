@@ -0,0 +1,97 @@
+#include "WarmStart.h"
+
+namespace
+{
+	void prepare(WarmStart& a_warmStart, const std::string& a_path)
+	{
+		a_warmStart.Begin(a_path);
+		a_warmStart.Finish(true);
+	}
+}
+
+TEST(WarmStart, BeginsOnlyOnce)
+{
+	WarmStart warmStart;
+	EXPECT_TRUE(warmStart.Begin("intro.mp4"));
+	EXPECT_EQ(warmStart.GetState(), WarmStart::State::kPreparing);
+	EXPECT_FALSE(warmStart.Begin("other.mp4"));
+}
+
+TEST(WarmStart, FinishDecidesPreparedOrFailed)
+{
+	WarmStart prepared;
+	prepare(prepared, "intro.mp4");
+	EXPECT_EQ(prepared.GetState(), WarmStart::State::kPrepared);
+
+	WarmStart failed;
+	failed.Begin("intro.mp4");
+	failed.Finish(false);
+	EXPECT_EQ(failed.GetState(), WarmStart::State::kFailed);
+}
+
+TEST(WarmStart, NoTextureWhilePreparing)
+{
+	WarmStart warmStart;
+	EXPECT_FALSE(warmStart.OnDeviceReady());
+	warmStart.Begin("intro.mp4");
+	EXPECT_FALSE(warmStart.OnDeviceReady());
+}
+
+TEST(WarmStart, BoundOnlyOnceMarked)
+{
+	WarmStart warmStart;
+	prepare(warmStart, "intro.mp4");
+	EXPECT_TRUE(warmStart.OnDeviceReady());
+	EXPECT_FALSE(warmStart.IsBound());
+
+	warmStart.MarkBound();
+	EXPECT_TRUE(warmStart.IsBound());
+	EXPECT_FALSE(warmStart.OnDeviceReady());
+}
+
+TEST(WarmStart, FailedBindIsRetriedByPlayback)
+{
+	WarmStart warmStart;
+	prepare(warmStart, "intro.mp4");
+	ASSERT_TRUE(warmStart.OnDeviceReady());
+	// the texture couldn't be created, so nothing marks it bound
+
+	EXPECT_EQ(warmStart.Take("intro.mp4"), WarmStart::Claim::kWarm);
+	EXPECT_FALSE(warmStart.IsBound());
+}
+
+TEST(WarmStart, TakeClaimsTheSameVideo)
+{
+	WarmStart warmStart;
+	prepare(warmStart, "intro.mp4");
+	EXPECT_EQ(warmStart.Take("intro.mp4"), WarmStart::Claim::kWarm);
+	EXPECT_EQ(warmStart.GetState(), WarmStart::State::kClaimed);
+	EXPECT_EQ(warmStart.Take("intro.mp4"), WarmStart::Claim::kCold);
+	EXPECT_FALSE(warmStart.OnDeviceReady());
+}
+
+TEST(WarmStart, TakeDiscardsAnotherVideo)
+{
+	WarmStart warmStart;
+	prepare(warmStart, "intro.2160.mp4");
+	EXPECT_EQ(warmStart.Take("intro.1080.mp4"), WarmStart::Claim::kDiscarded);
+	EXPECT_EQ(warmStart.GetState(), WarmStart::State::kDiscarded);
+}
+
+TEST(WarmStart, TakeDiscardsAFailedPreparation)
+{
+	WarmStart warmStart;
+	warmStart.Begin("intro.mp4");
+	warmStart.Finish(false);
+	EXPECT_EQ(warmStart.Take("intro.mp4"), WarmStart::Claim::kDiscarded);
+}
+
+TEST(WarmStart, NothingPreparedIsCold)
+{
+	WarmStart idle;
+	EXPECT_EQ(idle.Take("intro.mp4"), WarmStart::Claim::kCold);
+
+	WarmStart preparing;
+	preparing.Begin("intro.mp4");
+	EXPECT_EQ(preparing.Take("intro.mp4"), WarmStart::Claim::kCold);
+}
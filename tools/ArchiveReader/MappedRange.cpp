@@ -0,0 +1,77 @@
+#include "MappedRange.h"
+
+MappedRange::~MappedRange()
+{
+	Close();
+}
+
+bool MappedRange::Open(const std::filesystem::path& a_path, std::uint64_t a_offset, std::uint64_t a_size)
+{
+	Close();
+
+	// views have to start on the allocation granularity, the range is found inside one that does
+#ifdef _WIN32
+	SYSTEM_INFO info{};
+	GetSystemInfo(&info);
+	const std::uint64_t start = a_offset / info.dwAllocationGranularity * info.dwAllocationGranularity;
+	viewSize = a_offset + a_size - start;
+
+	file = CreateFileW(a_path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+	mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (mapping) {
+		view = MapViewOfFile(mapping, FILE_MAP_READ, static_cast<DWORD>(start >> 32), static_cast<DWORD>(start), static_cast<SIZE_T>(viewSize));
+	}
+#else
+	const auto          pageSize = static_cast<std::uint64_t>(::sysconf(_SC_PAGESIZE));
+	const std::uint64_t start = a_offset / pageSize * pageSize;
+	viewSize = a_offset + a_size - start;
+
+	file = ::open(a_path.c_str(), O_RDONLY);
+	if (file == -1) {
+		return false;
+	}
+	if (const auto mapped = ::mmap(nullptr, viewSize, PROT_READ, MAP_SHARED, file, static_cast<off_t>(start)); mapped != MAP_FAILED) {
+		view = mapped;
+	}
+#endif
+
+	if (!view) {
+		Close();
+		return false;
+	}
+	data = static_cast<const std::uint8_t*>(view) + (a_offset - start);
+	size = a_size;
+	return true;
+}
+
+void MappedRange::Close()
+{
+#ifdef _WIN32
+	if (view) {
+		UnmapViewOfFile(view);
+	}
+	if (mapping) {
+		CloseHandle(mapping);
+		mapping = nullptr;
+	}
+	if (file != INVALID_HANDLE_VALUE) {
+		CloseHandle(file);
+		file = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (view) {
+		::munmap(view, viewSize);
+	}
+	if (file != -1) {
+		::close(file);
+		file = -1;
+	}
+#endif
+	view = nullptr;
+	viewSize = 0;
+	data = nullptr;
+	size = 0;
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+// Read-only mapping of part of a file, the way the plugin maps an archived video for the decoder.
+class MappedRange
+{
+public:
+	MappedRange() = default;
+	MappedRange(const MappedRange&) = delete;
+	~MappedRange();
+
+	MappedRange& operator=(const MappedRange&) = delete;
+
+	bool Open(const std::filesystem::path& a_path, std::uint64_t a_offset, std::uint64_t a_size);
+	void Close();
+
+	const std::uint8_t* GetData() const { return data; }
+	std::uint64_t       GetSize() const { return size; }
+
+private:
+	// members
+#ifdef _WIN32
+	HANDLE file{ INVALID_HANDLE_VALUE };
+	HANDLE mapping{ nullptr };
+#else
+	int file{ -1 };
+#endif
+	void*               view{ nullptr };
+	std::uint64_t       viewSize{ 0 };
+	const std::uint8_t* data{ nullptr };
+	std::uint64_t       size{ 0 };
+};
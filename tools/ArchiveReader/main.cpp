@@ -0,0 +1,128 @@
+#include "ArchiveIndex.h"
+#include "MappedRange.h"
+
+namespace
+{
+	constexpr auto usage =
+		"usage: mmvarchive <archive> [options]\n"
+		"\n"
+		"Lists the videos a BSA or BA2 archive holds where the plugin looks for them, and whether it can play them\n"
+		"straight from the archive (only files stored uncompressed can be). Exits with 1 if one can't be played.\n"
+		"\n"
+		"  --directory <name>   folder inside the archive (default MainMenuVideo, \"\" for every file)\n"
+		"  --read               time reading each playable file through a mapped view, as the decoder does\n"
+		"  --chunk <KB>         size of each read with --read (default 64)\n"sv;
+
+	template <class T>
+	bool parse_number(std::string_view a_arg, T& a_value)
+	{
+		const auto [ptr, ec] = std::from_chars(a_arg.data(), a_arg.data() + a_arg.size(), a_value);
+		return ec == std::errc() && ptr == a_arg.data() + a_arg.size() && a_value > 0;
+	}
+
+	double to_mb(std::uint64_t a_bytes)
+	{
+		return static_cast<double>(a_bytes) / (1024.0 * 1024.0);
+	}
+
+	// copies the view out in decoder sized pieces; the first pass faults the pages in, like the first loop in game
+	bool time_read(const std::filesystem::path& a_archive, const ArchiveIndex::File& a_file, std::size_t a_chunkSize)
+	{
+		MappedRange range;
+		if (!range.Open(a_archive, a_file.offset, a_file.size)) {
+			std::printf("    unable to map the file's range\n");
+			return false;
+		}
+
+		// the sum of each chunk's last byte keeps the copies from being optimized away, and both passes must agree on it
+		std::vector<std::uint8_t> buffer(a_chunkSize);
+		for (const auto pass : { "first read"sv, "cached"sv }) {
+			const auto    start = std::chrono::steady_clock::now();
+			std::uint64_t checksum = 0;
+			for (std::uint64_t position = 0; position < range.GetSize(); position += a_chunkSize) {
+				const auto count = static_cast<std::size_t>(std::min<std::uint64_t>(a_chunkSize, range.GetSize() - position));
+				std::memcpy(buffer.data(), range.GetData() + position, count);
+				checksum += buffer[count - 1];
+			}
+			const auto seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			std::printf("    %-10.*s %9.1f MB/s  (sum %llu)\n", static_cast<int>(pass.size()), pass.data(), seconds > 0.0 ? to_mb(range.GetSize()) / seconds : 0.0, static_cast<unsigned long long>(checksum));
+		}
+		return true;
+	}
+}
+
+int main(int a_argc, char* a_argv[])
+{
+	std::vector<std::string_view> args(a_argv + 1, a_argv + a_argc);
+	std::vector<std::string_view> archives;
+
+	std::string_view directory = "MainMenuVideo"sv;
+	bool             read = false;
+	std::uint32_t    chunkKB = 64;
+
+	for (std::size_t i = 0; i < args.size(); ++i) {
+		const auto arg = args[i];
+		const auto next = i + 1 < args.size() ? args[i + 1] : ""sv;
+
+		bool valid = true;
+		if (arg == "--directory"sv) {
+			valid = i + 1 < args.size();
+			directory = next;
+			++i;
+		} else if (arg == "--read"sv) {
+			read = true;
+		} else if (arg == "--chunk"sv) {
+			valid = parse_number(next, chunkKB);
+			++i;
+		} else if (arg.starts_with("--"sv)) {
+			valid = false;
+		} else {
+			archives.push_back(arg);
+		}
+
+		if (!valid) {
+			std::fprintf(stderr, "error: invalid option %.*s %.*s\n", static_cast<int>(arg.size()), arg.data(), static_cast<int>(next.size()), next.data());
+			std::fputs(usage.data(), stderr);
+			return 2;
+		}
+	}
+
+	if (archives.size() != 1) {
+		std::fputs(usage.data(), stderr);
+		return 2;
+	}
+
+	const std::filesystem::path archive(archives[0]);
+	std::ifstream               file(archive, std::ios::binary);
+	if (!file) {
+		std::fprintf(stderr, "error: unable to open %s\n", archive.string().c_str());
+		return 1;
+	}
+
+	const auto start = std::chrono::steady_clock::now();
+	const auto files = ArchiveIndex::Read(file, directory);
+	const auto indexMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+	if (!files) {
+		std::fprintf(stderr, "error: %s isn't a BSA or general BA2 archive, or its index is damaged\n", archive.string().c_str());
+		return 1;
+	}
+	if (directory.empty()) {
+		std::printf("%zu files, index read in %.2f ms\n", files->size(), indexMs);
+	} else {
+		std::printf("%zu files in %.*s, index read in %.2f ms\n", files->size(), static_cast<int>(directory.size()), directory.data(), indexMs);
+	}
+
+	std::uint32_t unplayable = 0;
+	for (const auto& entry : *files) {
+		std::printf("%-60s %10.1f MB  %s\n", entry.name.c_str(), to_mb(entry.size), entry.compressed ? "COMPRESSED, repack it uncompressed" : "stored");
+		if (entry.compressed) {
+			unplayable++;
+			continue;
+		}
+		if (read && entry.size > 0 && !time_read(archive, entry, std::size_t(chunkKB) * 1024)) {
+			unplayable++;
+		}
+	}
+
+	return unplayable > 0 ? 1 : 0;
+}
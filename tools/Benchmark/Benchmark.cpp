@@ -0,0 +1,233 @@
+#include "Benchmark.h"
+
+#include "B5G6R5.h"
+#include "Blend.h"
+#include "FrameHash.h"
+#include "FrameUpload.h"
+
+namespace Benchmark
+{
+	namespace detail
+	{
+		// what the plugin's frame lock is
+		using Lock = std::shared_mutex;
+		using ReadLocker = std::shared_lock<Lock>;
+		using WriteLocker = std::unique_lock<Lock>;
+
+		// D3D pads mapped rows, this is a typical alignment and keeps the copy on its row by row path
+		constexpr std::uint32_t rowPitchAlignment{ 256 };
+
+		cv::Mat make_frame(int a_width, int a_height, int a_type)
+		{
+			// noise rather than a flat colour, so nothing can take a shortcut on uniform data
+			cv::Mat frame(a_height, a_width, a_type);
+			cv::randu(frame, cv::Scalar::all(0), cv::Scalar::all(a_type == CV_16UC4 ? 65535 : 255));
+			return frame;
+		}
+
+		std::uint32_t get_row_pitch(const cv::Mat& a_frame)
+		{
+			const auto rowBytes = static_cast<std::uint32_t>(a_frame.cols * 4);
+			return (rowBytes + rowPitchAlignment) / rowPitchAlignment * rowPitchAlignment;
+		}
+
+		// the video thread publishing a frame and the render thread picking it up for the upload, as in VideoPlayer
+		struct Publisher
+		{
+			void Publish(cv::Mat& a_frame)
+			{
+				{
+					WriteLocker locker(lock);
+					cv::swap(a_frame, videoFrame);
+				}
+				serial.fetch_add(1, std::memory_order_release);
+
+				cv::Mat localFrame;
+				{
+					ReadLocker locker(lock);
+					localFrame = videoFrame;
+				}
+			}
+
+			// members
+			Lock                       lock;
+			cv::Mat                    videoFrame;
+			std::atomic<std::uint64_t> serial{ 0 };
+		};
+
+		std::vector<Kernel> make_kernels()
+		{
+			std::vector<Kernel> kernels;
+
+			kernels.push_back({ "convert_bgra"sv, "decoded BGR to the BGRA texture format (ConvertStage)"sv, [](int a_width, int a_height) -> Run {
+				return [src = make_frame(a_width, a_height, CV_8UC3), dst = cv::Mat()]() mutable {
+					cv::cvtColor(src, dst, cv::COLOR_BGR2BGRA);
+				};
+			} });
+
+			for (const bool dither : { false, true }) {
+				kernels.push_back({ dither ? "pack_b5g6r5_dither"sv : "pack_b5g6r5"sv, dither ? "decoded BGR to dithered 16-bit colour (ConvertStage, b16BitFrames)"sv : "decoded BGR to 16-bit colour (ConvertStage, b16BitFrames)"sv, [dither](int a_width, int a_height) -> Run {
+					return [src = make_frame(a_width, a_height, CV_8UC3), dst = cv::Mat(), dither]() mutable {
+						B5G6R5::Pack(src, dst, dither);
+					};
+				} });
+			}
+
+			kernels.push_back({ "reduce_16bit"sv, "16-bit BGRA to 8 bits without a 10-bit texture (ConvertStage)"sv, [](int a_width, int a_height) -> Run {
+				return [src = make_frame(a_width, a_height, CV_16UC4), dst = cv::Mat()]() mutable {
+					src.convertTo(dst, CV_8U, 1.0 / 257.0);
+				};
+			} });
+
+			kernels.push_back({ "upload_bgra"sv, "BGRA rows into padded mapped rows (Texture::Update)"sv, [](int a_width, int a_height) -> Run {
+				auto src = make_frame(a_width, a_height, CV_8UC4);
+				auto pitch = get_row_pitch(src);
+				return [src, pitch, dst = std::vector<std::uint8_t>(std::size_t(pitch) * a_height)]() mutable {
+					FrameUpload::WriteRows(src, dst.data(), pitch);
+				};
+			} });
+
+			kernels.push_back({ "upload_r10g10b10a2"sv, "16-bit BGRA packed to 10 bits into padded mapped rows (Texture::Update)"sv, [](int a_width, int a_height) -> Run {
+				auto src = make_frame(a_width, a_height, CV_16UC4);
+				auto pitch = get_row_pitch(src);
+				return [src, pitch, dst = std::vector<std::uint8_t>(std::size_t(pitch) * a_height)]() mutable {
+					FrameUpload::WriteRows(src, dst.data(), pitch);
+				};
+			} });
+
+			kernels.push_back({ "upload_blended"sv, "two BGRA frames mixed half and half into padded mapped rows (Texture::Update, bBlendFrames)"sv, [](int a_width, int a_height) -> Run {
+				auto from = make_frame(a_width, a_height, CV_8UC4);
+				auto to = make_frame(a_width, a_height, CV_8UC4);
+				auto pitch = get_row_pitch(to);
+				return [from, to, pitch, dst = std::vector<std::uint8_t>(std::size_t(pitch) * a_height)]() mutable {
+					FrameUpload::WriteBlendedRows(from, to, Blend::fullWeight / 2, dst.data(), pitch);
+				};
+			} });
+
+			kernels.push_back({ "fingerprint"sv, "sampled hash for repeated frame detection (CreateVideoThread)"sv, [](int a_width, int a_height) -> Run {
+				return [src = make_frame(a_width, a_height, CV_8UC3)]() {
+					static_cast<void>(FrameHash::Fingerprint(src));
+				};
+			} });
+
+			kernels.push_back({ "compare_equal"sv, "byte for byte check of a repeated frame, the worst case (CreateVideoThread)"sv, [](int a_width, int a_height) -> Run {
+				auto src = make_frame(a_width, a_height, CV_8UC3);
+				return [src, copy = src.clone()]() {
+					static_cast<void>(FrameHash::Equal(src, copy));
+				};
+			} });
+
+			kernels.push_back({ "publish"sv, "frame swap under videoFrameLock and the read lock round trip of the upload"sv, [](int a_width, int a_height) -> Run {
+				auto publisher = std::make_shared<Publisher>();
+				publisher->videoFrame = make_frame(a_width, a_height, CV_8UC4);
+				return [publisher, frame = make_frame(a_width, a_height, CV_8UC4)]() mutable {
+					publisher->Publish(frame);
+				};
+			} });
+
+			kernels.push_back({ "publish_contended"sv, "publish while another thread keeps taking the read lock, as a fast render loop would"sv, [](int a_width, int a_height) -> Run {
+				struct State
+				{
+					Publisher    publisher;
+					std::jthread reader;
+				};
+				auto state = std::make_shared<State>();
+				state->publisher.videoFrame = make_frame(a_width, a_height, CV_8UC4);
+				state->reader = std::jthread([publisher = &state->publisher](std::stop_token a_st) {
+					while (!a_st.stop_requested()) {
+						{
+							ReadLocker locker(publisher->lock);
+							cv::Mat    localFrame = publisher->videoFrame;
+						}
+						std::this_thread::yield();
+					}
+				});
+				return [state, frame = make_frame(a_width, a_height, CV_8UC4)]() mutable {
+					state->publisher.Publish(frame);
+				};
+			} });
+
+			return kernels;
+		}
+
+		double time_batch(const Run& a_run, std::uint32_t a_count)
+		{
+			const auto start = std::chrono::steady_clock::now();
+			for (std::uint32_t i = 0; i < a_count; ++i) {
+				a_run();
+			}
+			return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+		}
+	}
+
+	const std::vector<Kernel>& GetKernels()
+	{
+		static const auto kernels = detail::make_kernels();
+		return kernels;
+	}
+
+	double Measure(const Run& a_run, std::chrono::milliseconds a_minTime)
+	{
+		// the first run faults in destination buffers and warms the caches
+		a_run();
+
+		std::uint32_t batch = 1;
+		while (batch < (1u << 20) && detail::time_batch(a_run, batch) < 1000.0) {
+			batch *= 2;
+		}
+
+		std::vector<double> samples;
+		const auto          end = std::chrono::steady_clock::now() + a_minTime;
+		while (samples.size() < 5 || std::chrono::steady_clock::now() < end) {
+			samples.push_back(detail::time_batch(a_run, batch) / batch);
+		}
+
+		const auto middle = samples.begin() + static_cast<std::ptrdiff_t>(samples.size() / 2);
+		std::ranges::nth_element(samples, middle);
+		return *middle;
+	}
+
+	std::optional<Baseline> LoadBaseline(const std::filesystem::path& a_path)
+	{
+		std::ifstream file(a_path);
+		if (!file) {
+			return std::nullopt;
+		}
+
+		Baseline    baseline;
+		std::string line;
+		while (std::getline(file, line)) {
+			if (line.empty() || line.front() == '#') {
+				continue;
+			}
+
+			const auto first = line.find(',');
+			const auto second = first != std::string::npos ? line.find(',', first + 1) : std::string::npos;
+			if (second == std::string::npos) {
+				continue;
+			}
+
+			const std::string_view value(line.data() + second + 1, line.size() - second - 1);
+			double                 microseconds = 0.0;
+			if (const auto [ptr, ec] = std::from_chars(value.data(), value.data() + value.size(), microseconds); ec == std::errc() && microseconds > 0.0) {
+				baseline[{ line.substr(0, first), line.substr(first + 1, second - first - 1) }] = microseconds;
+			}
+		}
+		return baseline;
+	}
+
+	bool SaveBaseline(const std::filesystem::path& a_path, const Baseline& a_baseline)
+	{
+		std::ofstream file(a_path, std::ios::trunc);
+		file << "# mmvbench baseline, microseconds per frame. Only comparable on the machine that recorded it:\n"
+				"# re-record with --record <file> after a deliberate change, or when moving to another machine\n"
+				"kernel,resolution,microseconds\n";
+
+		char value[32];
+		for (const auto& [key, microseconds] : a_baseline) {
+			std::snprintf(value, sizeof(value), "%.3f", microseconds);
+			file << key.first << ',' << key.second << ',' << value << '\n';
+		}
+		return static_cast<bool>(file);
+	}
+}
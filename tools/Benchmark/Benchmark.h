@@ -0,0 +1,41 @@
+#pragma once
+
+// Timings of the work the plugin does for every frame (conversion, the texture copy, publishing), at the resolutions
+// menu videos come in, compared against baselines recorded on the same machine.
+namespace Benchmark
+{
+	struct Resolution
+	{
+		std::string_view name;
+		int              width;
+		int              height;
+	};
+
+	inline constexpr std::array resolutions{
+		Resolution{ "720p"sv, 1280, 720 },
+		Resolution{ "1080p"sv, 1920, 1080 },
+		Resolution{ "1440p"sv, 2560, 1440 },
+		Resolution{ "4k"sv, 3840, 2160 }
+	};
+
+	using Run = std::function<void()>;
+
+	struct Kernel
+	{
+		std::string_view             name;
+		std::string_view             description;
+		std::function<Run(int, int)> prepare;  // sets up a frame of the given size, returns one frame's work on it
+	};
+
+	const std::vector<Kernel>& GetKernels();
+
+	// median over a_minTime of runs, in microseconds. Short kernels are timed in batches so the clock doesn't dominate
+	double Measure(const Run& a_run, std::chrono::milliseconds a_minTime);
+
+	// kernel,resolution -> microseconds
+	using Baseline = std::map<std::pair<std::string, std::string>, double>;
+
+	// csv lines of kernel,resolution,microseconds; # starts a comment
+	std::optional<Baseline> LoadBaseline(const std::filesystem::path& a_path);
+	bool                    SaveBaseline(const std::filesystem::path& a_path, const Baseline& a_baseline);
+}
@@ -0,0 +1,137 @@
+#include "Benchmark.h"
+
+namespace
+{
+	constexpr auto usage =
+		"usage: mmvbench [options]\n"
+		"\n"
+		"Times the plugin's per-frame work at 720p, 1080p, 1440p and 4K on the CPU and compares it against a\n"
+		"baseline. Exits with 1 if a kernel got slower than the tolerance allows or has no baseline entry.\n"
+		"\n"
+		"  --baseline <file>    baseline to compare against (default: the one checked in with the source)\n"
+		"  --record <file>      write this run to <file> as a new baseline, keeping the entries of --baseline\n"
+		"                       for kernels that weren't run; nothing is compared\n"
+		"  --tolerance <pct>    slowdown over the baseline that counts as a regression (default 15)\n"
+		"  --min-time <ms>      time spent measuring each kernel at each resolution (default 500)\n"
+		"  --filter <text>      only kernels whose name contains <text>\n"
+		"  --list               list the kernels and exit\n"sv;
+
+	template <class T>
+	bool parse_number(std::string_view a_arg, T& a_value)
+	{
+		const auto [ptr, ec] = std::from_chars(a_arg.data(), a_arg.data() + a_arg.size(), a_value);
+		return ec == std::errc() && ptr == a_arg.data() + a_arg.size() && a_value > 0;
+	}
+}
+
+int main(int a_argc, char* a_argv[])
+{
+	std::vector<std::string_view> args(a_argv + 1, a_argv + a_argc);
+
+	std::filesystem::path baselinePath(MMVBENCH_BASELINE);
+	double                tolerance = 15.0;
+	std::uint32_t         minTime = 500;
+	std::string_view      filter;
+	std::filesystem::path recordPath;
+
+	for (std::size_t i = 0; i < args.size(); ++i) {
+		const auto arg = args[i];
+		const auto next = i + 1 < args.size() ? args[i + 1] : ""sv;
+
+		bool valid = true;
+		if (arg == "--baseline"sv) {
+			valid = !next.empty();
+			baselinePath = next;
+			++i;
+		} else if (arg == "--tolerance"sv) {
+			valid = parse_number(next, tolerance);
+			++i;
+		} else if (arg == "--min-time"sv) {
+			valid = parse_number(next, minTime);
+			++i;
+		} else if (arg == "--filter"sv) {
+			valid = !next.empty();
+			filter = next;
+			++i;
+		} else if (arg == "--record"sv) {
+			valid = !next.empty();
+			recordPath = next;
+			++i;
+		} else if (arg == "--list"sv) {
+			for (const auto& kernel : Benchmark::GetKernels()) {
+				std::printf("%-20.*s %.*s\n", static_cast<int>(kernel.name.size()), kernel.name.data(), static_cast<int>(kernel.description.size()), kernel.description.data());
+			}
+			return 0;
+		} else {
+			valid = false;
+		}
+
+		if (!valid) {
+			std::fprintf(stderr, "error: invalid option %.*s %.*s\n", static_cast<int>(arg.size()), arg.data(), static_cast<int>(next.size()), next.data());
+			std::fputs(usage.data(), stderr);
+			return 2;
+		}
+	}
+
+	// the checked-in baseline is only ever read, a new one is written where --record says
+	const bool recording = !recordPath.empty();
+	const auto loaded = Benchmark::LoadBaseline(baselinePath);
+	if (!loaded && !recording) {
+		std::fprintf(stderr, "error: no baseline at %s, record one with --record <file>\n", baselinePath.string().c_str());
+		return 1;
+	}
+	auto baseline = loaded.value_or(Benchmark::Baseline{});
+
+	std::printf("%-20s %-6s %12s %12s %9s\n", "kernel", "size", "us/frame", "baseline", "change");
+
+	std::uint32_t regressions = 0;
+	std::uint32_t missing = 0;
+	for (const auto& kernel : Benchmark::GetKernels()) {
+		if (!filter.empty() && kernel.name.find(filter) == std::string_view::npos) {
+			continue;
+		}
+
+		for (const auto& resolution : Benchmark::resolutions) {
+			const auto microseconds = Benchmark::Measure(kernel.prepare(resolution.width, resolution.height), std::chrono::milliseconds(minTime));
+
+			const std::pair key{ std::string(kernel.name), std::string(resolution.name) };
+			std::printf("%-20s %-6s %12.2f", key.first.c_str(), key.second.c_str(), microseconds);
+			if (const auto it = baseline.find(key); it != baseline.end()) {
+				const auto change = (microseconds / it->second - 1.0) * 100.0;
+				const bool regressed = change > tolerance;
+				std::printf(" %12.2f %+8.1f%%%s\n", it->second, change, regressed ? "  REGRESSION" : "");
+				if (regressed && !recording) {
+					regressions++;
+				}
+			} else {
+				std::printf(" %12s %9s\n", "-", recording ? "new" : "MISSING");
+				if (!recording) {
+					missing++;
+				}
+			}
+			std::fflush(stdout);
+
+			if (recording) {
+				baseline[key] = microseconds;
+			}
+		}
+	}
+
+	if (recording) {
+		if (!Benchmark::SaveBaseline(recordPath, baseline)) {
+			std::fprintf(stderr, "error: unable to write %s\n", recordPath.string().c_str());
+			return 1;
+		}
+		std::printf("baseline written to %s\n", recordPath.string().c_str());
+		return 0;
+	}
+
+	// a kernel without an entry isn't checked at all, which must not pass as a clean run
+	if (missing > 0) {
+		std::fprintf(stderr, "error: %u kernel sizes have no entry in %s, record them with --record <file>\n", missing, baselinePath.string().c_str());
+	}
+	if (regressions > 0) {
+		std::printf("%u regressions beyond %.0f%%\n", regressions, tolerance);
+	}
+	return regressions > 0 || missing > 0 ? 1 : 0;
+}
@@ -0,0 +1,91 @@
+#include "History.h"
+
+namespace
+{
+	constexpr auto usage =
+		"usage: mmvhistory <history file> [options]\n"
+		"\n"
+		"Lists how each video has played on the machine that wrote the file (MainMenuVideo/history.tsv next to the\n"
+		"plugin log) and what the plugin does with it on the next play. The options mirror the [History] section of\n"
+		"the ini, to try other thresholds against a real history.\n"
+		"\n"
+		"  --min-plays <n>          plays before a record is trusted (default 2)\n"
+		"  --min-fps-ratio <r>      achieved / target frame rate below this is falling behind (default 0.9)\n"
+		"  --max-drop-rate <r>      share of dropped frames beyond this is falling behind (default 0.05)\n"
+		"  --skip-fps-ratio <r>     achieved / target frame rate below this is skipped (default 0.6)\n"
+		"  --max-first-pixel <ms>   skip videos slower than this to show (default 0, never)\n"
+		"  --retry-after <n>        times a video is passed over before it's given another chance (default 10, 0 - never)\n"sv;
+
+	template <class T>
+	bool parse_number(std::string_view a_arg, T& a_value)
+	{
+		const auto [ptr, ec] = std::from_chars(a_arg.data(), a_arg.data() + a_arg.size(), a_value);
+		return ec == std::errc() && ptr == a_arg.data() + a_arg.size();
+	}
+}
+
+int main(int a_argc, char* a_argv[])
+{
+	std::vector<std::string_view> args(a_argv + 1, a_argv + a_argc);
+	std::vector<std::string_view> files;
+
+	History::Policy policy;
+
+	for (std::size_t i = 0; i < args.size(); ++i) {
+		const auto arg = args[i];
+		const auto next = i + 1 < args.size() ? args[i + 1] : ""sv;
+
+		bool valid = true;
+		if (arg == "--min-plays"sv) {
+			valid = parse_number(next, policy.minPlays);
+			++i;
+		} else if (arg == "--min-fps-ratio"sv) {
+			valid = parse_number(next, policy.minFPSRatio);
+			++i;
+		} else if (arg == "--max-drop-rate"sv) {
+			valid = parse_number(next, policy.maxDropRate);
+			++i;
+		} else if (arg == "--skip-fps-ratio"sv) {
+			valid = parse_number(next, policy.skipFPSRatio);
+			++i;
+		} else if (arg == "--max-first-pixel"sv) {
+			valid = parse_number(next, policy.maxFirstPixelTime);
+			++i;
+		} else if (arg == "--retry-after"sv) {
+			valid = parse_number(next, policy.retryAfter);
+			++i;
+		} else if (arg.starts_with("--"sv)) {
+			valid = false;
+		} else {
+			files.push_back(arg);
+		}
+
+		if (!valid) {
+			std::fprintf(stderr, "error: invalid option %.*s %.*s\n", static_cast<int>(arg.size()), arg.data(), static_cast<int>(next.size()), next.data());
+			std::fputs(usage.data(), stderr);
+			return 2;
+		}
+	}
+
+	if (files.size() != 1) {
+		std::fputs(usage.data(), stderr);
+		return 2;
+	}
+
+	const std::filesystem::path path(files[0]);
+	History::Store              store;
+	if (!store.Load(path)) {
+		std::fprintf(stderr, "error: %s isn't a play history, or it's from another version\n", path.string().c_str());
+		return 1;
+	}
+
+	const auto records = store.GetRecords();
+	std::printf("%zu videos\n", records.size());
+	std::printf("%-10s %5s %5s %8s %8s %9s %6s %10s  %s\n", "verdict", "plays", "skips", "target", "achieved", "decode95", "drops", "1st pixel", "video");
+	for (const auto& [video, record] : records) {
+		const auto verdict = History::GetName(History::Assess(record, policy));
+		std::printf("%-10.*s %5u %5u %8.2f %8.2f %7.2fms %5.1f%% %8.0fms  %s\n", static_cast<int>(verdict.size()), verdict.data(),
+			record.plays, record.skips, record.targetFPS, record.achievedFPS, record.decodeTime, record.dropRate * 100.0f, record.firstPixelTime, video.c_str());
+	}
+	return 0;
+}
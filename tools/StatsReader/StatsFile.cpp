@@ -0,0 +1,83 @@
+#include "StatsFile.h"
+
+StatsFile::~StatsFile()
+{
+	Close();
+}
+
+bool StatsFile::Open(const std::filesystem::path& a_path)
+{
+	Close();
+
+	// the game keeps writing to the file, so it has to be shared for writing too
+#ifdef _WIN32
+	file = CreateFileW(a_path.c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+	if (file == INVALID_HANDLE_VALUE) {
+		return false;
+	}
+
+	LARGE_INTEGER size{};
+	if (!GetFileSizeEx(file, &size) || size.QuadPart < static_cast<LONGLONG>(sizeof(Telemetry::Block))) {
+		Close();
+		return false;
+	}
+
+	mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, sizeof(Telemetry::Block), nullptr);
+	if (mapping) {
+		block = static_cast<const Telemetry::Block*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, sizeof(Telemetry::Block)));
+	}
+#else
+	file = ::open(a_path.c_str(), O_RDONLY);
+	if (file == -1) {
+		return false;
+	}
+
+	struct stat info{};
+	if (::fstat(file, &info) != 0 || info.st_size < static_cast<off_t>(sizeof(Telemetry::Block))) {
+		Close();
+		return false;
+	}
+
+	if (const auto view = ::mmap(nullptr, sizeof(Telemetry::Block), PROT_READ, MAP_SHARED, file, 0); view != MAP_FAILED) {
+		block = static_cast<const Telemetry::Block*>(view);
+	}
+#endif
+
+	if (!block) {
+		Close();
+		return false;
+	}
+	return true;
+}
+
+void StatsFile::Close()
+{
+#ifdef _WIN32
+	if (block) {
+		UnmapViewOfFile(block);
+		block = nullptr;
+	}
+	if (mapping) {
+		CloseHandle(mapping);
+		mapping = nullptr;
+	}
+	if (file != INVALID_HANDLE_VALUE) {
+		CloseHandle(file);
+		file = INVALID_HANDLE_VALUE;
+	}
+#else
+	if (block) {
+		::munmap(const_cast<Telemetry::Block*>(block), sizeof(Telemetry::Block));
+		block = nullptr;
+	}
+	if (file != -1) {
+		::close(file);
+		file = -1;
+	}
+#endif
+}
+
+bool StatsFile::Read(Telemetry::Stats& a_stats) const
+{
+	return block && Telemetry::Load(*block, a_stats);
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include "TelemetryBlock.h"
+
+// Read-only view of the stats file the plugin writes. Works while the game is running, after it has closed, and on
+// Linux against the file inside a Proton/Wine prefix.
+class StatsFile
+{
+public:
+	StatsFile() = default;
+	StatsFile(const StatsFile&) = delete;
+	~StatsFile();
+
+	StatsFile& operator=(const StatsFile&) = delete;
+
+	bool Open(const std::filesystem::path& a_path);
+	void Close();
+
+	// false until the game has published once, or if the file is from a different version of the plugin
+	bool Read(Telemetry::Stats& a_stats) const;
+
+private:
+	// members
+#ifdef _WIN32
+	HANDLE file{ INVALID_HANDLE_VALUE };
+	HANDLE mapping{ nullptr };
+#else
+	int file{ -1 };
+#endif
+	const Telemetry::Block* block{ nullptr };
+};
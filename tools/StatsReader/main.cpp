@@ -0,0 +1,168 @@
+#include "StatsFile.h"
+
+namespace
+{
+	constexpr auto usage =
+		"usage: mmvstats <stats file> [options]\n"
+		"\n"
+		"Samples the live playback stats the plugin publishes with [Debug] bTelemetry. The file is\n"
+		"po3_MainMenuVideo.stats, next to the plugin's log. Reading it never slows the game down.\n"
+		"\n"
+		"  --interval <ms>      time between samples (default 1000)\n"
+		"  --count <samples>    stop after this many samples (default: until interrupted)\n"
+		"  --csv                one comma separated row per sample, after a header, for scripts\n"sv;
+
+	// a playing game publishes every frame, so a block this old belongs to one that closed or hung
+	constexpr std::uint64_t staleMs{ 2000 };
+
+	template <class T>
+	bool parse_number(std::string_view a_arg, T& a_value)
+	{
+		const auto [ptr, ec] = std::from_chars(a_arg.data(), a_arg.data() + a_arg.size(), a_value);
+		return ec == std::errc() && ptr == a_arg.data() + a_arg.size() && a_value > 0;
+	}
+
+	std::uint64_t get_time_ms()
+	{
+		return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::system_clock::now().time_since_epoch()).count());
+	}
+
+	const char* get_state_name(const Telemetry::Stats& a_stats, std::uint64_t a_now)
+	{
+		switch (a_stats.state) {
+		case Telemetry::State::kIdle:
+			return "idle";
+		case Telemetry::State::kSuspended:
+			return "suspended";
+		case Telemetry::State::kPlaying:
+			return a_now > a_stats.updateTime + staleMs ? "stale" : "playing";
+		default:
+			return "unknown";
+		}
+	}
+
+	double to_mb(std::int64_t a_bytes)
+	{
+		return static_cast<double>(a_bytes) / (1024.0 * 1024.0);
+	}
+
+	std::string_view get_video(const Telemetry::Stats& a_stats)
+	{
+		return { a_stats.video, ::strnlen(a_stats.video, sizeof(a_stats.video)) };
+	}
+
+	void print_csv_header()
+	{
+		std::puts("time,state,video,width,height,elapsed,target_fps,actual_fps,decode_ms,upload_ms,decode_busy,convert_busy,drift_ms,"
+				  "queued,quality,frames,dropped,repeated,cpu_s,cpu_percent,memory_mb,peak_memory_mb,budget_mb");
+	}
+
+	void print_csv(const Telemetry::Stats& a_stats, const char* a_state, double a_cpuPercent)
+	{
+		const auto video = get_video(a_stats);
+		std::printf("%llu,%s,\"%.*s\",%u,%u,%.3f,%.2f,%.2f,%.3f,%.3f,%.3f,%.3f,%.2f,%u,%u,%llu,%llu,%llu,%.3f,%.1f,%.1f,%.1f,%.1f\n",
+			static_cast<unsigned long long>(a_stats.updateTime), a_state, static_cast<int>(video.size()), video.data(), a_stats.width, a_stats.height,
+			a_stats.elapsed, a_stats.targetFPS, a_stats.actualFPS, a_stats.decodeTime, a_stats.uploadTime, a_stats.decodeOccupancy, a_stats.convertOccupancy,
+			a_stats.drift, a_stats.queuedFrames, a_stats.qualityLevel, static_cast<unsigned long long>(a_stats.frames), static_cast<unsigned long long>(a_stats.droppedFrames),
+			static_cast<unsigned long long>(a_stats.repeatedFrames), a_stats.cpuTime, a_cpuPercent, to_mb(a_stats.memoryBytes), to_mb(a_stats.peakMemoryBytes), to_mb(a_stats.memoryBudget));
+	}
+
+	void print_line(const Telemetry::Stats& a_stats, const char* a_state, double a_cpuPercent)
+	{
+		if (a_stats.state == Telemetry::State::kIdle) {
+			std::printf("%-9s memory %.0f MB (peak %.0f)\n", a_state, to_mb(a_stats.memoryBytes), to_mb(a_stats.peakMemoryBytes));
+			return;
+		}
+
+		const auto video = get_video(a_stats);
+		std::printf("%-9s %.*s %ux%u %7.1fs  %5.1f/%4.1f FPS  decode %5.2f ms  upload %5.2f ms  drift %+7.1f ms  queued %2u  quality %u  "
+					"dropped %llu  repeated %llu  cpu %5.1f%%  memory %.0f/%.0f MB\n",
+			a_state, static_cast<int>(video.size()), video.data(), a_stats.width, a_stats.height, a_stats.elapsed, a_stats.actualFPS, a_stats.targetFPS,
+			a_stats.decodeTime, a_stats.uploadTime, a_stats.drift, a_stats.queuedFrames, a_stats.qualityLevel, static_cast<unsigned long long>(a_stats.droppedFrames),
+			static_cast<unsigned long long>(a_stats.repeatedFrames), a_cpuPercent, to_mb(a_stats.memoryBytes), to_mb(a_stats.memoryBudget));
+	}
+}
+
+int main(int a_argc, char* a_argv[])
+{
+	std::vector<std::string_view> args(a_argv + 1, a_argv + a_argc);
+	std::vector<std::string_view> files;
+
+	std::uint32_t interval = 1000;
+	std::uint32_t count = 0;
+	bool          csv = false;
+
+	for (std::size_t i = 0; i < args.size(); ++i) {
+		const auto arg = args[i];
+		const auto next = i + 1 < args.size() ? args[i + 1] : ""sv;
+
+		bool valid = true;
+		if (arg == "--interval"sv) {
+			valid = parse_number(next, interval);
+			++i;
+		} else if (arg == "--count"sv) {
+			valid = parse_number(next, count);
+			++i;
+		} else if (arg == "--csv"sv) {
+			csv = true;
+		} else if (arg.starts_with("--"sv)) {
+			valid = false;
+		} else {
+			files.push_back(arg);
+		}
+
+		if (!valid) {
+			std::fprintf(stderr, "error: invalid option %.*s %.*s\n", static_cast<int>(arg.size()), arg.data(), static_cast<int>(next.size()), next.data());
+			std::fputs(usage.data(), stderr);
+			return 2;
+		}
+	}
+
+	if (files.size() != 1) {
+		std::fputs(usage.data(), stderr);
+		return 2;
+	}
+
+	StatsFile file;
+	if (!file.Open(std::filesystem::path(files[0]))) {
+		std::fprintf(stderr, "error: unable to open %.*s, is bTelemetry enabled and has the game started once?\n", static_cast<int>(files[0].size()), files[0].data());
+		return 1;
+	}
+
+	if (csv) {
+		print_csv_header();
+	}
+
+	Telemetry::Stats previous{};
+	std::uint32_t    samples = 0;
+	for (std::uint32_t i = 0; count == 0 || i < count; ++i) {
+		if (i > 0) {
+			std::this_thread::sleep_for(std::chrono::milliseconds(interval));
+		}
+
+		Telemetry::Stats stats;
+		if (!file.Read(stats)) {
+			std::fputs("warning: nothing published yet, or by a different version of the plugin\n", stderr);
+			continue;
+		}
+
+		// CPU use between two samples of the same video thread
+		double cpuPercent = 0.0;
+		if (samples > 0 && stats.updateTime > previous.updateTime && stats.cpuTime >= previous.cpuTime) {
+			cpuPercent = (stats.cpuTime - previous.cpuTime) * 100000.0 / static_cast<double>(stats.updateTime - previous.updateTime);
+		}
+
+		const auto state = get_state_name(stats, get_time_ms());
+		if (csv) {
+			print_csv(stats, state, cpuPercent);
+		} else {
+			print_line(stats, state, cpuPercent);
+		}
+		std::fflush(stdout);
+
+		previous = stats;
+		samples++;
+	}
+
+	return samples > 0 ? 0 : 1;
+}
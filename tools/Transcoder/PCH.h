@@ -0,0 +1,75 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cctype>
+#include <charconv>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <format>
+#include <fstream>
+#include <functional>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <optional>
+#include <span>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include <opencv2/core.hpp>
+#include <opencv2/imgproc.hpp>
+#include <opencv2/videoio.hpp>
+
+using namespace std::literals;
+
+// shared plugin sources log through SKSE, here it's the console
+namespace logger
+{
+	namespace detail
+	{
+		inline std::mutex lock;  // jobs log from several threads, keep their lines whole
+
+		inline void write(std::FILE* a_stream, std::string_view a_prefix, const std::string& a_message)
+		{
+			std::scoped_lock locker(lock);
+			std::fprintf(a_stream, "%.*s%s\n", static_cast<int>(a_prefix.size()), a_prefix.data(), a_message.c_str());
+		}
+	}
+
+	template <class... Args>
+	void info(std::format_string<Args...> a_fmt, Args&&... a_args)
+	{
+		detail::write(stdout, ""sv, std::format(a_fmt, std::forward<Args>(a_args)...));
+	}
+
+	template <class... Args>
+	void warn(std::format_string<Args...> a_fmt, Args&&... a_args)
+	{
+		detail::write(stderr, "warning: "sv, std::format(a_fmt, std::forward<Args>(a_args)...));
+	}
+
+	template <class... Args>
+	void error(std::format_string<Args...> a_fmt, Args&&... a_args)
+	{
+		detail::write(stderr, "error: "sv, std::format(a_fmt, std::forward<Args>(a_args)...));
+	}
+}
+
+// VideoList is shared with the plugin, which gets this from ClibUtil
+namespace clib_util::string
+{
+	inline std::string tolower(std::string a_string)
+	{
+		std::ranges::transform(a_string, a_string.begin(), [](char a_char) { return static_cast<char>(std::tolower(static_cast<unsigned char>(a_char))); });
+		return a_string;
+	}
+}
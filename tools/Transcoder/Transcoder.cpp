@@ -0,0 +1,279 @@
+#include "Transcoder.h"
+
+#include "QOI.h"
+#include "VideoList.h"
+
+namespace Transcoder
+{
+	namespace detail
+	{
+		// codecs whose software decode alone can eat a frame budget at menu resolutions
+		constexpr std::array expensiveCodecs{ "hevc"sv, "hvc1"sv, "hev1"sv, "h265"sv, "av01"sv, "vp09"sv, "vp90"sv };
+
+		// frames closer together than this count as the same instant
+		constexpr double timestampEpsilon{ 0.001 };
+
+		std::string get_codec(const cv::VideoCapture& a_cap)
+		{
+			const auto  fourcc = static_cast<std::uint32_t>(a_cap.get(cv::CAP_PROP_FOURCC));
+			std::string codec;
+			for (std::uint32_t i = 0; i < 4; ++i) {
+				const auto c = static_cast<char>((fourcc >> (i * 8)) & 0xFF);
+				if (std::isprint(static_cast<unsigned char>(c))) {
+					codec.push_back(static_cast<char>(std::tolower(static_cast<unsigned char>(c))));
+				}
+			}
+			return codec.empty() ? "unknown"s : codec;
+		}
+
+		// H.264 and the 4:2:0 chroma every common codec uses need even dimensions
+		std::uint32_t make_even(double a_value)
+		{
+			return std::max(static_cast<std::uint32_t>(std::lround(a_value / 2.0)) * 2, 2u);
+		}
+
+		bool write_manifest(const std::filesystem::path& a_folder, float a_fps)
+		{
+			std::ofstream file(a_folder / "sequence.ini");
+			file << std::format("[Sequence]\nfFPS = {:.6f}\n", a_fps);
+			return static_cast<bool>(file);
+		}
+
+		// asks ffprobe for the audio streams, one index per line; kUnknown if it isn't installed or the path can't be quoted
+		Audio run_ffprobe(const std::filesystem::path& a_path)
+		{
+			const auto path = a_path.string();
+#ifdef _WIN32
+			if (path.find_first_of("\"%"sv) != std::string::npos) {
+				return Audio::kUnknown;
+			}
+			const auto command = std::format("ffprobe -v error -select_streams a -show_entries stream=index -of csv=p=0 \"{}\" 2>NUL", path);
+			const auto pipe = _popen(command.c_str(), "r");
+#else
+			std::string quoted;
+			for (const auto c : path) {
+				quoted += c == '\'' ? "'\\''"s : std::string(1, c);
+			}
+			const auto command = std::format("ffprobe -v error -select_streams a -show_entries stream=index -of csv=p=0 '{}' 2>/dev/null", quoted);
+			const auto pipe = popen(command.c_str(), "r");
+#endif
+			if (!pipe) {
+				return Audio::kUnknown;
+			}
+
+			std::string           output;
+			std::array<char, 256> buffer{};
+			while (std::fgets(buffer.data(), static_cast<int>(buffer.size()), pipe)) {
+				output += buffer.data();
+			}
+#ifdef _WIN32
+			const auto status = _pclose(pipe);
+#else
+			const auto status = pclose(pipe);
+#endif
+			if (status != 0) {
+				return Audio::kUnknown;
+			}
+			return std::ranges::any_of(output, [](char a_char) { return std::isdigit(static_cast<unsigned char>(a_char)) != 0; }) ? Audio::kPresent : Audio::kNone;
+		}
+
+		// only backends that can decode audio (MSMF) open the audio stream, FFmpeg's can't, so a failed open proves nothing
+		Audio probe_audio(const std::filesystem::path& a_path)
+		{
+			cv::VideoCapture audioProbe;
+			if (audioProbe.open(a_path.string(), cv::CAP_ANY, { cv::CAP_PROP_AUDIO_STREAM, 0, cv::CAP_PROP_VIDEO_STREAM, -1 })) {
+				return Audio::kPresent;
+			}
+			return run_ffprobe(a_path);
+		}
+
+		bool open_writer(cv::VideoWriter& a_writer, const std::filesystem::path& a_path, float a_fps, cv::Size a_size)
+		{
+			// only the FFmpeg backend honours the keyframe interval, other backends are a last resort
+			for (const auto api : { cv::CAP_FFMPEG, cv::CAP_ANY }) {
+				for (const auto fourcc : { cv::VideoWriter::fourcc('a', 'v', 'c', '1'), cv::VideoWriter::fourcc('m', 'p', '4', 'v') }) {
+					if (a_writer.open(a_path.string(), api, fourcc, a_fps, a_size)) {
+						return true;
+					}
+				}
+			}
+			return false;
+		}
+	}
+
+	void ConfigureEncoder(const Settings& a_settings)
+	{
+		const auto options = std::format("g;{0}|keyint_min;{0}", a_settings.keyframeInterval);
+#ifdef _WIN32
+		_putenv_s("OPENCV_FFMPEG_WRITER_OPTIONS", options.c_str());
+#else
+		setenv("OPENCV_FFMPEG_WRITER_OPTIONS", options.c_str(), 1);
+#endif
+	}
+
+	std::optional<Analysis> Analyse(const std::filesystem::path& a_path, const Settings& a_settings)
+	{
+		cv::VideoCapture cap;
+		if (!cap.open(a_path.string(), cv::CAP_ANY)) {
+			return std::nullopt;
+		}
+
+		Analysis analysis{
+			.width = static_cast<std::uint32_t>(cap.get(cv::CAP_PROP_FRAME_WIDTH)),
+			.height = static_cast<std::uint32_t>(cap.get(cv::CAP_PROP_FRAME_HEIGHT)),
+			.fps = static_cast<float>(cap.get(cv::CAP_PROP_FPS)),
+			.frameCount = static_cast<std::uint32_t>(cap.get(cv::CAP_PROP_FRAME_COUNT)),
+			.codec = detail::get_codec(cap)
+		};
+		if (analysis.width == 0 || analysis.height == 0) {
+			return std::nullopt;
+		}
+		if (analysis.fps <= 0.0f) {
+			analysis.fps = a_settings.maxFPS;
+		}
+
+		analysis.audio = detail::probe_audio(a_path);
+
+		const double scale = std::min(1.0, static_cast<double>(a_settings.maxHeight) / analysis.height);
+		analysis.outputWidth = detail::make_even(analysis.width * scale);
+		analysis.outputHeight = detail::make_even(analysis.height * scale);
+		analysis.outputFPS = std::min(analysis.fps, a_settings.maxFPS);
+
+		if (analysis.height > a_settings.maxHeight) {
+			analysis.reasons.push_back(std::format("{}p is taller than {}p", analysis.height, a_settings.maxHeight));
+		}
+		if (analysis.fps > a_settings.maxFPS + 0.01f) {
+			analysis.reasons.push_back(std::format("{:.2f} FPS is above {:.2f}", analysis.fps, a_settings.maxFPS));
+		}
+		if (std::ranges::find(detail::expensiveCodecs, analysis.codec) != detail::expensiveCodecs.end()) {
+			analysis.reasons.push_back(std::format("{} is expensive to decode", analysis.codec));
+		}
+		if (a_settings.format == Format::kSequence) {
+			analysis.reasons.push_back("converting to an image sequence"s);
+		}
+		// the keyframe interval can't be read back portably, --force rewrites files that only need a shorter one
+		if (a_settings.force && analysis.reasons.empty()) {
+			analysis.reasons.push_back("forced"s);
+		}
+
+		return analysis;
+	}
+
+	std::filesystem::path GetOutputPath(const std::filesystem::path& a_path, const std::filesystem::path& a_outputDir, const Analysis& a_analysis, const Settings& a_settings)
+	{
+		const auto name = VideoList::SplitHeight(a_path).first;
+		if (a_settings.format == Format::kSequence) {
+			return a_outputDir / name;
+		}
+		return a_outputDir / std::format("{}.{}p.mp4", name, a_analysis.outputHeight);
+	}
+
+	bool Transcode(const std::filesystem::path& a_path, const std::filesystem::path& a_outputPath, const Analysis& a_analysis, const Settings& a_settings)
+	{
+		cv::VideoCapture cap;
+		if (!cap.open(a_path.string(), cv::CAP_ANY)) {
+			logger::error("{}: couldn't open", a_path.filename().string());
+			return false;
+		}
+
+		const cv::Size outputSize(static_cast<int>(a_analysis.outputWidth), static_cast<int>(a_analysis.outputHeight));
+		const bool     sequence = a_settings.format == Format::kSequence;
+
+		// written under a temporary name, so an interrupted run never leaves something the plugin would pick up
+		auto tempPath = a_outputPath;
+		if (sequence) {
+			tempPath += ".tmp"sv;
+		} else {
+			tempPath.replace_extension(".tmp.mp4"sv);
+		}
+
+		std::error_code ec;
+		std::filesystem::remove_all(tempPath, ec);
+
+		cv::VideoWriter writer;
+		if (sequence) {
+			std::filesystem::create_directories(tempPath, ec);
+			if (ec || !detail::write_manifest(tempPath, a_analysis.outputFPS)) {
+				logger::error("{}: couldn't create {}", a_path.filename().string(), tempPath.string());
+				return false;
+			}
+		} else if (!detail::open_writer(writer, tempPath, a_analysis.outputFPS, outputSize)) {
+			logger::error("{}: no encoder available for {}", a_path.filename().string(), tempPath.string());
+			return false;
+		}
+
+		const auto    startTime = std::chrono::steady_clock::now();
+		const double  outputStep = 1.0 / a_analysis.outputFPS;
+		double        nextDue = 0.0;
+		std::uint32_t sourceIndex = 0;
+		std::uint32_t writtenFrames = 0;
+		bool          failed = false;
+
+		cv::Mat frame;
+		cv::Mat resized;
+		cv::Mat pending;  // the latest frame, written once the source moves past its output slot
+		cv::Mat bgra;
+
+		auto write = [&](const cv::Mat& a_frame) {
+			if (sequence) {
+				cv::cvtColor(a_frame, bgra, cv::COLOR_BGR2BGRA);
+				const auto    data = QOI::Encode(bgra.data, a_analysis.outputWidth, a_analysis.outputHeight, bgra.step);
+				std::ofstream file(tempPath / std::format("frame_{:06}.qoi", writtenFrames), std::ios::binary | std::ios::trunc);
+				file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()));
+				if (data.empty() || !file) {
+					failed = true;
+				}
+			} else {
+				writer.write(a_frame);
+			}
+			writtenFrames++;
+		};
+
+		while (!failed && cap.read(frame) && !frame.empty()) {
+			// resampled to a constant rate: dense sources drop frames, gaps in variable rate ones repeat the last frame
+			double timestamp = cap.get(cv::CAP_PROP_POS_MSEC) / 1000.0;
+			if (timestamp <= 0.0 && sourceIndex > 0) {
+				timestamp = sourceIndex / a_analysis.fps;
+			}
+			sourceIndex++;
+
+			while (!pending.empty() && nextDue < timestamp - detail::timestampEpsilon) {
+				write(pending);
+				nextDue += outputStep;
+			}
+
+			if (frame.size() != outputSize) {
+				cv::resize(frame, resized, outputSize, 0.0, 0.0, cv::INTER_AREA);
+			} else {
+				frame.copyTo(resized);
+			}
+			if (resized.channels() == 4) {
+				cv::cvtColor(resized, pending, cv::COLOR_BGRA2BGR);
+			} else {
+				cv::swap(resized, pending);
+			}
+		}
+		if (!failed && !pending.empty()) {
+			write(pending);
+		}
+		writer.release();
+
+		if (failed || writtenFrames == 0) {
+			logger::error("{}: {}", a_path.filename().string(), failed ? "couldn't write a frame" : "no frames could be decoded");
+			std::filesystem::remove_all(tempPath, ec);
+			return false;
+		}
+
+		std::filesystem::remove_all(a_outputPath, ec);
+		std::filesystem::rename(tempPath, a_outputPath, ec);
+		if (ec) {
+			logger::error("{}: couldn't move the output to {} ({})", a_path.filename().string(), a_outputPath.string(), ec.message());
+			std::filesystem::remove_all(tempPath, ec);
+			return false;
+		}
+
+		const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+		logger::info("{}: wrote {} frames to {} in {:.1f}s ({:.0f} FPS)", a_path.filename().string(), writtenFrames, a_outputPath.filename().string(), elapsed, writtenFrames / std::max(elapsed, 1e-6));
+		return true;
+	}
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+// Rewrites a video into the profile the plugin plays cheapest: no taller than the screen, no more frames per second
+// than the menu needs, and a short keyframe interval so loops and random starts seek fast.
+namespace Transcoder
+{
+	enum class Format
+	{
+		kVideo,    // .mp4, H.264 where the OpenCV build has an encoder for it, MPEG-4 part 2 otherwise
+		kSequence  // QOI frames with a sequence.ini, which the plugin decodes on all cores
+	};
+
+	enum class Audio
+	{
+		kNone,
+		kPresent,
+		kUnknown  // neither OpenCV's backend nor ffprobe could tell, treated as present
+	};
+
+	struct Settings
+	{
+		std::uint32_t maxHeight{ 1080 };
+		float         maxFPS{ 30.0f };
+		std::uint32_t keyframeInterval{ 30 };  // in frames
+		Format        format{ Format::kVideo };
+		bool          force{ false };
+		bool          dropAudio{ false };
+		bool          dryRun{ false };
+	};
+
+	struct Analysis
+	{
+		std::uint32_t            width{ 0 };
+		std::uint32_t            height{ 0 };
+		float                    fps{ 0.0f };
+		std::uint32_t            frameCount{ 0 };
+		std::string              codec;
+		Audio                    audio{ Audio::kUnknown };
+		std::uint32_t            outputWidth{ 0 };
+		std::uint32_t            outputHeight{ 0 };
+		float                    outputFPS{ 0.0f };
+		std::vector<std::string> reasons;  // why it should be rewritten, empty if it already fits the profile
+	};
+
+	// OpenCV's FFmpeg writer takes its codec options from the environment, so this has to run before any job starts
+	void ConfigureEncoder(const Settings& a_settings);
+
+	std::optional<Analysis> Analyse(const std::filesystem::path& a_path, const Settings& a_settings);
+
+	// <name>.<height>p.mp4 after the height actually written, whatever variant label the source had; a sequence folder
+	// is just <name>, the plugin doesn't pick between sequence variants
+	std::filesystem::path GetOutputPath(const std::filesystem::path& a_path, const std::filesystem::path& a_outputDir, const Analysis& a_analysis, const Settings& a_settings);
+	bool                  Transcode(const std::filesystem::path& a_path, const std::filesystem::path& a_outputPath, const Analysis& a_analysis, const Settings& a_settings);
+}
@@ -0,0 +1,190 @@
+#include "Transcoder.h"
+
+namespace
+{
+	constexpr auto usage =
+		"usage: mmvtranscode <input folder> <output folder> [options]\n"
+		"\n"
+		"Rewrites the videos in <input folder> (usually Data\\MainMenuVideo) into <output folder> in the profile\n"
+		"the plugin plays cheapest. Files that already fit it are left alone.\n"
+		"\n"
+		"  --height <pixels>    tallest output, larger videos are scaled down (default 1080)\n"
+		"  --fps <rate>         highest output frame rate, faster videos drop frames (default 30)\n"
+		"  --gop <frames>       keyframe interval, shorter loops and seeks faster (default 30)\n"
+		"  --sequence           write QOI image sequences instead of .mp4 files\n"
+		"  --jobs <count>       files processed in parallel (default: all cores)\n"
+		"  --force              rewrite every file, e.g. to shorten its keyframe interval\n"
+		"  --drop-audio         rewrite files with an audio track, or that may have one, too (the output has no audio)\n"
+		"  --dry-run            only report what would be rewritten\n"sv;
+
+	template <class T>
+	bool parse_number(std::string_view a_arg, T& a_value)
+	{
+		const auto [ptr, ec] = std::from_chars(a_arg.data(), a_arg.data() + a_arg.size(), a_value);
+		return ec == std::errc() && ptr == a_arg.data() + a_arg.size() && a_value > 0;
+	}
+}
+
+int main(int a_argc, char* a_argv[])
+{
+	std::vector<std::string_view> args(a_argv + 1, a_argv + a_argc);
+	std::vector<std::string_view> folders;
+
+	Transcoder::Settings settings;
+	std::uint32_t        jobs = std::max(std::thread::hardware_concurrency(), 1u);
+
+	for (std::size_t i = 0; i < args.size(); ++i) {
+		const auto arg = args[i];
+		const auto next = i + 1 < args.size() ? args[i + 1] : ""sv;
+
+		bool valid = true;
+		if (arg == "--height"sv) {
+			valid = parse_number(next, settings.maxHeight);
+			++i;
+		} else if (arg == "--fps"sv) {
+			valid = parse_number(next, settings.maxFPS);
+			++i;
+		} else if (arg == "--gop"sv) {
+			valid = parse_number(next, settings.keyframeInterval);
+			++i;
+		} else if (arg == "--jobs"sv) {
+			valid = parse_number(next, jobs);
+			++i;
+		} else if (arg == "--sequence"sv) {
+			settings.format = Transcoder::Format::kSequence;
+		} else if (arg == "--force"sv) {
+			settings.force = true;
+		} else if (arg == "--drop-audio"sv) {
+			settings.dropAudio = true;
+		} else if (arg == "--dry-run"sv) {
+			settings.dryRun = true;
+		} else if (arg.starts_with("--"sv)) {
+			valid = false;
+		} else {
+			folders.push_back(arg);
+		}
+
+		if (!valid) {
+			logger::error("invalid option {} {}", arg, next);
+			std::fputs(usage.data(), stderr);
+			return 2;
+		}
+	}
+
+	if (folders.size() != 2) {
+		std::fputs(usage.data(), stderr);
+		return 2;
+	}
+
+	const std::filesystem::path inputDir(folders[0]);
+	const std::filesystem::path outputDir(folders[1]);
+
+	std::error_code ec;
+	if (!std::filesystem::is_directory(inputDir, ec)) {
+		logger::error("{} isn't a folder", inputDir.string());
+		return 1;
+	}
+	std::filesystem::create_directories(outputDir, ec);
+	if (std::filesystem::equivalent(inputDir, outputDir, ec)) {
+		logger::error("the output folder has to differ from the input folder, sources are never overwritten");
+		return 1;
+	}
+
+	std::vector<std::filesystem::path> files;
+	for (const auto& entry : std::filesystem::directory_iterator(inputDir, ec)) {
+		if (entry.is_regular_file(ec)) {
+			files.push_back(entry.path());
+		}
+	}
+	std::ranges::sort(files);
+
+	Transcoder::ConfigureEncoder(settings);
+
+	std::atomic<std::uint32_t> rewritten{ 0 };
+	std::atomic<std::uint32_t> skipped{ 0 };
+	std::atomic<std::uint32_t> failed{ 0 };
+
+	// decoding and encoding are mostly single threaded per file, so files are the unit of parallelism
+	auto run_parallel = [&](std::size_t a_count, const std::function<void(std::size_t)>& a_job) {
+		std::atomic<std::size_t>  next{ 0 };
+		std::vector<std::jthread> workers;
+		for (std::uint32_t i = 0; i < std::min<std::size_t>(jobs, a_count); ++i) {
+			workers.emplace_back([&]() {
+				for (auto index = next++; index < a_count; index = next++) {
+					a_job(index);
+				}
+			});
+		}
+	};
+
+	const auto startTime = std::chrono::steady_clock::now();
+
+	// every file is analysed before any is written, so two that would end up with the same output are caught up front
+	std::vector<std::optional<Transcoder::Analysis>> analyses(files.size());
+	run_parallel(files.size(), [&](std::size_t a_index) { analyses[a_index] = Transcoder::Analyse(files[a_index], settings); });
+
+	std::vector<std::pair<std::size_t, std::filesystem::path>> queue;    // file index, output path
+	std::map<std::string, std::filesystem::path>               outputs;  // lowercase output name, the file writing it
+
+	for (std::size_t i = 0; i < files.size(); ++i) {
+		const auto& file = files[i];
+		const auto& analysis = analyses[i];
+		const auto  name = file.filename().string();
+
+		if (!analysis) {
+			logger::info("{}: not a video, skipping", name);
+			skipped++;
+			continue;
+		}
+
+		logger::info("{}: {}x{} {} {:.2f} FPS, {} frames{}", name, analysis->width, analysis->height, analysis->codec, analysis->fps, analysis->frameCount,
+			analysis->audio == Transcoder::Audio::kPresent ? ", with audio" : analysis->audio == Transcoder::Audio::kUnknown ? ", audio unknown" : "");
+		if (analysis->reasons.empty()) {
+			logger::info("{}: already fits the profile", name);
+			skipped++;
+			continue;
+		}
+
+		std::string reasons;
+		for (const auto& reason : analysis->reasons) {
+			reasons += reasons.empty() ? reason : ", " + reason;
+		}
+		logger::info("{}: -> {}x{} {:.2f} FPS ({})", name, analysis->outputWidth, analysis->outputHeight, analysis->outputFPS, reasons);
+
+		if (analysis->audio != Transcoder::Audio::kNone && !settings.dropAudio) {
+			if (analysis->audio == Transcoder::Audio::kPresent) {
+				logger::warn("{}: has an audio track the encoder can't carry over, skipping (--drop-audio rewrites it anyway)", name);
+			} else {
+				logger::warn("{}: couldn't tell whether it has an audio track (is ffprobe installed?), skipping (--drop-audio rewrites it anyway)", name);
+			}
+			skipped++;
+			continue;
+		}
+
+		// "intro.mp4" and "intro.2160p.mkv" both become intro.1080p.mp4, neither may replace the other
+		auto outputPath = Transcoder::GetOutputPath(file, outputDir, *analysis, settings);
+		if (const auto [it, inserted] = outputs.emplace(clib_util::string::tolower(outputPath.filename().string()), file); !inserted) {
+			logger::error("{}: would be written to {}, like {}; rename one of them", name, outputPath.filename().string(), it->second.filename().string());
+			failed++;
+			continue;
+		}
+
+		if (!settings.dryRun) {
+			queue.emplace_back(i, std::move(outputPath));
+		}
+	}
+
+	run_parallel(queue.size(), [&](std::size_t a_index) {
+		const auto& [file, outputPath] = queue[a_index];
+		if (Transcoder::Transcode(files[file], outputPath, *analyses[file], settings)) {
+			rewritten++;
+		} else {
+			failed++;
+		}
+	});
+
+	const auto elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+	logger::info("{} rewritten, {} skipped, {} failed in {:.1f}s", rewritten.load(), skipped.load(), failed.load(), elapsed);
+
+	return failed > 0 ? 1 : 0;
+}